@@ -0,0 +1,715 @@
+// Microbenchmarks for the dashboard's hot paths.
+//
+//   sv-bench [--json FILE] [--filter SUBSTR] [--min-time SECONDS] [--check-allocs]
+//            [--check-config]
+//
+// Pure C++/json-glib/Pango cases always run. Widget cases (Desktop
+// construction, IconCanvas::on_draw) need a display and are reported as
+// skipped when gtk_init_check() fails, so the suite stays usable on a plain
+// headless Linux box. Compare runs with scripts/bench-compare.py.
+//
+// window_startup/N builds the whole MainWindow for N tiles spread over
+// ceil(N/15) pages and records the RSS growth per window; with lazy pages
+// both should stay flat from 15 to 500 tiles.
+//
+// status_feed/poll_idle is the per-tick cost with nothing published since
+// the last poll; status_feed/publish+poll is one external update end to end.
+//
+// alloc/* count heap allocations per steady-state frame inside the draw and
+// swipe paths; they need a -Dalloc_stats=true build and are skipped
+// otherwise. --check-allocs exits 1 if any of them allocated, and 77 (skip)
+// if none ran, e.g. without a display (meson test alloc-steady-state).
+//
+// --check-config runs no benchmarks. It checks that the streaming and DOM
+// icons.json readers agree on the generated configs, that a snapshot
+// store/load round-trip gives an equal IconConfig, and that truncated
+// input, embedded NULs and oversized snapshot counts are rejected (meson
+// test config-parse).
+
+#include "AllocStats.h"
+#include "ConfigCache.h"
+#include "Desktop.h"
+#include "DesktopIcon.h"
+#include "FontRegistry.h"
+#include "GlyphAtlas.h"
+#include "Icons.h"
+#include "MainWindow.h"
+#include "PagerView.h"
+#include "StatusFeed.h"
+#include "Theme.h"
+#include "TileCache.h"
+#include "TileGrid.h"
+#include "UiMetrics.h"
+
+#include <gtkmm.h>
+#include <gtk/gtk.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+struct Result {
+  std::string name;
+  double ns_per_op = 0.0;
+  uint64_t iterations = 0;
+  bool skipped = false;
+  long rss_delta_kb = -1;  // only for cases that measure memory
+  double allocs_per_op = -1.0;  // only alloc/* cases
+};
+
+struct Options {
+  std::string json_path;
+  std::string filter;
+  double min_time_s = 0.1;
+  bool check_allocs = false;
+  bool check_config = false;
+};
+
+std::vector<Result> g_results;
+Options g_opts;
+volatile std::size_t g_sink = 0;
+int g_alloc_failures = 0;
+int g_alloc_cases = 0;  // alloc/* cases that actually ran
+
+bool selected(const std::string& name) {
+  return g_opts.filter.empty() || name.find(g_opts.filter) != std::string::npos;
+}
+
+void skip(const std::string& name) {
+  if (!selected(name)) return;
+  g_results.push_back({ name, 0.0, 0, true });
+  std::printf("%-40s skipped\n", name.c_str());
+}
+
+// Runs fn in growing batches until one batch takes at least min_time.
+void bench(const std::string& name, const std::function<void()>& fn, double min_time_s = -1.0) {
+  if (!selected(name)) return;
+  if (min_time_s < 0) min_time_s = g_opts.min_time_s;
+
+  using clock = std::chrono::steady_clock;
+  fn(); // warm-up
+
+  uint64_t n = 1;
+  for (;;) {
+    const auto t0 = clock::now();
+    for (uint64_t i = 0; i < n; ++i) fn();
+    const double s = std::chrono::duration<double>(clock::now() - t0).count();
+    if (s >= min_time_s || n >= (1ull << 30)) {
+      const double ns = s * 1e9 / (double)n;
+      g_results.push_back({ name, ns, n, false });
+      std::printf("%-40s %14.1f ns/op  (%llu iters)\n", name.c_str(), ns, (unsigned long long)n);
+      return;
+    }
+    n *= 2;
+  }
+}
+
+// Heap allocations per call of fn inside the Draw and Swipe scopes, after
+// a few calls have filled the caches.
+void alloc_case(const std::string& name, const std::function<void()>& fn) {
+  if (!selected(name)) return;
+  if (!AllocStats::kEnabled) {
+    skip(name);
+    return;
+  }
+  using AllocStats::Scope;
+  ++g_alloc_cases;
+  for (int i = 0; i < 4; ++i) fn();
+
+  constexpr int kRuns = 64;
+  const auto d0 = AllocStats::get(Scope::Draw), s0 = AllocStats::get(Scope::Swipe);
+  for (int i = 0; i < kRuns; ++i) fn();
+  const auto d1 = AllocStats::get(Scope::Draw), s1 = AllocStats::get(Scope::Swipe);
+
+  const uint64_t allocs = (d1.allocs - d0.allocs) + (s1.allocs - s0.allocs);
+  const uint64_t bytes = (d1.bytes - d0.bytes) + (s1.bytes - s0.bytes);
+  Result r{ name, 0.0, kRuns, false };
+  r.allocs_per_op = (double)allocs / kRuns;
+  g_results.push_back(r);
+  std::printf("%-40s %14.2f allocs/op  (%.0f B/op)\n", name.c_str(), r.allocs_per_op, (double)bytes / kRuns);
+  if (allocs) ++g_alloc_failures;
+}
+
+// ---- fixtures ----
+
+long rss_kb() {
+  long pages = 0, rss = 0;
+  if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+    if (std::fscanf(f, "%ld %ld", &pages, &rss) != 2) rss = 0;
+    std::fclose(f);
+  }
+  return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+std::string make_config_json(int entries) {
+  static const char* kFa[] = { "chart-area", "tachometer-alt", "paper-plane", "cloud-sun-rain",
+                               "camera", "music", "youtube", "route", "envelope", "unknown-icon" };
+  static const char* kBg[] = { "Peru", "SeaGreen", "IndianRed", "RoyalBlue", "bg-blue", "#123456" };
+
+  std::string json = "{\n";
+  const int per_page = (entries + 1) / 2;
+  for (int page = 1; page <= 2; ++page) {
+    json += "  \"commands" + std::to_string(page) + "\": [\n";
+    const int begin = (page - 1) * per_page;
+    const int end = std::min(entries, begin + per_page);
+    for (int i = begin; i < end; ++i) {
+      json += "    {\"name\": \"tile" + std::to_string(i) + "\", \"title\": \"Tile " + std::to_string(i)
+            + "\", \"bg\": \"" + kBg[i % 6] + "\", \"cmd\": \"onlyone\", \"args\": [\"/usr/bin/app"
+            + std::to_string(i) + "\", \"-l=error\"], \"fa\": \"" + kFa[i % 10] + "\"}";
+      json += (i + 1 < end) ? ",\n" : "\n";
+    }
+    json += (page == 1) ? "  ],\n" : "  ]\n";
+  }
+  json += "}\n";
+  return json;
+}
+
+std::string write_temp(const std::string& contents) {
+  gchar* path = nullptr;
+  const int fd = g_file_open_tmp("sv-bench-XXXXXX.json", &path, nullptr);
+  if (fd < 0) return {};
+  g_close(fd, nullptr);
+  g_file_set_contents(path, contents.data(), (gssize)contents.size(), nullptr);
+  std::string out = path;
+  g_free(path);
+  return out;
+}
+
+std::vector<IconSpec> sample_specs(int n) {
+  const auto cfg = load_icon_config_from_file("/nonexistent"); // built-in layout
+  const auto& page = cfg.pages.front();
+  std::vector<IconSpec> out;
+  for (int i = 0; i < n; ++i) out.push_back(page.at(i % page.size()));
+  return out;
+}
+
+IconConfig sample_config(int tiles) {
+  IconConfig cfg = load_icon_config_from_file("/nonexistent");
+  const auto specs = sample_specs(tiles);
+  const std::size_t per_page = (std::size_t)(cfg.cols * cfg.rows);
+  cfg.pages.clear();
+  for (std::size_t i = 0; i < specs.size(); i += per_page) {
+    cfg.pages.emplace_back(specs.begin() + i, specs.begin() + std::min(specs.size(), i + per_page));
+  }
+  return cfg;
+}
+
+// make_config_json plus every other section the readers know.
+std::string make_full_config_json(int entries) {
+  std::string json = make_config_json(entries);
+  json.resize(json.rfind('}'));
+  json.back() = ',';
+  json += R"(
+  "grid": {"cols": 4, "rows": 4},
+  "budgets": {"cpu": 50, "rss_mb": 256},
+  "schemes": [{"name": "Ocean", "label": "#eeeeee", "icon": "white", "background": "palette"},
+              {"name": "night", "icon": "not a color"}],
+  "idle": {"after_s": 120, "night": true, "backlight": 20, "backlight_path": "/sys/class/backlight/x"},
+  "autostart": ["tile0", {"tile": "tile1", "after": ["tile0"]}],
+  "scenes": [{"name": "work", "tiles": [{"tile": "tile2"}, {"tile": "Tile 3", "after": ["tile2"]}]}],
+  "launch": {"parallel": 3},
+  "unknown": [1, {"a": null}, "xé😀"]
+}
+)";
+  return json;
+}
+
+void drain_events() {
+  while (g_main_context_iteration(nullptr, FALSE)) {}
+}
+
+// ---- cases ----
+
+void bench_config() {
+  for (int n : { 15, 150, 1500, 5000 }) {
+    const std::string name = "load_icon_config/" + std::to_string(n);
+    if (!selected(name)) continue;
+    const std::string path = write_temp(make_config_json(n));
+    bench(name, [&] { g_sink += load_icon_config_from_file(path).pages.size(); });
+    g_unlink(path.c_str());
+  }
+}
+
+void bench_lookup() {
+  const std::vector<std::string> names = {
+    "chart-area", "tachometer-alt", "paper-plane", "youtube", "anchor",
+    "no-such-icon", "terminal", "solar-panel", "book", "chess",
+  };
+  bench("glyph_for_image", [&] {
+    for (const auto& n : names) g_sink += glyph_for_image(n).codepoint;
+  });
+
+  const std::vector<std::string> colors = {
+    "Peru", "SeaGreen", "#1976D2", "Indian Red", "rgb(10, 20, 30)", "bg-blue",
+  };
+  bench("slugify_color", [&] {
+    for (const auto& c : colors) g_sink += slugify_color(c).size();
+  });
+}
+
+void bench_css() {
+  const auto schemes = Theme::merge_schemes({});
+  for (int n : { 12, 100, 1000 }) {
+    std::vector<std::pair<std::string, std::string>> palette;
+    for (int i = 0; i < n; ++i) palette.emplace_back("bg-c" + std::to_string(i), "#a0b0c0");
+
+    bench("build_css/palette-" + std::to_string(n), [&] {
+      std::string css = Theme::base_css();
+      css += Theme::scheme_css(schemes);
+      css += Theme::palette_css(palette);
+      css += Theme::metrics_css(94, 1.0);
+      g_sink += css.size();
+    });
+  }
+}
+
+// IconCanvas cache-miss path without a widget: shape + rasterize the glyph.
+void bench_glyph_raster() {
+  for (int b = 0; b < UiScale::bucket_count(); ++b) {
+    const auto& m = UiScale::metrics(b);
+    const std::string name = "glyph_raster/b" + std::to_string(b);
+    if (!selected(name)) continue;
+
+    const int box = m.icon_box_px;
+    auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, box, box);
+    cairo_t* cr = cairo_create(surface);
+
+    PangoFontDescription* fd = pango_font_description_new();
+    pango_font_description_set_family(fd, FontRegistry::kFamilyFree);
+    pango_font_description_set_weight(fd, PANGO_WEIGHT_HEAVY);
+    pango_font_description_set_size(fd, std::max(6, (int)(box * 0.42)) * PANGO_SCALE);
+
+    bench(name, [&] {
+      PangoLayout* layout = pango_cairo_create_layout(cr);
+      pango_layout_set_text(layout, "\xef\x96\xa0", -1); // U+F5A0
+      pango_layout_set_font_description(layout, fd);
+      int lw = 0, lh = 0;
+      pango_layout_get_pixel_size(layout, &lw, &lh);
+      cairo_move_to(cr, (box - lw) * 0.5, (box - lh) * 0.5);
+      pango_cairo_show_layout(cr, layout);
+      g_object_unref(layout);
+    }, g_opts.min_time_s / 5);
+
+    pango_font_description_free(fd);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+  }
+}
+
+// Same glyph from the SDF atlas (skipped when the build made none).
+void bench_glyph_atlas() {
+  const bool have_atlas = GlyphAtlas::instance().load() && GlyphAtlas::instance().has(U'\uf5a0', FaStyle::Solid);
+  for (int b = 0; b < UiScale::bucket_count(); ++b) {
+    const auto& m = UiScale::metrics(b);
+    const std::string name = "glyph_atlas/b" + std::to_string(b);
+    if (!selected(name)) continue;
+    if (!have_atlas) {
+      skip(name);
+      continue;
+    }
+
+    const int box = m.icon_box_px;
+    auto surface = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, box, box);
+    auto cr = Cairo::Context::create(surface);
+    const double em = std::max(6, (int)(box * 0.42)) * 96.0 / 72.0;
+
+    bench(name, [&] {
+      GlyphAtlas::instance().draw_centered(cr, U'\uf5a0', FaStyle::Solid, em, 0, 0, box, box);
+    }, g_opts.min_time_s / 5);
+  }
+}
+
+void bench_widgets(bool have_display) {
+  if (!have_display) {
+    skip("desktop_construct/15");
+    skip("page_rescale/widgets/15");
+    skip("page_rescale/grid/15");
+    for (int b = 0; b < UiScale::bucket_count(); ++b) {
+      skip("icon_draw_miss/b" + std::to_string(b));
+      skip("icon_draw_hit/b" + std::to_string(b));
+    }
+    for (int n : { 15, 150, 500 }) skip("window_startup/" + std::to_string(n));
+    skip("alloc/icon_draw");
+    skip("alloc/grid_draw/15");
+    skip("alloc/swipe/15");
+    return;
+  }
+
+  for (int n : { 15, 150, 500 }) {
+    const std::string name = "window_startup/" + std::to_string(n);
+    if (!selected(name)) continue;
+    const auto cfg = std::make_shared<const IconConfig>(sample_config(n));
+
+    const long rss0 = rss_kb();
+    auto* keep = new MainWindow(cfg);
+    drain_events();
+    const long rss_delta = rss_kb() - rss0;
+
+    bench(name, [&] {
+      auto* w = new MainWindow(cfg);
+      drain_events();
+      delete w;
+    }, g_opts.min_time_s / 2);
+    g_results.back().rss_delta_kb = rss_delta;
+    std::printf("%-40s %14ld kB RSS\n", "", rss_delta);
+    delete keep;
+    drain_events();
+  }
+
+  const auto specs = sample_specs(15);
+  bench("desktop_construct/15", [&] {
+    auto* d = new Desktop(specs);
+    g_sink += (std::size_t)d;
+    delete d;
+  });
+
+  // Scale change + relayout + redraw of a shown page, per renderer.
+  for (auto [label, r] : { std::pair{ "widgets", Desktop::Renderer::Widgets },
+                           std::pair{ "grid", Desktop::Renderer::Grid } }) {
+    Gtk::OffscreenWindow page_win;
+    auto* d = Gtk::manage(new Desktop(specs, kCols, r));
+    page_win.add(*d);
+    page_win.show_all();
+    drain_events();
+
+    const int b0 = UiScale::bucket_count() - 1;
+    const int b1 = b0 / 2;
+    int flip = 0;
+    bench(std::string("page_rescale/") + label + "/15", [&] {
+      d->set_ui_metrics(UiScale::metrics((flip++ & 1) ? b1 : b0), true);
+      drain_events();
+    }, g_opts.min_time_s / 2);
+  }
+
+  // Draw one tile at every scale bucket through the real widget.
+  Gtk::OffscreenWindow win;
+  DesktopIcon icon(specs.front());
+  icon.set_color_class(specs.front().colorClass);
+  win.add(icon);
+  win.show_all();
+  drain_events();
+
+  for (int b = 0; b < UiScale::bucket_count(); ++b) {
+    const auto& m = UiScale::metrics(b);
+    icon.set_ui_metrics(m, true);
+    drain_events();
+
+    const int box = m.icon_box_px;
+    auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, box * 2, box * 2);
+    cairo_t* cr = cairo_create(surface);
+
+    bench("icon_draw_miss/b" + std::to_string(b), [&] {
+      TileCache::instance().clear();
+      gtk_widget_draw(GTK_WIDGET(icon.gobj()), cr);
+    }, g_opts.min_time_s / 5);
+    bench("icon_draw_hit/b" + std::to_string(b), [&] {
+      gtk_widget_draw(GTK_WIDGET(icon.gobj()), cr);
+    }, g_opts.min_time_s / 5);
+
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+  }
+}
+
+// Steady state of the draw and swipe paths: every tile cached, badges on.
+void bench_status_feed() {
+  if (!selected("status_feed/poll_idle") && !selected("status_feed/publish+poll")) return;
+  gchar* dir = g_dir_make_tmp("sv-bench-XXXXXX", nullptr);
+  if (!dir) return;
+  const std::string path = std::string(dir) + "/status";
+  for (int i = 0; i < 32; ++i) {
+    StatusFeed::publish(path, "tile-" + std::to_string(i), std::to_string(i) + "%", StatusFeed::Normal);
+  }
+  g_setenv("SV_DASHBOARD_STATUS", path.c_str(), TRUE);
+  auto& feed = StatusFeed::instance();
+  feed.start();
+  feed.poll();
+
+  bench("status_feed/poll_idle", [&] { g_sink += feed.poll(); });
+  int n = 0;
+  bench("status_feed/publish+poll", [&] {
+    StatusFeed::publish(path, "tile-7", std::to_string(n++ % 100) + "%", StatusFeed::Normal);
+    g_sink += feed.poll();
+  });
+
+  feed.suspend();
+  g_unlink(path.c_str());
+  g_rmdir(dir);
+  g_free(dir);
+}
+
+void bench_allocs(bool have_display) {
+  if (!have_display) return;  // skipped by bench_widgets
+  const auto specs = sample_specs(15);
+  const auto& m = UiScale::metrics(UiScale::bucket_count() / 2);
+
+  {
+    Gtk::OffscreenWindow win;
+    DesktopIcon icon(specs.front());
+    icon.set_color_class(specs.front().colorClass);
+    icon.set_ui_metrics(m, true);
+    icon.set_badge("42%", false);
+    win.add(icon);
+    win.show_all();
+    drain_events();
+
+    auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, m.icon_box_px * 2, m.icon_box_px * 2);
+    cairo_t* cr = cairo_create(surface);
+    alloc_case("alloc/icon_draw", [&] { gtk_widget_draw(GTK_WIDGET(icon.gobj()), cr); });
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+  }
+
+  auto make_grid = [&] {
+    auto* g = Gtk::manage(new TileGrid(kCols));
+    for (int i = 0; i < (int)specs.size(); ++i) {
+      g->set_tile(i, specs[i]);
+      if (i % 3 == 0) g->set_badge(i, std::to_string(i * 7) + "%", i % 2 == 0);
+    }
+    g->set_ui_metrics(m, true);
+    return g;
+  };
+
+  {
+    Gtk::OffscreenWindow win;
+    auto* grid = make_grid();
+    win.add(*grid);
+    win.show_all();
+    drain_events();
+
+    const int w = std::max(1, grid->get_allocated_width()), h = std::max(1, grid->get_allocated_height());
+    auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+    cairo_t* cr = cairo_create(surface);
+    alloc_case("alloc/grid_draw/15", [&] { gtk_widget_draw(GTK_WIDGET(grid->gobj()), cr); });
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+  }
+
+  {
+    Gtk::OffscreenWindow win;
+    PagerView pager;
+    auto* a = make_grid();
+    auto* b = make_grid();
+    pager.add(*a);
+    pager.add(*b);
+    pager.set_neighbour_fn([b](int dir) -> Gtk::Widget* { return dir > 0 ? b : nullptr; });
+    win.add(pager);
+    win.show_all();
+    drain_events();
+
+    const int w = std::max(1, pager.get_allocated_width()), h = std::max(1, pager.get_allocated_height());
+    auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+    cairo_t* cr = cairo_create(surface);
+    pager.drag_begin();
+    pager.drag_update(-1.0);  // reveals (snapshots) the right-hand page
+    int step = 0;
+    alloc_case("alloc/swipe/15", [&] {
+      pager.drag_update(-2.0 - (step++ % (w / 2 + 1)));
+      gtk_widget_draw(GTK_WIDGET(pager.gobj()), cr);
+    });
+    pager.settle_now();
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+  }
+}
+
+int g_check_failures = 0;
+
+void check(bool ok, const std::string& what) {
+  if (ok) return;
+  std::fprintf(stderr, "sv-bench: FAIL %s\n", what.c_str());
+  ++g_check_failures;
+}
+
+bool parses(const std::string& json, bool stream) {
+  IconConfig cfg;
+  return parse_icon_config_data(json.data(), json.size(), stream, cfg);
+}
+
+bool read_file(const std::string& path, std::string& out) {
+  gchar* data = nullptr;
+  gsize len = 0;
+  if (!g_file_get_contents(path.c_str(), &data, &len, nullptr)) return false;
+  out.assign(data, len);
+  g_free(data);
+  return true;
+}
+
+void check_snapshot(const std::string& name, const std::string& json, const IconConfig& parsed) {
+  const std::string path = write_temp(json);
+  ConfigCache::Source src;
+  GMappedFile* mf = ConfigCache::map_source(path, src);
+  check(mf, name + ": map source");
+  if (!mf) return;
+  g_mapped_file_unref(mf);
+
+  ConfigCache::store(path, src, parsed);
+  IconConfig loaded;
+  check(ConfigCache::load(path, loaded) && loaded == parsed, name + ": snapshot round-trip");
+
+  const std::string snap = ConfigCache::cache_path_for(path);
+  std::string bytes;
+  check(read_file(snap, bytes), name + ": read snapshot");
+  auto load_bytes = [&](const std::string& b) {
+    g_file_set_contents(snap.c_str(), b.data(), (gssize)b.size(), nullptr);
+    IconConfig cfg;
+    try {
+      return ConfigCache::load(path, cfg);
+    } catch (const std::exception& e) {
+      check(false, name + ": snapshot load threw " + e.what());
+      return false;
+    }
+  };
+
+  for (std::size_t n = 0; n < bytes.size(); ++n) {
+    if (load_bytes(bytes.substr(0, n))) check(false, name + ": truncated snapshot (" + std::to_string(n) + " bytes) loaded");
+  }
+
+  // The payload starts with cols, rows and the page count.
+  const uint32_t head[3] = { (uint32_t)parsed.cols, (uint32_t)parsed.rows, (uint32_t)parsed.pages.size() };
+  const std::size_t at = bytes.find(std::string(reinterpret_cast<const char*>(head), sizeof(head)));
+  check(at != std::string::npos, name + ": page count in snapshot");
+  for (uint32_t count : { 0xFFFFFFF0u, 0x7FFFFFFFu, (uint32_t)bytes.size() }) {
+    if (at == std::string::npos) break;
+    std::string b = bytes;
+    std::memcpy(&b[at + 8], &count, sizeof(count));
+    check(!load_bytes(b), name + ": oversized page count loaded");
+  }
+  // Any other field as a huge count must fail (or decode) without throwing.
+  for (std::size_t off = 0; off + 4 <= bytes.size(); ++off) {
+    std::string b = bytes;
+    const uint32_t huge = 0xFFFFFFF0u;
+    std::memcpy(&b[off], &huge, sizeof(huge));
+    load_bytes(b);
+  }
+
+  g_unlink(snap.c_str());
+  g_unlink(path.c_str());
+}
+
+void check_config() {
+  // Keep snapshots out of the real cache.
+  gchar* cache = g_dir_make_tmp("sv-bench-cache-XXXXXX", nullptr);
+  if (cache) g_setenv("XDG_CACHE_HOME", cache, TRUE);
+
+  for (int n : { 15, 150, 1500, 5000 }) {
+    for (bool full : { false, true }) {
+      const std::string name = (full ? "full_config/" : "config/") + std::to_string(n);
+      const std::string json = full ? make_full_config_json(n) : make_config_json(n);
+
+      IconConfig streamed, dom;
+      const bool stream_ok = parse_icon_config_data(json.data(), json.size(), true, streamed);
+      const bool dom_ok = parse_icon_config_data(json.data(), json.size(), false, dom);
+      check(stream_ok && dom_ok, name + ": parse");
+      check(streamed == dom, name + ": stream parse equals DOM parse");
+      if (n == 15) check_snapshot(name, json, dom);
+
+      // Every prefix up to the closing brace is invalid JSON.
+      const std::size_t close = json.rfind('}');
+      const std::size_t step = std::max<std::size_t>(1, close / 97);
+      for (std::size_t cut = 1; cut < close; cut += step) {
+        const std::string prefix = json.substr(0, cut);
+        check(!parses(prefix, true) && !parses(prefix, false),
+              name + ": truncated at " + std::to_string(cut) + " parsed");
+      }
+
+      // A NUL inside a string and between tokens.
+      std::string in_string = json;
+      in_string.insert(json.find("Tile ") + 2, 1, '\0');
+      std::string between = json;
+      between.insert(json.find(',') + 1, 1, '\0');
+      for (const std::string* bad : { &in_string, &between }) {
+        check(!parses(*bad, true) && !parses(*bad, false), name + ": embedded NUL parsed");
+      }
+    }
+  }
+
+  if (cache) {
+    g_rmdir((std::string(cache) + "/sv-dashboard-gtk").c_str());
+    g_rmdir(cache);
+    g_free(cache);
+  }
+}
+
+void write_json(const std::string& path) {
+  FILE* f = path == "-" ? stdout : g_fopen(path.c_str(), "wb");
+  if (!f) {
+    std::fprintf(stderr, "sv-bench: cannot write %s\n", path.c_str());
+    return;
+  }
+  std::fprintf(f, "{\n  \"version\": 1,\n  \"results\": [\n");
+  for (std::size_t i = 0; i < g_results.size(); ++i) {
+    const auto& r = g_results[i];
+    std::string extra;
+    if (r.rss_delta_kb >= 0) extra = ", \"rss_delta_kb\": " + std::to_string(r.rss_delta_kb);
+    if (r.allocs_per_op >= 0) extra += ", \"allocs_per_op\": " + std::to_string(r.allocs_per_op);
+    std::fprintf(f, "    {\"name\": \"%s\", \"ns_per_op\": %.1f, \"iterations\": %llu, \"skipped\": %s%s}%s\n",
+                 r.name.c_str(), r.ns_per_op, (unsigned long long)r.iterations,
+                 r.skipped ? "true" : "false", extra.c_str(), (i + 1 < g_results.size()) ? "," : "");
+  }
+  std::fprintf(f, "  ]\n}\n");
+  if (f != stdout) std::fclose(f);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--json") && i + 1 < argc) g_opts.json_path = argv[++i];
+    else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) g_opts.filter = argv[++i];
+    else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) g_opts.min_time_s = std::atof(argv[++i]);
+    else if (!std::strcmp(argv[i], "--check-allocs")) g_opts.check_allocs = true;
+    else if (!std::strcmp(argv[i], "--check-config")) g_opts.check_config = true;
+    else {
+      std::fprintf(stderr, "usage: %s [--json FILE] [--filter SUBSTR] [--min-time SECONDS] [--check-allocs]"
+                   " [--check-config]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (g_opts.check_config) {
+    check_config();
+    if (g_check_failures) std::fprintf(stderr, "sv-bench: %d config check(s) failed\n", g_check_failures);
+    return g_check_failures ? 1 : 0;
+  }
+
+  FontRegistry fonts;
+  fonts.registerBundledFonts();
+
+  bench_config();
+  bench_lookup();
+  bench_css();
+  bench_glyph_raster();
+  bench_glyph_atlas();
+  bench_status_feed();
+
+  const bool have_display = gtk_init_check(&argc, &argv);
+  bench_widgets(have_display);
+  bench_allocs(have_display);
+
+  if (!g_opts.json_path.empty()) write_json(g_opts.json_path);
+  if (g_opts.check_allocs && g_alloc_failures) {
+    std::fprintf(stderr, "sv-bench: %d steady-state case(s) allocated\n", g_alloc_failures);
+    return 1;
+  }
+  if (g_opts.check_allocs && !g_alloc_cases) {
+    std::fprintf(stderr, "sv-bench: no alloc case ran\n");
+    return 77;  // meson reports SKIP
+  }
+  return 0;
+}
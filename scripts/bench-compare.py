@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Compare two sv-bench JSON result files.
+
+usage: bench-compare.py BASELINE.json CURRENT.json [--threshold PCT]
+
+Exits non-zero if any benchmark present in both files got slower than
+the threshold (default 10%). Skipped results are ignored.
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    return {r["name"]: r for r in data.get("results", []) if not r.get("skipped")}
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent")
+    args = ap.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+
+    regressions = 0
+    for name in sorted(base.keys() & cur.keys()):
+        b = base[name]["ns_per_op"]
+        c = cur[name]["ns_per_op"]
+        if b <= 0:
+            continue
+        delta = (c - b) / b * 100.0
+        flag = ""
+        if delta > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:40s} {b:14.1f} -> {c:14.1f} ns/op  {delta:+7.1f}%{flag}")
+
+    for name in sorted(cur.keys() - base.keys()):
+        print(f"{name:40s} (new)")
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -39,6 +39,11 @@ if [[ -f "${WEBFONTS_DIR}/fa-regular-400.ttf" ]]; then
   cp -f "${WEBFONTS_DIR}/fa-regular-400.ttf" "${ASSETS_DIR}/"
 fi
 
+# Icon metadata (name/alias -> codepoint table, consumed by scripts/gen-fa-glyphs.py)
+if [[ -f "${BASE_DIR}/metadata/icons.json" ]]; then
+  cp -f "${BASE_DIR}/metadata/icons.json" "${TP_DIR}/icons.json"
+fi
+
 # License
 if [[ -f "${BASE_DIR}/LICENSE.txt" ]]; then
   cp -f "${BASE_DIR}/LICENSE.txt" "${TP_DIR}/LICENSE.txt"
@@ -47,7 +52,7 @@ fi
 cat > "${TP_DIR}/SOURCE.txt" <<EOF
 Font Awesome Free ${FA_VER}
 Downloaded from: ${ZIP_URL}
-Contains: fa-solid-900.ttf, fa-brands-400.ttf (and optional fa-regular-400.ttf)
+Contains: fa-solid-900.ttf, fa-brands-400.ttf (and optional fa-regular-400.ttf), icons.json
 EOF
 
 echo "[FA] Installed fonts into ${ASSETS_DIR}"
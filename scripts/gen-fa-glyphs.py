@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Generate fa_glyphs.h: a constexpr minimal perfect hash of Font Awesome names.
+
+usage: gen-fa-glyphs.py --aliases assets/fa-aliases.json
+                        [--metadata third_party/fontawesome/icons.json]
+                        --output fa_glyphs.h
+
+The metadata is Font Awesome's metadata/icons.json for the version pinned in
+scripts/fetch-fontawesome.sh. Every free solid/regular/brands icon name and
+its aliases are included. When the metadata is missing (fonts not fetched yet)
+only the launcher aliases are emitted. Launcher aliases win over FA names.
+
+Hashing (must match fa_hash() in Icons.cpp): FNV-1a 32 seeded by XOR with the
+offset basis, then a murmur3 finalizer. bucket = hash(name, 0) % B,
+slot = hash(name, displace[bucket]) % N.
+"""
+import argparse
+import json
+import os
+import sys
+
+STYLE_BITS = {"solid": 1, "regular": 2, "brands": 4}
+
+
+def fa_hash(name: bytes, seed: int) -> int:
+    h = (2166136261 ^ seed) & 0xFFFFFFFF
+    for b in name:
+        h ^= b
+        h = (h * 16777619) & 0xFFFFFFFF
+    h ^= h >> 16
+    h = (h * 0x85EBCA6B) & 0xFFFFFFFF
+    h ^= h >> 13
+    h = (h * 0xC2B2AE35) & 0xFFFFFFFF
+    h ^= h >> 16
+    return h
+
+
+def load_entries(aliases_path, metadata_path):
+    entries = {}  # name -> (codepoint, style bits)
+
+    if metadata_path and os.path.isfile(metadata_path):
+        with open(metadata_path, encoding="utf-8") as f:
+            meta = json.load(f)
+        primary = {}
+        secondary = {}
+        for name, icon in meta.items():
+            # Pro-only icons have "free": []; the bundled fonts lack them.
+            styles = icon.get("free", [])
+            if not styles:
+                continue
+            bits = 0
+            for s in styles:
+                bits |= STYLE_BITS.get(s, 0)
+            if not bits or "unicode" not in icon:
+                continue
+            cp = int(icon["unicode"], 16)
+            primary[name] = (cp, bits)
+            for alias in (icon.get("aliases") or {}).get("names", []):
+                secondary.setdefault(alias, (cp, bits))
+        entries.update(secondary)
+        entries.update(primary)
+    elif metadata_path:
+        print(f"gen-fa-glyphs: {metadata_path} not found; emitting launcher aliases only",
+              file=sys.stderr)
+
+    with open(aliases_path, encoding="utf-8") as f:
+        aliases = json.load(f)
+    for name, spec in aliases.items():
+        if name.startswith("_"):
+            continue
+        entries[name] = (int(spec["unicode"], 16), STYLE_BITS[spec.get("style", "solid")])
+
+    return entries
+
+
+def build_chd(names):
+    n = len(names)
+    nb = max(1, (n + 3) // 4)
+    buckets = [[] for _ in range(nb)]
+    for name in names:
+        buckets[fa_hash(name.encode(), 0) % nb].append(name)
+
+    displace = [0] * nb
+    slots = [None] * n
+    for bi in sorted(range(nb), key=lambda i: -len(buckets[i])):
+        keys = buckets[bi]
+        if not keys:
+            continue
+        d = 1
+        while True:
+            pos = [fa_hash(k.encode(), d) % n for k in keys]
+            if len(set(pos)) == len(pos) and all(slots[p] is None for p in pos):
+                break
+            d += 1
+            if d > 0xFFFFFF:
+                raise SystemExit("gen-fa-glyphs: could not place bucket")
+        displace[bi] = d
+        for k, p in zip(keys, pos):
+            slots[p] = k
+    return displace, slots
+
+
+def table_hash(entries):
+    """FNV-1a 64 over the sorted table, so snapshots resolved against
+    another table (e.g. before the metadata was fetched) are rebuilt."""
+    h = 0xCBF29CE484222325
+    for name in sorted(entries):
+        cp, bits = entries[name]
+        for b in f"{name}\t{cp:x}\t{bits}\n".encode():
+            h ^= b
+            h = (h * 0x100000001B3) & 0xFFFFFFFFFFFFFFFF
+    return h
+
+
+def c_string(s):
+    return '"' + s.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--aliases", required=True)
+    ap.add_argument("--metadata")
+    ap.add_argument("--output", required=True)
+    args = ap.parse_args()
+
+    entries = load_entries(args.aliases, args.metadata)
+    names = sorted(entries)
+    displace, slots = build_chd(names)
+
+    lines = [
+        "// Generated by scripts/gen-fa-glyphs.py. Do not edit.",
+        "#pragma once",
+        "",
+        "#include <cstdint>",
+        "#include <string_view>",
+        "",
+        "namespace fa_glyphs {",
+        "",
+        "inline constexpr uint8_t kSolid   = 1;",
+        "inline constexpr uint8_t kRegular = 2;",
+        "inline constexpr uint8_t kBrands  = 4;",
+        "",
+        "struct Entry {",
+        "  std::string_view name;",
+        "  char32_t codepoint;",
+        "  uint8_t styles;",
+        "};",
+        "",
+        f"inline constexpr uint32_t kCount = {len(slots)};",
+        f"inline constexpr uint32_t kBuckets = {len(displace)};",
+        f"inline constexpr uint64_t kTableHash = 0x{table_hash(entries):016x}ULL;",
+        "",
+        "inline constexpr uint32_t kDisplace[kBuckets] = {",
+    ]
+    for i in range(0, len(displace), 12):
+        lines.append("  " + ", ".join(str(d) for d in displace[i:i + 12]) + ",")
+    lines += ["};", "", "inline constexpr Entry kEntries[kCount] = {"]
+    for name in slots:
+        cp, bits = entries[name]
+        lines.append(f"  {{ {c_string(name)}, 0x{cp:04x}, {bits} }},")
+    lines += ["};", "", "} // namespace fa_glyphs", ""]
+
+    out = "\n".join(lines)
+    if os.path.exists(args.output):
+        with open(args.output, encoding="utf-8") as f:
+            if f.read() == out:
+                return 0
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write(out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,191 @@
+#include "AllocStats.h"
+
+#include <gtk/gtk.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace AllocStats {
+namespace {
+
+constexpr int kScopes = (int)Scope::Count;
+
+std::atomic<uint64_t> g_allocs[kScopes];
+std::atomic<uint64_t> g_bytes[kScopes];
+
+// Initial-exec TLS: reading it from inside malloc must never allocate.
+#if SV_DASHBOARD_ALLOC_STATS && defined(__GNUC__)
+__attribute__((tls_model("initial-exec")))
+#endif
+thread_local Scope t_scope = Scope::Other;
+
+Counters frame_start[kScopes];
+Counters frame_last[kScopes];
+uint64_t frame_count = 0;
+uint64_t frame_allocating = 0;
+
+[[maybe_unused]] inline void count(std::size_t n) {
+  const int s = (int)t_scope;
+  g_allocs[s].fetch_add(1, std::memory_order_relaxed);
+  g_bytes[s].fetch_add(n, std::memory_order_relaxed);
+}
+
+void on_after_paint(GdkFrameClock*, gpointer) {
+  bool allocated = false;
+  for (Scope s : { Scope::Draw, Scope::Swipe }) {
+    const int i = (int)s;
+    const Counters now = get(s);
+    frame_last[i] = { now.allocs - frame_start[i].allocs, now.bytes - frame_start[i].bytes };
+    frame_start[i] = now;
+    allocated = allocated || frame_last[i].allocs;
+  }
+  ++frame_count;
+  if (allocated) ++frame_allocating;
+}
+
+} // namespace
+
+const char* name(Scope s) {
+  switch (s) {
+    case Scope::Other:  return "other";
+    case Scope::Draw:   return "draw";
+    case Scope::Swipe:  return "swipe";
+    case Scope::Config: return "config";
+    case Scope::Launch: return "launch";
+    case Scope::Count:  break;
+  }
+  return "?";
+}
+
+Counters get(Scope s) {
+  const int i = (int)s;
+  return { g_allocs[i].load(std::memory_order_relaxed), g_bytes[i].load(std::memory_order_relaxed) };
+}
+
+Counters total() {
+  Counters c;
+  for (int i = 0; i < kScopes; ++i) {
+    const Counters s = get((Scope)i);
+    c.allocs += s.allocs;
+    c.bytes += s.bytes;
+  }
+  return c;
+}
+
+void watch_frames(GtkWidget* toplevel) {
+  if constexpr (!kEnabled) return;
+  auto connect = +[](GtkWidget* w, gpointer) {
+    if (GdkFrameClock* clock = gtk_widget_get_frame_clock(w)) {
+      g_signal_connect(clock, "after-paint", G_CALLBACK(on_after_paint), nullptr);
+    }
+  };
+  if (gtk_widget_get_realized(toplevel)) connect(toplevel, nullptr);
+  else g_signal_connect(toplevel, "realize", G_CALLBACK(connect), nullptr);
+}
+
+Counters last_frame(Scope s) {
+  return frame_last[(int)s];
+}
+
+uint64_t frames() {
+  return frame_count;
+}
+
+uint64_t frames_with_allocs() {
+  return frame_allocating;
+}
+
+ScopeGuard::ScopeGuard(Scope s) : prev_(t_scope) {
+  t_scope = s;
+}
+
+ScopeGuard::~ScopeGuard() {
+  t_scope = prev_;
+}
+
+} // namespace AllocStats
+
+#if SV_DASHBOARD_ALLOC_STATS
+#if defined(__GLIBC__)
+
+// glibc: interpose the malloc family, which operator new and every C
+// library in the process go through.
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void __libc_free(void*);
+
+void* malloc(size_t n) {
+  AllocStats::count(n);
+  return __libc_malloc(n);
+}
+
+void* calloc(size_t n, size_t size) {
+  AllocStats::count(n * size);
+  return __libc_calloc(n, size);
+}
+
+void* realloc(void* p, size_t n) {
+  if (n) AllocStats::count(n);
+  return __libc_realloc(p, n);
+}
+
+void* memalign(size_t align, size_t n) {
+  AllocStats::count(n);
+  return __libc_memalign(align, n);
+}
+
+void* aligned_alloc(size_t align, size_t n) {
+  AllocStats::count(n);
+  return __libc_memalign(align, n);
+}
+
+int posix_memalign(void** out, size_t align, size_t n) {
+  AllocStats::count(n);
+  void* p = __libc_memalign(align, n);
+  if (!p) return ENOMEM;
+  *out = p;
+  return 0;
+}
+
+void free(void* p) {
+  __libc_free(p);
+}
+} // extern "C"
+
+#else
+
+// Elsewhere only C++ allocations are seen.
+void* operator new(std::size_t n) {
+  AllocStats::count(n);
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t n) {
+  return ::operator new(n);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+#endif
+#endif // SV_DASHBOARD_ALLOC_STATS
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+typedef struct _GtkWidget GtkWidget;
+
+// Heap allocation counters per subsystem and per frame, compiled in with
+// -Dalloc_stats=true. The malloc family (and with it operator new) is hooked
+// process-wide, so GLib/Pango/cairo allocations made inside a scope count
+// towards it. Without the option the scopes compile to nothing and every
+// counter reads zero.
+namespace AllocStats {
+
+enum class Scope : uint8_t { Other, Draw, Swipe, Config, Launch, Count };
+
+struct Counters {
+  uint64_t allocs = 0;
+  uint64_t bytes = 0;
+};
+
+#if SV_DASHBOARD_ALLOC_STATS
+inline constexpr bool kEnabled = true;
+#else
+inline constexpr bool kEnabled = false;
+#endif
+
+const char* name(Scope s);
+Counters get(Scope s);  // since start
+Counters total();
+
+// Per-frame accounting of the Draw and Swipe scopes, closed on every
+// after-paint of `toplevel`'s frame clock once it is realized.
+void watch_frames(GtkWidget* toplevel);
+Counters last_frame(Scope s);
+uint64_t frames();
+uint64_t frames_with_allocs();  // frames whose Draw/Swipe scopes allocated
+
+class ScopeGuard {
+public:
+  explicit ScopeGuard(Scope s);
+  ~ScopeGuard();
+
+  ScopeGuard(const ScopeGuard&) = delete;
+  ScopeGuard& operator=(const ScopeGuard&) = delete;
+
+private:
+  Scope prev_;
+};
+
+} // namespace AllocStats
+
+#if SV_DASHBOARD_ALLOC_STATS
+  #define SV_ALLOC_CAT2(a, b) a##b
+  #define SV_ALLOC_CAT(a, b)  SV_ALLOC_CAT2(a, b)
+  #define SV_ALLOC_SCOPE(scope) \
+    ::AllocStats::ScopeGuard SV_ALLOC_CAT(sv_alloc_, __LINE__)(::AllocStats::Scope::scope)
+#else
+  #define SV_ALLOC_SCOPE(scope) ((void)0)
+#endif
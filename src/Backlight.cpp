@@ -0,0 +1,83 @@
+#include "Backlight.h"
+
+#include <glib.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr const char* kBacklightRoot = "/sys/class/backlight";
+
+// $SV_DASHBOARD_BACKLIGHT, else the configured device, else the first one.
+std::string resolve_backlight(const std::string& configured) {
+  if (const char* env = g_getenv("SV_DASHBOARD_BACKLIGHT"); env && *env) return env;
+  if (!configured.empty()) return configured;
+
+  GDir* dir = g_dir_open(kBacklightRoot, 0, nullptr);
+  if (!dir) return {};
+  std::string out;
+  if (const char* name = g_dir_read_name(dir)) {
+    gchar* p = g_build_filename(kBacklightRoot, name, nullptr);
+    out = p;
+    g_free(p);
+  }
+  g_dir_close(dir);
+  return out;
+}
+
+int read_int(const std::string& dir, const char* file) {
+  gchar* path = g_build_filename(dir.c_str(), file, nullptr);
+  gchar* data = nullptr;
+  int v = -1;
+  if (g_file_get_contents(path, &data, nullptr, nullptr)) v = std::atoi(data);
+  g_free(data);
+  g_free(path);
+  return v;
+}
+
+// sysfs attributes can't be replaced by rename, so no g_file_set_contents().
+bool write_int(const std::string& dir, const char* file, int v) {
+  gchar* path = g_build_filename(dir.c_str(), file, nullptr);
+  FILE* f = std::fopen(path, "w");
+  bool ok = f && std::fprintf(f, "%d\n", v) > 0;
+  if (f && std::fclose(f) != 0) ok = false;
+  if (!ok) g_warning("Backlight: cannot write %s", path);
+  g_free(path);
+  return ok;
+}
+
+} // namespace
+
+Backlight::~Backlight() {
+  restore();
+}
+
+void Backlight::configure(const IdleSpec& spec) {
+  restore();
+  spec_ = spec;
+  dir_.clear();
+}
+
+void Backlight::dim() {
+  if (saved_ >= 0 || spec_.backlight_pct < 0) return;
+  if (dir_.empty()) dir_ = resolve_backlight(spec_.backlight);
+  if (dir_.empty()) return;
+
+  const int max = read_int(dir_, "max_brightness");
+  const int cur = read_int(dir_, "brightness");
+  if (max <= 0 || cur < 0) {
+    g_warning("Backlight: no usable backlight in %s", dir_.c_str());
+    return;
+  }
+
+  const int want = (max * spec_.backlight_pct + 50) / 100;
+  if (want >= cur) return;  // already dimmer than the idle level
+  if (write_int(dir_, "brightness", want)) saved_ = cur;
+}
+
+void Backlight::restore() {
+  if (saved_ < 0) return;
+  write_int(dir_, "brightness", saved_);
+  saved_ = -1;
+}
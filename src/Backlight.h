@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "Icons.h"
+
+// Idle dimming of the panel backlight. The device is shared by every
+// window, so MainApp dims it only once all of them are asleep and restores
+// it when the first one wakes.
+class Backlight {
+public:
+  Backlight() = default;
+  ~Backlight();
+
+  Backlight(const Backlight&) = delete;
+  Backlight& operator=(const Backlight&) = delete;
+
+  // Restores first if dimmed under the previous spec.
+  void configure(const IdleSpec& spec);
+
+  // To IdleSpec::backlight_pct, unless already dimmer; remembers the level.
+  void dim();
+  void restore();
+
+private:
+  IdleSpec spec_;
+  std::string dir_;       // resolved when dimming
+  int saved_ = -1;        // brightness before dim(), -1 = not dimmed
+};
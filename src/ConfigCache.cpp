@@ -0,0 +1,348 @@
+#include "ConfigCache.h"
+#include "RuntimeEnv.h"
+#include "Trace.h"
+#include "fa_glyphs.h"
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[4] = { 'S', 'V', 'D', 'C' };
+
+struct Header {
+  char     magic[4];
+  uint32_t version;
+  uint32_t endian;     // 0x01020304 as written by this host
+  uint32_t reserved;
+  int64_t  src_mtime;
+  uint64_t src_size;
+  uint64_t src_hash;
+  uint64_t payload_size;
+  uint64_t glyph_table;  // fa_glyphs::kTableHash the codepoints were resolved with
+};
+
+constexpr uint32_t kEndian = 0x01020304;
+
+uint64_t fnv1a(const char* data, std::size_t len, uint64_t h = 1469598103934665603ULL) {
+  for (std::size_t i = 0; i < len; ++i) {
+    h ^= (unsigned char)data[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+bool hash_file(const std::string& path, uint64_t& out) {
+  GMappedFile* mf = g_mapped_file_new(path.c_str(), FALSE, nullptr);
+  if (!mf) return false;
+  out = fnv1a(g_mapped_file_get_contents(mf), g_mapped_file_get_length(mf));
+  g_mapped_file_unref(mf);
+  return true;
+}
+
+bool stat_file(const std::string& path, int64_t& mtime, uint64_t& size) {
+  GStatBuf st;
+  if (g_stat(path.c_str(), &st) != 0) return false;
+  mtime = (int64_t)st.st_mtime;
+  size = (uint64_t)st.st_size;
+  return true;
+}
+
+// ---- encoding ----
+
+class Writer {
+public:
+  void u8(uint8_t v) { buf_.push_back((char)v); }
+  void u32(uint32_t v) { buf_.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+  void str(const std::string& s) { u32((uint32_t)s.size()); buf_.append(s); }
+  const std::string& data() const { return buf_; }
+
+private:
+  std::string buf_;
+};
+
+class Reader {
+public:
+  Reader(const char* p, std::size_t n) : p_(p), end_(p + n) {}
+
+  bool u8(uint8_t& v) {
+    if (end_ - p_ < 1) return false;
+    v = (uint8_t)*p_++;
+    return true;
+  }
+  bool u32(uint32_t& v) {
+    if (end_ - p_ < (std::ptrdiff_t)sizeof(v)) return false;
+    std::memcpy(&v, p_, sizeof(v));
+    p_ += sizeof(v);
+    return true;
+  }
+  bool str(std::string& s) {
+    uint32_t n = 0;
+    if (!u32(n) || (std::size_t)(end_ - p_) < n) return false;
+    s.assign(p_, n);
+    p_ += n;
+    return true;
+  }
+  bool at_end() const { return p_ == end_; }
+  // n more entries of at least 4 bytes each could still follow. Checked
+  // before every resize(), so a corrupt count fails the decode instead of
+  // throwing bad_alloc.
+  bool fits(uint32_t n) const { return (std::size_t)(end_ - p_) / 4 >= n; }
+
+private:
+  const char* p_;
+  const char* end_;
+};
+
+void write_page(Writer& w, const std::vector<IconSpec>& page) {
+  w.u32((uint32_t)page.size());
+  for (const auto& s : page) {
+    w.u32((uint32_t)s.codepoint);
+    w.u8((uint8_t)s.style);
+    w.str(s.label);
+    w.str(s.colorClass);
+    w.str(s.command);
+    w.u32((uint32_t)s.args.size());
+    for (const auto& a : s.args) w.str(a);
+    w.u32((uint32_t)s.prewarm.size());
+    for (const auto& a : s.prewarm) w.str(a);
+    w.u32((uint32_t)s.budget.cpu_pct);
+    w.u32((uint32_t)s.budget.rss_mb);
+    w.str(s.name);
+  }
+}
+
+bool read_page(Reader& r, std::vector<IconSpec>& page) {
+  uint32_t n = 0;
+  if (!r.u32(n) || !r.fits(n)) return false;
+  page.resize(n);
+  for (auto& s : page) {
+    uint32_t cp = 0, nargs = 0;
+    uint8_t style = 0;
+    if (!r.u32(cp) || !r.u8(style) || !r.str(s.label) || !r.str(s.colorClass) ||
+        !r.str(s.command) || !r.u32(nargs) || !r.fits(nargs)) return false;
+    s.codepoint = (char32_t)cp;
+    if (style > (uint8_t)FaStyle::Brands) return false;
+    s.style = (FaStyle)style;
+    s.args.resize(nargs);
+    for (auto& a : s.args) if (!r.str(a)) return false;
+    uint32_t nwarm = 0;
+    if (!r.u32(nwarm) || !r.fits(nwarm)) return false;
+    s.prewarm.resize(nwarm);
+    for (auto& a : s.prewarm) if (!r.str(a)) return false;
+    uint32_t cpu = 0, rss = 0;
+    if (!r.u32(cpu) || !r.u32(rss)) return false;
+    s.budget = { (int)cpu, (int)rss };
+    if (!r.str(s.name)) return false;
+  }
+  return true;
+}
+
+void write_steps(Writer& w, const std::vector<LaunchStep>& steps) {
+  w.u32((uint32_t)steps.size());
+  for (const auto& step : steps) {
+    w.str(step.tile);
+    w.u32((uint32_t)step.after.size());
+    for (const auto& a : step.after) w.str(a);
+  }
+}
+
+bool read_steps(Reader& r, std::vector<LaunchStep>& steps) {
+  uint32_t n = 0;
+  if (!r.u32(n) || !r.fits(n)) return false;
+  steps.resize(n);
+  for (auto& step : steps) {
+    uint32_t nafter = 0;
+    if (!r.str(step.tile) || !r.u32(nafter) || !r.fits(nafter)) return false;
+    step.after.resize(nafter);
+    for (auto& a : step.after) if (!r.str(a)) return false;
+  }
+  return true;
+}
+
+std::string encode(const IconConfig& cfg) {
+  Writer w;
+  w.u32((uint32_t)cfg.cols);
+  w.u32((uint32_t)cfg.rows);
+  w.u32((uint32_t)cfg.pages.size());
+  for (const auto& page : cfg.pages) write_page(w, page);
+
+  w.u32((uint32_t)cfg.palette.size());
+  for (const auto& [cls, color] : cfg.palette) {
+    w.str(cls);
+    w.str(color);
+  }
+
+  w.u32((uint32_t)cfg.schemes.size());
+  for (const auto& s : cfg.schemes) {
+    w.str(s.name);
+    w.str(s.labelColor);
+    w.str(s.iconColor);
+    w.str(s.iconBackground);
+  }
+
+  w.u32((uint32_t)cfg.idle.after_s);
+  w.u8(cfg.idle.night ? 1 : 0);
+  w.u32((uint32_t)cfg.idle.backlight_pct);
+  w.str(cfg.idle.backlight);
+  write_steps(w, cfg.autostart);
+  w.u32((uint32_t)cfg.scenes.size());
+  for (const auto& scene : cfg.scenes) {
+    w.str(scene.name);
+    write_steps(w, scene.steps);
+  }
+  w.u32((uint32_t)cfg.launch_parallel);
+  return w.data();
+}
+
+bool decode(const char* p, std::size_t n, IconConfig& cfg) {
+  Reader r(p, n);
+  uint32_t cols = 0, rows = 0, npages = 0;
+  if (!r.u32(cols) || !r.u32(rows) || !r.u32(npages) || !r.fits(npages)) return false;
+  if (cols < 1 || cols > (uint32_t)kMaxGrid || rows < 1 || rows > (uint32_t)kMaxGrid) return false;
+  cfg.cols = (int)cols;
+  cfg.rows = (int)rows;
+  cfg.pages.resize(npages);
+  for (auto& page : cfg.pages) {
+    if (!read_page(r, page)) return false;
+  }
+
+  uint32_t np = 0;
+  if (!r.u32(np) || !r.fits(np)) return false;
+  cfg.palette.resize(np);
+  for (auto& [cls, color] : cfg.palette) {
+    if (!r.str(cls) || !r.str(color)) return false;
+  }
+
+  uint32_t ns = 0;
+  if (!r.u32(ns) || !r.fits(ns)) return false;
+  cfg.schemes.resize(ns);
+  for (auto& s : cfg.schemes) {
+    if (!r.str(s.name) || !r.str(s.labelColor) || !r.str(s.iconColor) || !r.str(s.iconBackground))
+      return false;
+  }
+
+  uint32_t after = 0, backlight = 0;
+  uint8_t night = 0;
+  if (!r.u32(after) || !r.u8(night) || !r.u32(backlight) || !r.str(cfg.idle.backlight)) return false;
+  cfg.idle.after_s = (int)after;
+  cfg.idle.night = night != 0;
+  cfg.idle.backlight_pct = (int)backlight;
+
+  uint32_t nscenes = 0, parallel = 0;
+  if (!read_steps(r, cfg.autostart) || !r.u32(nscenes) || !r.fits(nscenes)) return false;
+  cfg.scenes.resize(nscenes);
+  for (auto& scene : cfg.scenes) {
+    if (!r.str(scene.name) || !read_steps(r, scene.steps)) return false;
+  }
+  if (!r.u32(parallel) || parallel < 1 || parallel > (uint32_t)kMaxParallelLaunches) return false;
+  cfg.launch_parallel = (int)parallel;
+  return r.at_end();
+}
+
+void write_snapshot(const std::string& path, Header h, const std::string& payload) {
+  h.payload_size = payload.size();
+  std::string out(reinterpret_cast<const char*>(&h), sizeof(h));
+  out += payload;
+
+  gchar* dir = g_path_get_dirname(path.c_str());
+  RuntimeEnv::ensureDir(dir);
+  g_free(dir);
+
+  GError* error = nullptr;
+  if (!g_file_set_contents(path.c_str(), out.data(), (gssize)out.size(), &error)) {
+    g_warning("ConfigCache: cannot write %s: %s", path.c_str(), error ? error->message : "?");
+    if (error) g_error_free(error);
+  }
+}
+
+} // namespace
+
+namespace ConfigCache {
+
+std::string cache_path_for(const std::string& source) {
+  char name[48];
+  g_snprintf(name, sizeof(name), "config-%016" G_GINT64_MODIFIER "x.bin",
+             (guint64)fnv1a(source.data(), source.size()));
+
+  gchar* p = g_build_filename(g_get_user_cache_dir(), "sv-dashboard-gtk", name, nullptr);
+  std::string out = p ? p : "";
+  g_free(p);
+  return out;
+}
+
+bool load(const std::string& source, IconConfig& out) {
+  SV_TRACE_SCOPE("ConfigCache::load");
+
+  int64_t mtime = 0;
+  uint64_t size = 0;
+  if (!stat_file(source, mtime, size)) return false;
+
+  const std::string path = cache_path_for(source);
+  GMappedFile* mf = g_mapped_file_new(path.c_str(), FALSE, nullptr);
+  if (!mf) return false;
+
+  const char* data = g_mapped_file_get_contents(mf);
+  const std::size_t len = g_mapped_file_get_length(mf);
+
+  Header h{};
+  bool ok = len >= sizeof(h);
+  if (ok) {
+    std::memcpy(&h, data, sizeof(h));
+    ok = std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 && h.version == kVersion &&
+         h.endian == kEndian && h.glyph_table == fa_glyphs::kTableHash &&
+         h.payload_size == len - sizeof(h);
+  }
+
+  bool touched = false;
+  if (ok && (h.src_mtime != mtime || h.src_size != size)) {
+    // Source was touched; only a content change invalidates the snapshot.
+    uint64_t hash = 0;
+    ok = h.src_size == size && hash_file(source, hash) && hash == h.src_hash;
+    touched = ok;
+  }
+
+  if (ok) {
+    IconConfig cfg;
+    ok = decode(data + sizeof(h), (std::size_t)h.payload_size, cfg);
+    if (ok) out = std::move(cfg);
+  }
+
+  std::string payload;
+  if (ok && touched) payload.assign(data + sizeof(h), (std::size_t)h.payload_size);
+
+  // Unmap before rewriting (Windows can't replace a mapped file).
+  g_mapped_file_unref(mf);
+
+  if (ok && touched) {
+    h.src_mtime = mtime;
+    write_snapshot(path, h, payload);
+  }
+  return ok;
+}
+
+GMappedFile* map_source(const std::string& path, Source& src) {
+  if (!stat_file(path, src.mtime, src.size)) return nullptr;
+  GMappedFile* mf = g_mapped_file_new(path.c_str(), FALSE, nullptr);
+  if (!mf) return nullptr;
+  src.size = g_mapped_file_get_length(mf);
+  src.hash = fnv1a(g_mapped_file_get_contents(mf), src.size);
+  return mf;
+}
+
+void store(const std::string& source, const Source& src, const IconConfig& cfg) {
+  Header h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kVersion;
+  h.endian = kEndian;
+  h.glyph_table = fa_glyphs::kTableHash;
+  h.src_mtime = src.mtime;
+  h.src_size = src.size;
+  h.src_hash = src.hash;
+  write_snapshot(cache_path_for(source), h, encode(cfg));
+}
+
+} // namespace ConfigCache
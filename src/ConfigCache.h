@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glib.h>
+
+#include <cstdint>
+#include <string>
+
+#include "Icons.h"
+
+// Compiled icons.json snapshot under $XDG_CACHE_HOME/sv-dashboard-gtk/.
+// The snapshot is keyed by source path, mtime, size and a content hash.
+// On a hit the file is mmapped and decoded directly, with no JSON parse and
+// no glyph/palette resolution. A touched but unchanged source (same hash) is
+// still a hit. Any change to IconConfig or its resolution rules must bump
+// kVersion; the generated glyph table is checked by its hash, since a
+// rebuild can change it (fonts fetched, Font Awesome upgraded).
+namespace ConfigCache {
+
+inline constexpr unsigned kVersion = 11;
+
+std::string cache_path_for(const std::string& source);
+
+// What a parse read: the stat taken before reading, and the bytes' size and
+// hash. A save racing the parse then leaves a snapshot that no longer
+// matches the file, instead of one stamped with the newer file's hash.
+struct Source {
+  int64_t mtime = 0;
+  uint64_t size = 0;
+  uint64_t hash = 0;
+};
+
+// Stats `path`, then maps it and hashes the mapping; parse from the
+// returned file (g_mapped_file_unref it) so `src` matches what was parsed.
+// Null if either fails.
+GMappedFile* map_source(const std::string& path, Source& src);
+
+// True and `out` filled if a valid snapshot for `source` exists.
+bool load(const std::string& source, IconConfig& out);
+
+// `cfg` was parsed from the bytes described by `src`. Best effort; failures
+// only cost the next start a JSON parse.
+void store(const std::string& source, const Source& src, const IconConfig& cfg);
+
+} // namespace ConfigCache
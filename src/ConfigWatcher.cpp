@@ -0,0 +1,94 @@
+#include "ConfigWatcher.h"
+#include "Trace.h"
+
+#include <glibmm/main.h>
+#include <glib.h>
+
+#include <utility>
+
+ConfigWatcher::~ConfigWatcher() {
+  debounce_.disconnect();
+  if (monitor_) monitor_->cancel();
+  if (worker_.joinable()) worker_.join();
+}
+
+void ConfigWatcher::start(const IconConfig& current) {
+  if (monitor_) return;
+  current_ = current;
+
+  const std::string path = icon_config_path();
+  try {
+    monitor_ = Gio::File::create_for_path(path)->monitor_file();
+  } catch (const Glib::Error& e) {
+    g_warning("Config watch disabled for %s: %s", path.c_str(), e.what().c_str());
+    return;
+  }
+
+  monitor_->signal_changed().connect(sigc::mem_fun(*this, &ConfigWatcher::on_file_changed));
+  parsed_.connect(sigc::mem_fun(*this, &ConfigWatcher::on_parsed));
+}
+
+void ConfigWatcher::on_file_changed(const Glib::RefPtr<Gio::File>&,
+                                    const Glib::RefPtr<Gio::File>&,
+                                    Gio::FileMonitorEvent event) {
+  switch (event) {
+    case Gio::FILE_MONITOR_EVENT_CHANGED:
+    case Gio::FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+    case Gio::FILE_MONITOR_EVENT_CREATED:
+    case Gio::FILE_MONITOR_EVENT_MOVED_IN:
+    case Gio::FILE_MONITOR_EVENT_RENAMED:
+      break;
+    default:
+      return;  // deleted/attributes: keep what is on screen
+  }
+
+  // Restart the quiet period on every event.
+  debounce_.disconnect();
+  debounce_ = Glib::signal_timeout().connect(
+      sigc::mem_fun(*this, &ConfigWatcher::on_debounce), kDebounceMs);
+}
+
+bool ConfigWatcher::on_debounce() {
+  if (busy_) again_ = true;
+  else       start_parse();
+  return false;
+}
+
+void ConfigWatcher::start_parse() {
+  if (worker_.joinable()) worker_.join();  // previous run already delivered
+  busy_ = true;
+  again_ = false;
+
+  worker_ = std::thread([this] {
+    IconConfig cfg;
+    const bool ok = reload_icon_config(cfg);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      result_ok_ = ok;
+      result_ = std::move(cfg);
+    }
+    parsed_.emit();
+  });
+}
+
+void ConfigWatcher::on_parsed() {
+  IconConfig cfg;
+  bool ok = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ok = result_ok_;
+    cfg = std::move(result_);
+  }
+  busy_ = false;
+
+  if (!ok) {
+    g_warning("Config reload failed for %s; keeping the current layout",
+              icon_config_path().c_str());
+  } else if (!(cfg == current_)) {
+    SV_TRACE_SCOPE("ConfigWatcher: apply");
+    current_ = std::move(cfg);
+    reloaded_.emit(current_);
+  }
+
+  if (again_) start_parse();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <giomm/file.h>
+#include <giomm/filemonitor.h>
+#include <glibmm/dispatcher.h>
+#include <sigc++/signal.h>
+
+#include <mutex>
+#include <thread>
+
+#include "Icons.h"
+
+// Watches icon_config_path() and re-parses it off the main thread. Bursts of
+// monitor events (editors writing, renaming, touching) are coalesced; an
+// invalid or deleted file is ignored so the running layout stays up.
+// signal_reloaded() fires on the main thread only when the parsed config
+// differs from the last one delivered.
+class ConfigWatcher {
+public:
+  ConfigWatcher() = default;
+  ~ConfigWatcher();
+
+  ConfigWatcher(const ConfigWatcher&) = delete;
+  ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+  // `current` is the config already on screen (the baseline for diffing).
+  void start(const IconConfig& current);
+
+  sigc::signal<void(const IconConfig&)>& signal_reloaded() { return reloaded_; }
+
+private:
+  void on_file_changed(const Glib::RefPtr<Gio::File>& file,
+                       const Glib::RefPtr<Gio::File>& other,
+                       Gio::FileMonitorEvent event);
+  bool on_debounce();
+  void start_parse();
+  void on_parsed();
+
+  static constexpr unsigned kDebounceMs = 250;
+
+  Glib::RefPtr<Gio::FileMonitor> monitor_;
+  sigc::connection debounce_;
+  Glib::Dispatcher parsed_;
+  sigc::signal<void(const IconConfig&)> reloaded_;
+
+  std::thread worker_;
+  bool busy_ = false;     // worker running (main thread only)
+  bool again_ = false;    // change seen while busy
+
+  std::mutex mutex_;
+  bool result_ok_ = false;
+  IconConfig result_;     // guarded by mutex_
+
+  IconConfig current_;
+};
@@ -0,0 +1,255 @@
+#include "ControlServer.h"
+#include "Trace.h"
+
+#ifndef _WIN32
+  #include <glib-unix.h>
+  #include <glib/gstdio.h>
+  #include <sys/socket.h>
+  #include <sys/un.h>
+  #include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+  return s;
+}
+
+std::string_view next_word(std::string_view& s) {
+  s = trim(s);
+  const std::size_t end = std::min(s.find_first_of(" \t"), s.size());
+  std::string_view w = s.substr(0, end);
+  s = trim(s.substr(end));
+  return w;
+}
+
+#ifndef _WIN32
+std::string socket_path() {
+  const char* env = g_getenv("SV_DASHBOARD_CONTROL");
+  if (env && *env) return env;
+  gchar* dir = g_build_filename(g_get_user_runtime_dir(), "sv-dashboard-gtk", nullptr);
+  g_mkdir_with_parents(dir, 0700);
+  gchar* path = g_build_filename(dir, "control", nullptr);
+  std::string out = path;
+  g_free(path);
+  g_free(dir);
+  return out;
+}
+#endif
+
+} // namespace
+
+ControlCommand ControlServer::parse(std::string_view line) {
+  ControlCommand cmd;
+  std::string_view rest = line;
+  std::string_view verb = next_word(rest);
+
+  if (verb.size() > 1 && verb.front() == '@') {
+    char* end = nullptr;
+    const std::string n(verb.substr(1));
+    const long w = std::strtol(n.c_str(), &end, 10);
+    if (*end || w < 1) return cmd;
+    cmd.window = (int)w - 1;
+    verb = next_word(rest);
+  }
+
+  using Verb = ControlCommand::Verb;
+  if (verb == "ping") cmd.verb = Verb::Ping;
+  else if (verb == "status") cmd.verb = Verb::Status;
+  else if (verb == "wake") cmd.verb = Verb::Wake;
+  else if (verb == "scheme") cmd.verb = Verb::Scheme;
+  else if (verb == "page") cmd.verb = Verb::Page;
+  else if (verb == "launch") cmd.verb = Verb::Launch;
+  else if (verb == "scene") cmd.verb = Verb::Scene;
+  else return cmd;
+
+  cmd.arg = std::string(rest);
+  const bool wants_arg = cmd.verb != Verb::Ping && cmd.verb != Verb::Status && cmd.verb != Verb::Wake;
+  if (wants_arg == cmd.arg.empty()) cmd.verb = Verb::Invalid;
+  return cmd;
+}
+
+ControlServer::~ControlServer() {
+  stop();
+}
+
+#ifdef _WIN32
+
+bool ControlServer::start(Handler) {
+  return false;
+}
+
+void ControlServer::stop() {}
+
+#else
+
+bool ControlServer::start(Handler handler) {
+  if (listen_fd_ >= 0) return true;
+  const char* env = g_getenv("SV_DASHBOARD_CONTROL");
+  if (env && std::strcmp(env, "off") == 0) return false;
+  SV_TRACE_SCOPE("ControlServer::start");
+
+  path_ = socket_path();
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path_.size() >= sizeof(addr.sun_path)) {
+    g_warning("ControlServer: socket path too long: %s", path_.c_str());
+    return false;
+  }
+  std::memcpy(addr.sun_path, path_.c_str(), path_.size() + 1);
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+
+  bool bound = bind(fd, (sockaddr*)&addr, sizeof(addr)) == 0;
+  if (!bound && errno == EADDRINUSE) {
+    // Left behind by a crash unless something still answers on it.
+    const int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const bool live = probe >= 0 && connect(probe, (sockaddr*)&addr, sizeof(addr)) == 0;
+    if (probe >= 0) close(probe);
+    if (live) {
+      g_warning("ControlServer: %s is in use by another process", path_.c_str());
+      close(fd);
+      return false;
+    }
+    g_unlink(path_.c_str());
+    bound = bind(fd, (sockaddr*)&addr, sizeof(addr)) == 0;
+  }
+  if (!bound || listen(fd, 8) != 0) {
+    g_warning("ControlServer: cannot listen on %s: %s", path_.c_str(), g_strerror(errno));
+    close(fd);
+    return false;
+  }
+
+  handler_ = std::move(handler);
+  listen_fd_ = fd;
+  listen_source_ = g_unix_fd_add(fd, G_IO_IN, &ControlServer::on_accept, this);
+  g_debug("ControlServer: listening on %s", path_.c_str());
+  return true;
+}
+
+void ControlServer::stop() {
+  while (!clients_.empty()) drop(clients_.begin()->first);
+  if (listen_source_) g_source_remove(listen_source_);
+  listen_source_ = 0;
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+    g_unlink(path_.c_str());
+  }
+  listen_fd_ = -1;
+}
+
+gboolean ControlServer::on_accept(gint fd, GIOCondition, gpointer self) {
+  auto* s = static_cast<ControlServer*>(self);
+  for (;;) {
+    const int c = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (c < 0) break;  // EAGAIN: drained
+    if (s->clients_.size() >= kMaxClients) {
+      static const char busy[] = "err busy\n";
+      (void)!send(c, busy, sizeof(busy) - 1, MSG_NOSIGNAL);
+      close(c);
+      continue;
+    }
+    Client& client = s->clients_[c];
+    client.in_source = g_unix_fd_add(c, G_IO_IN, &ControlServer::on_readable, s);
+  }
+  return G_SOURCE_CONTINUE;
+}
+
+gboolean ControlServer::on_readable(gint fd, GIOCondition, gpointer self) {
+  auto* s = static_cast<ControlServer*>(self);
+  auto it = s->clients_.find(fd);
+  if (it == s->clients_.end()) return G_SOURCE_REMOVE;
+  if (s->serve(fd, it->second)) return G_SOURCE_CONTINUE;
+  return G_SOURCE_REMOVE;  // drop() already forgot the source id
+}
+
+gboolean ControlServer::on_writable(gint fd, GIOCondition, gpointer self) {
+  auto* s = static_cast<ControlServer*>(self);
+  auto it = s->clients_.find(fd);
+  if (it == s->clients_.end()) return G_SOURCE_REMOVE;
+  Client& c = it->second;
+  if (!s->flush(fd, c)) return G_SOURCE_REMOVE;  // dropped
+  if (!c.out.empty()) return G_SOURCE_CONTINUE;
+  c.out_source = 0;
+  return G_SOURCE_REMOVE;
+}
+
+bool ControlServer::serve(int fd, Client& c) {
+  char buf[4096];
+  std::size_t budget = kReadBudget;
+  bool eof = false;
+  while (budget > 0) {
+    const ssize_t n = recv(fd, buf, std::min(sizeof(buf), budget), 0);
+    if (n > 0) {
+      c.in.append(buf, (std::size_t)n);
+      budget -= (std::size_t)n;
+      continue;
+    }
+    if (n == 0) eof = true;
+    else if (errno == EINTR) continue;
+    else if (errno != EAGAIN && errno != EWOULDBLOCK) eof = true;
+    break;
+  }
+
+  std::size_t start = 0;
+  for (std::size_t nl; (nl = c.in.find('\n', start)) != std::string::npos; start = nl + 1) {
+    const std::string_view line(c.in.data() + start, nl - start);
+    if (trim(line).empty()) continue;
+    const ControlCommand cmd = parse(line);
+    c.out += cmd.verb == ControlCommand::Verb::Invalid ? std::string("err bad command") : handler_(cmd);
+    c.out += '\n';
+  }
+  c.in.erase(0, start);
+
+  if (c.in.size() > kMaxLine) {
+    c.out += "err line too long\n";
+    eof = true;
+  }
+  if (!flush(fd, c)) return false;
+  if (eof) {
+    drop(fd);  // whatever is still unsent is lost with the peer
+    return false;
+  }
+  return true;
+}
+
+bool ControlServer::flush(int fd, Client& c) {
+  while (!c.out.empty()) {
+    const ssize_t n = send(fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+    if (n > 0) {
+      c.out.erase(0, (std::size_t)n);
+      continue;
+    }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+    drop(fd);
+    return false;
+  }
+  if (c.out.size() > kMaxPendingOut) {
+    // Not reading its replies; don't buffer for it forever.
+    drop(fd);
+    return false;
+  }
+  if (!c.out.empty() && !c.out_source) {
+    c.out_source = g_unix_fd_add(fd, G_IO_OUT, &ControlServer::on_writable, this);
+  }
+  return true;
+}
+
+void ControlServer::drop(int fd) {
+  auto it = clients_.find(fd);
+  if (it == clients_.end()) return;
+  if (it->second.in_source) g_source_remove(it->second.in_source);
+  if (it->second.out_source) g_source_remove(it->second.out_source);
+  clients_.erase(it);
+  close(fd);
+}
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <glib.h>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// A parsed control line; see ControlServer for the protocol.
+struct ControlCommand {
+  enum class Verb { Invalid, Ping, Status, Scheme, Page, Launch, Scene, Wake };
+
+  Verb verb = Verb::Invalid;
+  int window = -1;   // "@N" prefix, 0-based; -1 = every window
+  std::string arg;   // scheme name, page number/next/prev, tile key, scene name
+};
+
+// Unix-domain control socket for other processes aboard (sunset timer,
+// alarm daemon, rotary encoder), serviced by GSources on the main context.
+// Commands run synchronously in the dispatch that read them, so the reply
+// goes out before the frame they cause is drawn.
+//
+// Line protocol, one command per '\n'-terminated line, one reply line each:
+//   ping                       -> ok
+//   status                     -> ok scheme=<name> page=<n>/<count> sleeping=<0|1>
+//   scheme <name>              -> ok | err ...
+//   page <n>|next|prev         -> ok <n>       (1-based; wakes the window)
+//   launch <tile>              -> ok | err ... (Launcher::find_tile)
+//   scene <name>               -> ok | err ... (queued with LaunchScheduler)
+//   wake                       -> ok
+// "@N " in front addresses window N (1-based, monitor order) only.
+//
+// Socket: $SV_DASHBOARD_CONTROL, else $XDG_RUNTIME_DIR/sv-dashboard-gtk/control
+// (directory 0700). SV_DASHBOARD_CONTROL=off disables it. Unix only.
+class ControlServer {
+public:
+  // Reply without the trailing newline. Must not stop() the server.
+  using Handler = std::function<std::string(const ControlCommand&)>;
+
+  ControlServer() = default;
+  ~ControlServer();
+
+  ControlServer(const ControlServer&) = delete;
+  ControlServer& operator=(const ControlServer&) = delete;
+
+  // False if disabled or the socket could not be bound.
+  bool start(Handler handler);
+  void stop();
+  const std::string& path() const { return path_; }
+
+  static ControlCommand parse(std::string_view line);
+
+private:
+  struct Client {
+    std::string in;
+    std::string out;    // unsent replies
+    guint in_source = 0;
+    guint out_source = 0;
+  };
+
+  static gboolean on_accept(gint fd, GIOCondition cond, gpointer self);
+  static gboolean on_readable(gint fd, GIOCondition cond, gpointer self);
+  static gboolean on_writable(gint fd, GIOCondition cond, gpointer self);
+
+  // false: the client is gone (closed or misbehaving) and was dropped.
+  bool serve(int fd, Client& c);
+  bool flush(int fd, Client& c);
+  void drop(int fd);
+
+  static constexpr std::size_t kMaxClients = 16;
+  static constexpr std::size_t kMaxLine = 512;
+  static constexpr std::size_t kMaxPendingOut = 64 * 1024;
+  // Bytes read per dispatch, so one chatty client cannot hold up a frame.
+  static constexpr std::size_t kReadBudget = 16 * 1024;
+
+  Handler handler_;
+  std::string path_;
+  int listen_fd_ = -1;
+  guint listen_source_ = 0;
+  std::unordered_map<int, Client> clients_;
+};
@@ -1,108 +1,186 @@
 #include "Desktop.h"
 #include "DesktopIcon.h"
-
-#include <string>
-#include <utility>
-#include <cmath>
+#include "Launcher.h"
+#include "TileGrid.h"
+#include "Trace.h"
+#include "UiMetrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string_view>
 #include <vector>
 
-#include <glib.h>
-
 namespace {
 
-std::vector<std::string> build_command_argv(const IconSpec& spec) {
-  std::string cmd = spec.command;
-  std::vector<std::string> args = spec.args;
+std::string badge_text(const ResourceMonitor::Usage& u) {
+  char buf[32];
+  if (u.rss_mb >= 1024) std::snprintf(buf, sizeof(buf), "%d%% %.1fG", u.cpu_pct, u.rss_mb / 1024.0);
+  else std::snprintf(buf, sizeof(buf), "%d%% %dM", u.cpu_pct, u.rss_mb);
+  return buf;
+}
 
-  if (cmd == "onlyone") {
-    if (args.empty()) return {};
-    cmd = args.front();
-    args.erase(args.begin());
-  }
+bool over_budget(const Budget& b, const ResourceMonitor::Usage& u) {
+  return (b.cpu_pct > 0 && u.cpu_pct > b.cpu_pct) || (b.rss_mb > 0 && u.rss_mb > b.rss_mb);
+}
+
+} // namespace
 
-  if (cmd.empty()) return {};
+DesktopIcon* Desktop::add_tile(int i) {
+  const auto& spec = specs_.at(i);
+  auto* tile = Gtk::manage(new DesktopIcon(spec));
+  tile->set_color_class(spec.colorClass);
+  tile->signal_button_press_event().connect([this](GdkEventButton*) {
+    press_us_ = g_get_monotonic_time();
+    return false;
+  }, false);
+  tile->signal_clicked().connect([this, i] {
+    Launcher::launch(specs_[i], press_us_);
+    press_us_ = 0;
+  });
+  tiles_.push_back(tile);
+
+  grid_.attach(*tile, i % cols_, i / cols_, 1, 1);
+  return tile;
+}
+
+void Desktop::set_tile(int i) {
+  if (i == (int)keys_.size()) keys_.push_back({});
+  keys_[i] = Launcher::tile_key(specs_[i]);
 
-  std::vector<std::string> argv;
-  argv.reserve(1 + args.size());
-  argv.push_back(cmd);
-  argv.insert(argv.end(), args.begin(), args.end());
-  return argv;
+  if (canvas_) canvas_->set_tile(i, specs_[i]);
+  else if (i < (int)tiles_.size()) tiles_[i]->set_spec(specs_[i]);
+  else add_tile(i);
+  apply_badge(i);
 }
 
-void launch_command(const IconSpec& spec) {
-  auto argv_strings = build_command_argv(spec);
-  if (argv_strings.empty()) return;
+Desktop::Renderer Desktop::default_renderer() {
+  static const Renderer r = [] {
+    const char* env = g_getenv("SV_DASHBOARD_RENDERER");
+    return (env && std::string_view(env) == "widgets") ? Renderer::Widgets : Renderer::Grid;
+  }();
+  return r;
+}
 
-  std::vector<char*> argv;
-  argv.reserve(argv_strings.size() + 1);
-  for (auto& arg : argv_strings) {
-    argv.push_back(const_cast<char*>(arg.c_str()));
+Desktop::Desktop(const std::vector<IconSpec>& icons, int cols, Renderer renderer)
+: Gtk::Box(Gtk::ORIENTATION_VERTICAL),
+  cols_(std::max(1, cols)),
+  specs_(icons)
+{
+  SV_TRACE_SCOPE("Desktop::Desktop");
+
+  keys_.reserve(icons.size());
+
+  if (renderer == Renderer::Grid) {
+    canvas_ = Gtk::manage(new TileGrid(cols_));
+    canvas_->signal_activated().connect([this](int i, int64_t press_us) {
+      Launcher::launch(specs_[i], press_us);
+    });
+    pack_start(*canvas_, Gtk::PACK_EXPAND_WIDGET);
+  } else {
+    grid_.set_row_homogeneous(true);
+    grid_.set_column_homogeneous(true);
+    grid_.set_halign(Gtk::ALIGN_CENTER);
+    grid_.set_valign(Gtk::ALIGN_CENTER);
+    tiles_.reserve(icons.size());
+    pack_start(grid_, Gtk::PACK_EXPAND_WIDGET);
   }
-  argv.push_back(nullptr);
-
-  GError* error = nullptr;
-  g_spawn_async(nullptr,
-                argv.data(),
-                nullptr,
-                G_SPAWN_SEARCH_PATH,
-                nullptr,
-                nullptr,
-                nullptr,
-                &error);
-  if (error) {
-    g_warning("Failed to launch command: %s", error->message);
-    g_error_free(error);
+
+  for (int i = 0; i < (int)specs_.size(); ++i) set_tile(i);
+
+  set_ui_metrics(UiScale::metrics_for(1.0), true);
+
+  // Desktop is trackable: the slots go away with the page.
+  ResourceMonitor::instance().signal_changed().connect(sigc::mem_fun(*this, &Desktop::on_usage));
+  StatusFeed::instance().signal_changed().connect(sigc::mem_fun(*this, &Desktop::on_status));
+}
+
+void Desktop::show_badge(int i, const std::string& text, bool over) {
+  if (canvas_) canvas_->set_badge(i, text, over);
+  else tiles_[i]->set_badge(text, over);
+}
+
+void Desktop::apply_badge(int i) {
+  StatusFeed::Status st;
+  ResourceMonitor::Usage u;
+  if (StatusFeed::instance().status(keys_[i], st)) {
+    show_badge(i, st.text, st.alarm);
+  } else if (ResourceMonitor::instance().usage(keys_[i], u)) {
+    show_badge(i, badge_text(u), over_budget(specs_[i].budget, u));
+  } else {
+    show_badge(i, {}, false);
   }
 }
 
-} // namespace
+// apply_badge() reads the monitor's current value, so a status feed value
+// for the tile keeps precedence.
+void Desktop::on_usage(const std::string& tile, bool, const ResourceMonitor::Usage&) {
+  on_status(tile);
+}
 
-Desktop::Desktop(const std::vector<IconSpec>& icons)
-: Gtk::Box(Gtk::ORIENTATION_VERTICAL)
-{
-  grid_.set_row_homogeneous(true);
-  grid_.set_column_homogeneous(true);
-  grid_.set_halign(Gtk::ALIGN_CENTER);
-  grid_.set_valign(Gtk::ALIGN_CENTER);
+// Only the tiles with this key are redrawn.
+void Desktop::on_status(const std::string& tile) {
+  for (int i = 0; i < (int)keys_.size(); ++i) {
+    if (keys_[i] == tile) apply_badge(i);
+  }
+}
 
-  tiles_.reserve(icons.size());
+int Desktop::update(const std::vector<IconSpec>& icons) {
+  SV_TRACE_SCOPE("Desktop::update");
 
-  for (int i = 0; i < (int)icons.size(); ++i) {
-    const int r = i / kCols;
-    const int c = i % kCols;
+  const int keep = (int)std::min(icons.size(), specs_.size());
+  int touched = 0;
 
-    const auto& spec = icons.at(i);
-    auto* tile = Gtk::manage(new DesktopIcon(spec));
-    tile->set_color_class(spec.colorClass);
-    tile->signal_clicked().connect([spec] { launch_command(spec); });
-    tiles_.push_back(tile);
+  for (int i = 0; i < keep; ++i) {
+    if (icons[i] == specs_[i]) continue;
+    specs_[i] = icons[i];
+    set_tile(i);
+    ++touched;
+  }
 
-    grid_.attach(*tile, c, r, 1, 1);
+  if (specs_.size() > icons.size()) {
+    touched += (int)(specs_.size() - icons.size());
+    specs_.resize(icons.size());
+    keys_.resize(icons.size());
+    if (canvas_) canvas_->truncate((int)icons.size());
+  }
+  // Managed widgets may still be deleted explicitly; the dtor unparents them.
+  while (tiles_.size() > icons.size()) {
+    delete tiles_.back();
+    tiles_.pop_back();
   }
 
-  pack_start(grid_, Gtk::PACK_EXPAND_WIDGET);
+  for (int i = (int)specs_.size(); i < (int)icons.size(); ++i) {
+    specs_.push_back(icons[i]);
+    set_tile(i);
+    if (!canvas_) {
+      if (metrics_) tiles_[i]->set_ui_metrics(*metrics_, show_labels_);
+      tiles_[i]->show();
+    }
+    ++touched;
+  }
 
-  set_ui_scale(1.0, true);
+  return touched;
 }
 
-void Desktop::apply_layout(double s) {
-  const int m = std::max(2, (int)std::lround(kMarginBase * s));
-  set_margin_start(m);
-  set_margin_end(m);
-  set_margin_top(m);
-  set_margin_bottom(m);
+void Desktop::apply_layout(const UiMetrics& m) {
+  set_margin_start(m.page_margin);
+  set_margin_end(m.page_margin);
+  set_margin_top(m.page_margin);
+  set_margin_bottom(m.page_margin);
 
-  grid_.set_row_spacing(std::max(0, (int)std::lround(kRowSpacingBase * s)));
-  grid_.set_column_spacing(std::max(0, (int)std::lround(kColSpacingBase * s)));
+  grid_.set_row_spacing(m.row_spacing);
+  grid_.set_column_spacing(m.col_spacing);
 }
 
-void Desktop::set_ui_scale(double s, bool show_labels) {
-  ui_scale_ = s;
-  show_labels_ = show_labels;
+void Desktop::set_ui_metrics(const UiMetrics& m, bool show_labels) {
+  if (&m == metrics_ && show_labels == show_labels_) return;
 
-  apply_layout(s);
+  if (&m != metrics_) apply_layout(m);
+  metrics_ = &m;
+  show_labels_ = show_labels;
 
+  if (canvas_) canvas_->set_ui_metrics(m, show_labels_);
   for (auto* t : tiles_) {
-    t->set_ui_scale(s, show_labels_);
+    t->set_ui_metrics(m, show_labels_);
   }
 }
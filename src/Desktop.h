@@ -2,28 +2,53 @@
 
 #include <gtkmm/box.h>
 #include <gtkmm/grid.h>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 #include "Icons.h"
+#include "ResourceMonitor.h"
+#include "StatusFeed.h"
 
 class DesktopIcon;
+class TileGrid;
+struct UiMetrics;
 
+// One page of tiles, drawn either by a single TileGrid widget or by a
+// Gtk::Grid of DesktopIcon widgets.
 class Desktop : public Gtk::Box {
 public:
-  explicit Desktop(const std::vector<IconSpec>& icons);
+  enum class Renderer { Grid, Widgets };
+  // Grid, unless SV_DASHBOARD_RENDERER=widgets.
+  static Renderer default_renderer();
 
-  void set_ui_scale(double s, bool show_labels);
+  explicit Desktop(const std::vector<IconSpec>& icons, int cols = kCols,
+                   Renderer renderer = default_renderer());
+
+  void set_ui_metrics(const UiMetrics& m, bool show_labels);
+
+  // Diffs against the current specs: changed tiles are updated in place,
+  // extra ones created, surplus ones destroyed. Returns tiles touched.
+  int update(const std::vector<IconSpec>& icons);
 
 private:
-  void apply_layout(double s);
+  void apply_layout(const UiMetrics& m);
+  DesktopIcon* add_tile(int i);
+  void set_tile(int i);  // specs_[i] -> tile widget/cell, creating it if new
+  void on_usage(const std::string& tile, bool running, const ResourceMonitor::Usage& u);
+  void on_status(const std::string& tile);
+  void apply_badge(int i);  // StatusFeed value, else resource usage
+  void show_badge(int i, const std::string& text, bool over);
 
   Gtk::Grid grid_;
-  std::vector<DesktopIcon*> tiles_;
-
-  double ui_scale_ = 1.0;
+  int cols_;
+  TileGrid* canvas_ = nullptr;       // single-widget renderer
+  std::vector<DesktopIcon*> tiles_;  // otherwise: one widget per tile
+  // Clicks read the spec by index, so command edits apply without rewiring.
+  std::vector<IconSpec> specs_;
+  std::vector<std::string> keys_;  // Launcher::tile_key per tile
+  int64_t press_us_ = 0;  // last tile press, for launch latency
+
+  const UiMetrics* metrics_ = nullptr;
   bool show_labels_ = true;
-
-  static constexpr int kMarginBase     = 40;
-  static constexpr int kRowSpacingBase = 30;
-  static constexpr int kColSpacingBase = 55;
 };
@@ -1,29 +1,16 @@
 #include "DesktopIcon.h"
-#include "FontRegistry.h"
+#include "AllocStats.h"
+#include "PerfStats.h"
+#include "TileCache.h"
+#include "TileRender.h"
+#include "Trace.h"
+#include "UiMetrics.h"
 
 #include <glib.h>
-#include <pango/pangocairo.h>
+#include <gtk/gtk.h>
 
-#include <cmath>
-
-// Under-icon label
-static constexpr int LABEL_PX_BASE = 20;
-static constexpr int SPACING_BASE  = 10;
-
-// Bigger square tile (scale=1)
-static constexpr int ICON_BOX_BASE = 120;
-
-// Smaller glyph inside square => visible padding.
-// 0.50 is a good starting point; lower => more padding.
-static constexpr double ICON_FRACTION = 0.42;
-
-Glib::ustring DesktopIcon::to_utf8(char32_t cp) {
-  gunichar gcp = static_cast<gunichar>(cp);
-  gchar buf[8] = {0};
-  const int len = g_unichar_to_utf8(gcp, buf);
-  buf[len] = '\0';
-  return Glib::ustring(buf);
-}
+#include <algorithm>
+#include <cstdint>
 
 // ---- IconCanvas ----
 
@@ -35,25 +22,42 @@ DesktopIcon::IconCanvas::IconCanvas() {
   get_style_context()->add_class("tile-icon-box");
 }
 
-void DesktopIcon::IconCanvas::set_glyph(const Glib::ustring& g) {
-  glyph_ = g;
+void DesktopIcon::IconCanvas::set_glyph(char32_t cp) {
+  if (cp == codepoint_) return;
+  codepoint_ = cp;
   queue_draw();
 }
 
-void DesktopIcon::IconCanvas::set_font(const Pango::FontDescription& fd) {
-  font_ = fd;
+void DesktopIcon::IconCanvas::set_bg_class(const std::string& cls) {
+  bg_id_ = TileCache::instance().class_id(cls);
+  queue_draw();
+}
+
+void DesktopIcon::IconCanvas::set_badge(const std::string& text, bool over) {
+  if (text == badge_ && over == badge_over_) return;
+  badge_ = text;
+  badge_over_ = over;
+  badge_pill_.reset();
+  queue_draw();
+}
+
+void DesktopIcon::IconCanvas::set_style(FaStyle style) {
+  style_ = style;
   queue_draw();
 }
 
 void DesktopIcon::IconCanvas::set_box_px(int px) {
-  box_px_ = std::max(12, px);
+  px = std::max(12, px);
+  if (px == box_px_) return;
+  box_px_ = px;
   update_glyph_px_();
+  badge_pill_.reset();
   queue_resize(); // rerun size negotiation
   queue_draw();
 }
 
 void DesktopIcon::IconCanvas::update_glyph_px_() {
-  glyph_px_ = std::max(6, (int)std::lround(box_px_ * ICON_FRACTION));
+  glyph_px_ = TileRender::glyph_px(box_px_);
 }
 
 void DesktopIcon::IconCanvas::get_preferred_width_vfunc(int& min_w, int& nat_w) const {
@@ -66,33 +70,69 @@ void DesktopIcon::IconCanvas::get_preferred_height_vfunc(int& min_h, int& nat_h)
   nat_h = box_px_;
 }
 
-bool DesktopIcon::IconCanvas::on_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
-  auto sc = get_style_context();
-  const int w = get_allocated_width();
-  const int h = get_allocated_height();
+void DesktopIcon::IconCanvas::on_style_updated() {
+  Gtk::DrawingArea::on_style_updated();
 
-  // Background + rounded corners from CSS (.tile-icon-box + bg-*)
-  sc->render_background(cr, 0, 0, w, h);
+  auto sc = get_style_context();
+  // IMPORTANT: use NORMAL state color (fixes “color broken” when hovered/active)
+  fg_ = sc->get_color(Gtk::STATE_FLAG_NORMAL);
+  gtk_style_context_get(sc->gobj(), gtk_style_context_get_state(sc->gobj()),
+                        GTK_STYLE_PROPERTY_BORDER_RADIUS, &radius_, nullptr);
+  style_id_ = TileRender::style_id(*this);
+  queue_draw();
+}
 
-  if (glyph_.empty()) return true;
+bool DesktopIcon::IconCanvas::on_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
+  static bool first_draw = true;
+  SV_TRACE_SCOPE_IF(first_draw, "IconCanvas::on_draw (first)");
+  first_draw = false;
+  SV_ALLOC_SCOPE(Draw);
 
-  // IMPORTANT: use NORMAL state color (fixes “color broken” when hovered/active)
-  const auto fg = sc->get_color(Gtk::STATE_FLAG_NORMAL);
-  cr->set_source_rgba(fg.get_red(), fg.get_green(), fg.get_blue(), fg.get_alpha());
+  auto& perf = perf_stats();
+  const int64_t t0 = perf.sampling ? g_get_monotonic_time() : 0;
 
-  auto layout = create_pango_layout(glyph_);
-  Pango::FontDescription fd = font_;
-  fd.set_size(glyph_px_ * Pango::SCALE);
-  layout->set_font_description(fd);
+  const int w = get_allocated_width();
+  const int h = get_allocated_height();
+  if (w <= 0 || h <= 0) return true;
+
+  TileKey key;
+  key.codepoint = codepoint_;
+  key.style = style_;
+  key.glyph_px = glyph_px_;
+  key.box_px = box_px_;
+  key.width = w;
+  key.height = h;
+  key.device_scale = get_scale_factor();
+  key.fg_rgba = TileRender::pack_rgba(fg_);
+  key.bg_id = bg_id_;
+  key.style_id = style_id_;
+  key.radius = radius_;
+  key.state = (unsigned)get_state_flags();
+
+  auto& cache = TileCache::instance();
+  auto tile = cache.lookup(key);
+  if (!tile) {
+    tile = TileRender::render_icon(*this, get_style_context(), w, h, key.device_scale, fg_,
+                                   codepoint_, style_, glyph_px_);
+    cache.insert(key, tile);
+  }
 
-  int lw = 0, lh = 0;
-  layout->get_pixel_size(lw, lh);
+  cr->set_source(tile, 0, 0);
+  cr->paint();
 
-  const double x = (w - lw) * 0.5;
-  const double y = (h - lh) * 0.5;
+  if (!badge_.empty()) {
+    double sx = 0.0, sy = 0.0;
+    if (badge_pill_) cairo_surface_get_device_scale(badge_pill_->cobj(), &sx, &sy);
+    if (sx != key.device_scale) {
+      badge_pill_ = TileRender::render_badge(*this, badge_, badge_over_, w, box_px_, key.device_scale);
+    }
+    TileRender::draw_badge(cr, badge_pill_, 0, 0, w, h);
+  }
 
-  cr->move_to(x, y);
-  pango_cairo_show_layout(cr->cobj(), layout->gobj());
+  if (t0) {
+    ++perf.draws;
+    perf.draw_us += g_get_monotonic_time() - t0;
+  }
   return true;
 }
 
@@ -100,7 +140,7 @@ bool DesktopIcon::IconCanvas::on_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
 
 DesktopIcon::DesktopIcon(const IconSpec& spec)
 : text_(spec.label),
-  is_brand_(spec.isBrand)
+  style_(spec.style)
 {
   set_relief(Gtk::RELIEF_NONE);
   set_can_focus(false);
@@ -113,48 +153,57 @@ DesktopIcon::DesktopIcon(const IconSpec& spec)
   text_.set_valign(Gtk::ALIGN_CENTER);
   text_.get_style_context()->add_class("tile-label");
 
-  icon_box_.set_glyph(to_utf8(spec.codepoint));
+  icon_box_.set_glyph(spec.codepoint);
 
   box_.pack_start(icon_box_, Gtk::PACK_SHRINK);
   box_.pack_start(text_, Gtk::PACK_SHRINK);
   add(box_);
 
-  set_ui_scale(1.0, true);
+  apply_fonts();
+  set_ui_metrics(UiScale::metrics_for(1.0), true);
   show_all_children();
 }
 
 void DesktopIcon::set_color_class(const std::string& cls) {
+  if (cls == color_class_) return;
   if (!color_class_.empty())
     icon_box_.get_style_context()->remove_class(color_class_);
   color_class_ = cls;
   if (!color_class_.empty())
     icon_box_.get_style_context()->add_class(color_class_);
-  icon_box_.queue_draw();
+  icon_box_.set_bg_class(color_class_);
 }
 
-void DesktopIcon::apply_fonts(double s) {
-  const int box_px = std::max(12, (int)std::lround(ICON_BOX_BASE * s));
-  icon_box_.set_box_px(box_px);
-
-  Pango::FontDescription fa;
-  if (is_brand_) {
-    fa.set_family(FontRegistry::kFamilyBrands);
-    fa.set_weight(Pango::WEIGHT_NORMAL);
-  } else {
-    fa.set_family(FontRegistry::kFamilyFree);
-    fa.set_weight(Pango::WEIGHT_HEAVY);
+void DesktopIcon::set_spec(const IconSpec& spec) {
+  icon_box_.set_glyph(spec.codepoint);
+  if (spec.style != style_) {
+    style_ = spec.style;
+    apply_fonts();
   }
-  icon_box_.set_font(fa);
+  if (text_.get_text() != spec.label) text_.set_text(spec.label);
+  set_color_class(spec.colorClass);
+}
+
+void DesktopIcon::set_badge(const std::string& text, bool over_budget) {
+  icon_box_.set_badge(text, over_budget);
+}
 
-  const int label_px = std::max(6, (int)std::lround(LABEL_PX_BASE * s));
-  Pango::FontDescription txt;
-  txt.set_family("Sans");
-  txt.set_size(label_px * Pango::SCALE);
-  text_.override_font(txt);
+void DesktopIcon::apply_fonts() {
+  icon_box_.set_style(style_);
 }
 
-void DesktopIcon::set_ui_scale(double s, bool show_label) {
-  box_.set_spacing(std::max(1, (int)std::lround(SPACING_BASE * s)));
-  text_.set_visible(show_label);
-  apply_fonts(s);
+void DesktopIcon::set_ui_metrics(const UiMetrics& m, bool show_label) {
+  if (&m == metrics_ && show_label == show_label_) return;
+
+  if (&m != metrics_) {
+    box_.set_spacing(m.tile_spacing);
+    icon_box_.set_box_px(m.icon_box_px);
+    text_.override_font(m.label_font);
+    metrics_ = &m;
+  }
+
+  if (show_label != show_label_) {
+    text_.set_visible(show_label);
+    show_label_ = show_label;
+  }
 }
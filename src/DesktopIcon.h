@@ -5,53 +5,80 @@
 #include <gtkmm/drawingarea.h>
 #include <gtkmm/label.h>
 #include <glibmm/ustring.h>
-#include <pangomm/fontdescription.h>
+#include <gdkmm/rgba.h>
+#include <cairomm/surface.h>
 
+#include <cstdint>
 #include <string>
 
 #include "Icons.h"
 
+struct UiMetrics;
+
 class DesktopIcon : public Gtk::Button {
 public:
   explicit DesktopIcon(const IconSpec& spec);
 
-  void set_ui_scale(double s, bool show_label);
+  // No-op (no invalidation) when neither the bucket nor label visibility changed.
+  void set_ui_metrics(const UiMetrics& m, bool show_label);
   void set_color_class(const std::string& cls);
 
-private:
-  static Glib::ustring to_utf8(char32_t cp);
+  // Live reload: updates glyph, font style, label and color in place.
+  void set_spec(const IconSpec& spec);
 
+  // Usage badge in the icon's corner; empty text hides it. Redraws only
+  // this tile, and only when text or the over-budget flag changed.
+  void set_badge(const std::string& text, bool over_budget);
+
+private:
   class IconCanvas : public Gtk::DrawingArea {
   public:
     IconCanvas();
 
-    void set_glyph(const Glib::ustring& g);
-    void set_font(const Pango::FontDescription& fd);
+    void set_glyph(char32_t cp);
+    void set_style(FaStyle style);
     void set_box_px(int px);
+    void set_bg_class(const std::string& cls);
+    void set_badge(const std::string& text, bool over);
 
   protected:
     bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override;
+    void on_style_updated() override;
 
     // Hard-force a fixed square preferred size so boxes NEVER differ.
     void get_preferred_width_vfunc(int& min_w, int& nat_w) const override;
     void get_preferred_height_vfunc(int& min_h, int& nat_h) const override;
 
   private:
-    Glib::ustring glyph_;
-    Pango::FontDescription font_;
+    char32_t codepoint_{};
+    FaStyle style_{FaStyle::Solid};
+    uint32_t bg_id_ = 0;  // TileCache::class_id of the bg-* class
+
+    // Resolved on style-updated instead of per draw.
+    Gdk::RGBA fg_;
+    int radius_ = 0;
+    uint32_t style_id_ = 0;
 
     int box_px_ = 112;
     int glyph_px_ = 56;
 
+    // Drawn over the cached tile, so badge changes never re-render it.
+    std::string badge_;
+    bool badge_over_ = false;
+    Cairo::RefPtr<Cairo::ImageSurface> badge_pill_;  // rendered on first draw
+
     void update_glyph_px_();
   };
 
-  void apply_fonts(double s);
+  void apply_fonts();
 
   Gtk::Box   box_{Gtk::ORIENTATION_VERTICAL};
   IconCanvas icon_box_;
   Gtk::Label text_;
 
-  bool is_brand_ = false;
+  FaStyle style_ = FaStyle::Solid;
   std::string color_class_;
+
+  const UiMetrics* metrics_ = nullptr;
+  bool show_label_ = true;
 };
@@ -1,8 +1,14 @@
 #include "FontRegistry.h"
+#include "Trace.h"
+
+#include "RuntimeEnv.h"
 
 #include <fontconfig/fontconfig.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -25,6 +31,145 @@
 #endif
 
 
+namespace {
+
+#if SV_HAVE_PANGO_FC && !defined(_WIN32)
+
+// The one system sans face the private config carries, resolved against the
+// full system config once and remembered in <cache>/fontconfig/sans-face.
+struct SansPin {
+  std::string family;
+  std::string file;
+  int index = 0;
+  gint64 mtime = 0;  // of `file`; a changed file is re-resolved
+};
+
+std::string private_cache_dir() {
+  gchar* p = g_build_filename(g_get_user_cache_dir(), "sv-dashboard-gtk", "fontconfig", nullptr);
+  std::string out = p ? p : "";
+  g_free(p);
+  return out;
+}
+
+std::string pin_path() {
+  return private_cache_dir() + G_DIR_SEPARATOR_S "sans-face";
+}
+
+gint64 file_mtime(const std::string& path) {
+  GStatBuf st;
+  return g_stat(path.c_str(), &st) == 0 ? (gint64)st.st_mtime : -1;
+}
+
+// SV_DASHBOARD_FONTCONFIG=system keeps the full system config.
+bool private_mode() {
+  const char* mode = g_getenv("SV_DASHBOARD_FONTCONFIG");
+  return !mode || std::strcmp(mode, "system") != 0;
+}
+
+bool load_pin(SansPin& pin) {
+  gchar* data = nullptr;
+  if (!g_file_get_contents(pin_path().c_str(), &data, nullptr, nullptr)) return false;
+  gchar** lines = g_strsplit(data, "\n", 5);
+  g_free(data);
+
+  bool ok = g_strv_length(lines) >= 4;
+  if (ok) {
+    pin.family = lines[0];
+    pin.file = lines[1];
+    pin.index = std::atoi(lines[2]);
+    pin.mtime = g_ascii_strtoll(lines[3], nullptr, 10);
+    ok = !pin.family.empty() && file_mtime(pin.file) == pin.mtime;
+  }
+  g_strfreev(lines);
+  return ok;
+}
+
+void save_pin(const SansPin& pin) {
+  RuntimeEnv::ensureDir(private_cache_dir());
+  const std::string text = pin.family + "\n" + pin.file + "\n" + std::to_string(pin.index) + "\n" +
+                           std::to_string(pin.mtime) + "\n";
+  GError* error = nullptr;
+  if (!g_file_set_contents(pin_path().c_str(), text.data(), (gssize)text.size(), &error)) {
+    g_warning("FontRegistry: cannot write %s: %s", pin_path().c_str(), error ? error->message : "?");
+    if (error) g_error_free(error);
+  }
+}
+
+// What "sans-serif" resolves to under `cfg` (a full system config).
+bool resolve_pin(FcConfig* cfg, SansPin& pin) {
+  FcPattern* pat = FcNameParse(reinterpret_cast<const FcChar8*>("sans-serif"));
+  if (!pat) return false;
+  FcConfigSubstitute(cfg, pat, FcMatchPattern);
+  FcDefaultSubstitute(pat);
+  FcResult res = FcResultNoMatch;
+  FcPattern* match = FcFontMatch(cfg, pat, &res);
+  FcPatternDestroy(pat);
+  if (!match) return false;
+
+  FcChar8* family = nullptr;
+  FcChar8* file = nullptr;
+  int index = 0;
+  const bool ok = FcPatternGetString(match, FC_FAMILY, 0, &family) == FcResultMatch &&
+                  FcPatternGetString(match, FC_FILE, 0, &file) == FcResultMatch;
+  if (ok) {
+    FcPatternGetInteger(match, FC_INDEX, 0, &index);
+    pin.family = reinterpret_cast<const char*>(family);
+    pin.file = reinterpret_cast<const char*>(file);
+    pin.index = index;
+    pin.mtime = file_mtime(pin.file);
+  }
+  FcPatternDestroy(match);
+  return ok;
+}
+
+std::string xml_escape(const std::string& s) {
+  gchar* e = g_markup_escape_text(s.c_str(), -1);
+  std::string out = e ? e : "";
+  g_free(e);
+  return out;
+}
+
+// The pinned sans face, with the generic families aliased to it, plus the
+// bundled fonts in `font_dir` (cached under private_cache_dir()) unless it
+// is empty. Loads no system config and scans no system font directory.
+FcConfig* build_private_config(const std::string& font_dir, const SansPin& pin) {
+#if FC_VERSION >= 21291
+  SV_TRACE_SCOPE("FontRegistry: private config");
+  const std::string cache = private_cache_dir();
+  RuntimeEnv::ensureDir(cache);
+
+  std::string xml =
+      "<?xml version=\"1.0\"?>\n<!DOCTYPE fontconfig SYSTEM \"urn:fontconfig:fonts.dtd\">\n<fontconfig>\n"
+      "  <cachedir>" + xml_escape(cache) + "</cachedir>\n";
+  if (!font_dir.empty()) xml += "  <dir>" + xml_escape(font_dir) + "</dir>\n";
+  for (const char* generic : { "Sans", "sans-serif", "serif", "monospace", "system-ui" }) {
+    xml += "  <alias binding=\"same\"><family>" + std::string(generic) + "</family><prefer><family>" +
+           xml_escape(pin.family) + "</family></prefer></alias>\n";
+  }
+  xml += "</fontconfig>\n";
+
+  FcConfig* cfg = FcConfigCreate();
+  if (!cfg) return nullptr;
+  if (!FcConfigParseAndLoadFromMemory(cfg, reinterpret_cast<const FcChar8*>(xml.c_str()), FcTrue) ||
+      !FcConfigAppFontAddFile(cfg, reinterpret_cast<const FcChar8*>(pin.file.c_str()))) {
+    std::cerr << "FontRegistry: private fontconfig setup failed; using the system config\n";
+    FcConfigDestroy(cfg);
+    return nullptr;
+  }
+  FcConfigBuildFonts(cfg);
+  return cfg;
+#else
+  (void)font_dir;
+  (void)pin;
+  return nullptr;  // needs FcConfigParseAndLoadFromMemory (fontconfig 2.12.91)
+#endif
+}
+
+#endif // SV_HAVE_PANGO_FC && !_WIN32
+
+} // namespace
+
+
 void FontRegistry::setFontDirOverride(std::string dir) {
   font_dir_override_ = std::move(dir);
 }
@@ -60,6 +205,8 @@ std::string FontRegistry::exeDir() {
 }
 
 std::string FontRegistry::findFontDir() const {
+  SV_TRACE_SCOPE("FontRegistry::findFontDir");
+
   if (!font_dir_override_.empty()) return font_dir_override_;
 
   // Env override (works on Linux + Windows; run.bat sets this)
@@ -111,7 +258,20 @@ std::string FontRegistry::findFontDir() const {
 }
 
 bool FontRegistry::registerBundledFonts() {
-  const auto dir = findFontDir();
+  SV_TRACE_SCOPE("FontRegistry::registerBundledFonts");
+  prepare();
+  return attach();
+}
+
+bool FontRegistry::prepare() {
+  SV_TRACE_SCOPE("FontRegistry::prepare");
+
+  dir_ = findFontDir();
+  files_ok_ = false;
+  config_ = nullptr;
+  bundled_pending_ = false;
+
+  const auto& dir = dir_;
   if (dir.empty()) {
     std::cerr
       << "FontRegistry: could not locate bundled font directory.\n"
@@ -132,6 +292,128 @@ bool FontRegistry::registerBundledFonts() {
     std::cerr << "FontRegistry: missing FA font files in: " << dir << "\n";
     return false;
   }
+  files_ok_ = true;
+
+#if SV_HAVE_PANGO_FC
+#ifndef _WIN32
+  if (private_mode()) {
+    // Labels first: attach() adds the bundled fonts to it later.
+    SansPin pin;
+    if (load_pin(pin) && (config_ = build_private_config(std::string(), pin))) {
+      bundled_pending_ = true;
+      return true;
+    }
+  }
+#endif
+
+  FcConfig* cfg = FcInitLoadConfigAndFonts();
+  if (!cfg) {
+    std::cerr << "FontRegistry: FcInitLoadConfigAndFonts failed\n";
+    return true; // files are there; attach() may still use the GDI path on Windows
+  }
+
+#ifdef _WIN32
+  std::string norm = dir;
+  for (auto& ch : norm) if (ch == '\\') ch = '/';
+  const FcBool ok = FcConfigAppFontAddDir(cfg, reinterpret_cast<const FcChar8*>(norm.c_str()));
+#else
+  const FcBool ok = FcConfigAppFontAddDir(cfg, reinterpret_cast<const FcChar8*>(dir.c_str()));
+#endif
+  if (!ok) {
+    std::cerr << "FontRegistry: FcConfigAppFontAddDir failed for: " << dir << "\n";
+    FcConfigDestroy(cfg);
+    return true;
+  }
+
+  FcConfigBuildFonts(cfg);
+  config_ = cfg;
+
+#ifndef _WIN32
+  // Pin the sans face now, so the next start can skip the system config.
+  if (private_mode()) {
+    SansPin pin;
+    if (resolve_pin(cfg, pin)) save_pin(pin);
+  }
+#endif
+#endif // SV_HAVE_PANGO_FC
+
+  return true;
+}
+
+bool FontRegistry::prime() {
+  SV_TRACE_SCOPE("FontRegistry::prime");
+#if SV_HAVE_PANGO_FC && !defined(_WIN32)
+  const std::string dir = findFontDir();
+  if (dir.empty()) {
+    std::cerr << "FontRegistry: could not locate bundled font directory.\n";
+    return false;
+  }
+
+  FcConfig* system = FcInitLoadConfigAndFonts();
+  SansPin pin;
+  const bool resolved = system && resolve_pin(system, pin);
+  if (system) FcConfigDestroy(system);
+  if (!resolved) {
+    std::cerr << "FontRegistry: no system sans-serif face found\n";
+    return false;
+  }
+  save_pin(pin);
+
+  // Building it scans the bundled fonts and writes their cache.
+  FcConfig* cfg = build_private_config(dir, pin);
+  if (!cfg) return false;
+  FcConfigDestroy(cfg);
+  std::cout << "fonts: " << dir << " + " << pin.family << " (" << pin.file << ")\n";
+  return true;
+#else
+  return true;  // nothing to prime without a private fontconfig
+#endif
+}
+
+const std::string& FontRegistry::labelFamily() {
+  static const std::string family = [] {
+#if SV_HAVE_PANGO_FC && !defined(_WIN32)
+    SansPin pin;
+    if (load_pin(pin)) return pin.family;
+#endif
+    return std::string("Sans");
+  }();
+  return family;
+}
+
+bool FontRegistry::add_bundled() {
+#if SV_HAVE_PANGO_FC
+  if (!bundled_pending_) return false;
+  bundled_pending_ = false;
+  SV_TRACE_SCOPE("FontRegistry: add bundled fonts");
+  if (!FcConfigAppFontAddDir(config_, reinterpret_cast<const FcChar8*>(dir_.c_str()))) {
+    std::cerr << "FontRegistry: FcConfigAppFontAddDir failed for: " << dir_ << "\n";
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool FontRegistry::attach_labels() {
+  SV_TRACE_SCOPE("FontRegistry::attach_labels");
+#if SV_HAVE_PANGO_FC && !defined(_WIN32)
+  if (files_ok_ && config_ && !attached_) {
+    PangoFontMap* fm = pango_cairo_font_map_get_default();
+    if (fm && PANGO_IS_FC_FONT_MAP(fm)) {
+      pango_fc_font_map_set_config(PANGO_FC_FONT_MAP(fm), config_);
+      attached_ = true;
+    }
+  }
+#endif
+  return attached_;
+}
+
+bool FontRegistry::attach() {
+  SV_TRACE_SCOPE("FontRegistry::attach");
+  if (!files_ok_) return false;
+  [[maybe_unused]] const auto& dir = dir_;
 
 #ifdef _WIN32
   // Force a Fontconfig/FreeType-backed PangoCairo fontmap as the default.
@@ -147,40 +429,26 @@ bool FontRegistry::registerBundledFonts() {
 
   // ---- Path A: PangoFc backend (Fontconfig/FreeType) ----
 #if SV_HAVE_PANGO_FC
-  {
-    FcConfig* cfg = FcInitLoadConfigAndFonts();
-    if (cfg) {
-#ifdef _WIN32
-      std::string norm = dir;
-      for (auto& ch : norm) if (ch == '\\') ch = '/';
-      const FcBool ok = FcConfigAppFontAddDir(cfg, reinterpret_cast<const FcChar8*>(norm.c_str()));
-#else
-      const FcBool ok = FcConfigAppFontAddDir(cfg, reinterpret_cast<const FcChar8*>(dir.c_str()));
-#endif
-      if (ok) {
-        FcConfigBuildFonts(cfg);
-
-        // Attach config to the *actual* Pango font map.
-        PangoFontMap* fm = pango_cairo_font_map_get_default();
-        if (fm && PANGO_IS_FC_FONT_MAP(fm)) {
-          pango_fc_font_map_set_config(PANGO_FC_FONT_MAP(fm), cfg);
-          pango_fc_font_map_cache_clear(PANGO_FC_FONT_MAP(fm));
-          pango_font_map_changed(fm);
-          return true;
-        }
+  if (config_) {
+    // Attach config to the *actual* Pango font map.
+    PangoFontMap* fm = pango_cairo_font_map_get_default();
+    if (fm && PANGO_IS_FC_FONT_MAP(fm)) {
+      const bool added = add_bundled();
+      if (attached_ && !added) return true;  // attach_labels() attached it all
+      if (!attached_) pango_fc_font_map_set_config(PANGO_FC_FONT_MAP(fm), config_);
+      attached_ = true;
+      // Pango keeps its own copy of the config's font list.
+      pango_fc_font_map_cache_clear(PANGO_FC_FONT_MAP(fm));
+      pango_font_map_changed(fm);
+      return true;
+    }
 
-        // If we forced FT map on Windows and still didn't get Fc font map, log it.
-        if (fm) {
-          std::cerr << "FontRegistry: default Pango font map is not PangoFc: "
-                    << G_OBJECT_TYPE_NAME(fm) << "\n";
-        } else {
-          std::cerr << "FontRegistry: pango_cairo_font_map_get_default() returned null\n";
-        }
-      } else {
-        std::cerr << "FontRegistry: FcConfigAppFontAddDir failed for: " << dir << "\n";
-      }
+    // If we forced FT map on Windows and still didn't get Fc font map, log it.
+    if (fm) {
+      std::cerr << "FontRegistry: default Pango font map is not PangoFc: "
+                << G_OBJECT_TYPE_NAME(fm) << "\n";
     } else {
-      std::cerr << "FontRegistry: FcInitLoadConfigAndFonts failed\n";
+      std::cerr << "FontRegistry: pango_cairo_font_map_get_default() returned null\n";
     }
   }
 #endif // SV_HAVE_PANGO_FC
@@ -1,14 +1,43 @@
 #pragma once
 #include <string>
 
+typedef struct _FcConfig FcConfig;
+
 class FontRegistry {
 public:
   // Registers FA6 fonts via fontconfig. Returns true on success.
+  // Equivalent to prepare() followed by attach() on the calling thread.
   bool registerBundledFonts();
 
+  // Slow part: locate the font dir and build the fontconfig config (scans fonts).
+  // Touches no Pango/GTK state, so it may run on a worker thread.
+  // Unless SV_DASHBOARD_FONTCONFIG=system, once a sans face has been pinned
+  // this builds an app-private config instead: that one face, and later the
+  // bundled fonts (cached under $XDG_CACHE_HOME/sv-dashboard-gtk/fontconfig),
+  // without loading the system config or scanning system fonts.
+  bool prepare();
+
+  // --prime-caches: pin the sans face against the system config and write
+  // the private config's font cache, so the first real start is fast.
+  bool prime();
+
+  // Attach the prepared fonts to the default Pango font map. The default
+  // font map is per-thread, so this must run on the GTK main thread.
+  bool attach();
+
+  // Attach the prepared config before the first label is laid out, so Pango
+  // never builds its default one from the system config. A private config
+  // holds only the sans face at this point; attach() adds the bundled fonts.
+  // False if nothing was attached (main thread only).
+  bool attach_labels();
+
   // Optional: allow overriding the font dir (e.g. for packaging/tests)
   void setFontDirOverride(std::string dir);
 
+  // Family for labels: the pinned sans face, else "Sans". Read once, so
+  // scale changes never go through alias substitution.
+  static const std::string& labelFamily();
+
   // Common families (Pango names) used by FA6.
   static constexpr const char* kFamilyFree   = "Font Awesome 6 Free";
   static constexpr const char* kFamilyBrands = "Font Awesome 6 Brands";
@@ -16,6 +45,14 @@ public:
 private:
   std::string font_dir_override_;
 
+  std::string dir_;
+  bool files_ok_ = false;
+  FcConfig* config_ = nullptr;
+  bool bundled_pending_ = false;  // private config still lacks the bundled fonts
+  bool attached_ = false;
+
+  bool add_bundled();
+
   std::string findFontDir() const;
   static std::string exeDir();
 };
@@ -0,0 +1,199 @@
+#include "GlyphAtlas.h"
+#include "RuntimeEnv.h"
+#include "Trace.h"
+
+#include <glib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using GlyphAtlasFormat::Glyph;
+using GlyphAtlasFormat::Header;
+
+namespace {
+
+std::string join(const std::string& a, const char* b, const char* c = nullptr,
+                 const char* d = nullptr, const char* e = nullptr) {
+  gchar* p = g_build_filename(a.c_str(), b, c, d, e, nullptr);
+  std::string out = p ? p : "";
+  g_free(p);
+  return out;
+}
+
+bool less(const Glyph& g, char32_t cp, FaStyle style) {
+  return g.codepoint != cp ? g.codepoint < (uint32_t)cp : g.style < (uint8_t)style;
+}
+
+} // namespace
+
+GlyphAtlas& GlyphAtlas::instance() {
+  static GlyphAtlas atlas;
+  return atlas;
+}
+
+GlyphAtlas::~GlyphAtlas() {
+  if (file_) g_mapped_file_unref(file_);
+}
+
+bool GlyphAtlas::load() {
+  if (tried_) return loaded();
+  tried_ = true;
+  SV_TRACE_SCOPE("GlyphAtlas::load");
+
+  if (const char* env = g_getenv("SV_DASHBOARD_ATLAS"); env && *env) return map(env);
+
+  std::vector<std::string> candidates;
+  const std::string ed = RuntimeEnv::exeDir();
+  if (!ed.empty()) {
+    candidates.push_back(join(ed, "glyphs.atlas"));  // build dir
+    candidates.push_back(join(ed, "share", "sv-dashboard-gtk", "glyphs.atlas"));
+    candidates.push_back(join(ed, "..", "share", "sv-dashboard-gtk", "glyphs.atlas"));
+  }
+  for (const char* prefix : { "/usr/local/share", "/usr/share" }) {
+    candidates.push_back(join(prefix, "sv-dashboard-gtk", "glyphs.atlas"));
+  }
+
+  for (const auto& path : candidates) {
+    if (g_file_test(path.c_str(), G_FILE_TEST_IS_REGULAR)) return map(path);
+  }
+  g_debug("GlyphAtlas: none found; glyphs use the font path");
+  return false;
+}
+
+bool GlyphAtlas::map(const std::string& path) {
+  GError* error = nullptr;
+  GMappedFile* mf = g_mapped_file_new(path.c_str(), FALSE, &error);
+  if (!mf) {
+    g_warning("GlyphAtlas: cannot map %s: %s", path.c_str(), error ? error->message : "?");
+    if (error) g_error_free(error);
+    return false;
+  }
+
+  const char* data = g_mapped_file_get_contents(mf);
+  const size_t len = g_mapped_file_get_length(mf);
+  const auto* h = reinterpret_cast<const Header*>(data);
+  const bool ok = len >= sizeof(Header) &&
+                  std::memcmp(h->magic, GlyphAtlasFormat::kMagic, sizeof(h->magic)) == 0 &&
+                  h->version == GlyphAtlasFormat::kVersion && h->em_px > 0 && h->spread > 0 &&
+                  len >= sizeof(Header) + (size_t)h->count * sizeof(Glyph) + (size_t)h->width * h->height;
+  if (!ok) {
+    g_warning("GlyphAtlas: %s is not a version %u atlas", path.c_str(), GlyphAtlasFormat::kVersion);
+    g_mapped_file_unref(mf);
+    return false;
+  }
+
+  file_ = mf;
+  header_ = h;
+  glyphs_ = reinterpret_cast<const Glyph*>(data + sizeof(Header));
+  pixels_ = reinterpret_cast<const uint8_t*>(glyphs_ + h->count);
+  g_debug("GlyphAtlas: %u glyphs from %s", h->count, path.c_str());
+  return true;
+}
+
+const Glyph* GlyphAtlas::find(char32_t cp, FaStyle style) const {
+  if (!glyphs_) return nullptr;
+  const Glyph* end = glyphs_ + header_->count;
+  const Glyph* it = std::lower_bound(glyphs_, end, 0, [cp, style](const Glyph& g, int) {
+    return less(g, cp, style);
+  });
+  return it != end && it->codepoint == (uint32_t)cp && it->style == (uint8_t)style ? it : nullptr;
+}
+
+bool GlyphAtlas::has(char32_t cp, FaStyle style) const {
+  return find(cp, style) != nullptr;
+}
+
+bool GlyphAtlas::covers(const IconConfig& config) const {
+  if (!loaded()) return false;
+  for (char32_t cp : { CHEV_LEFT, CHEV_RIGHT, SCHEME_DAY, SCHEME_DUSK, SCHEME_NIGHT }) {
+    if (!has(cp, FaStyle::Solid)) return false;
+  }
+  for (const auto& page : config.pages) {
+    for (const auto& spec : page) {
+      if (!has(spec.codepoint, spec.style)) return false;
+    }
+  }
+  return true;
+}
+
+bool GlyphAtlas::logical_size(char32_t cp, FaStyle style, double em_px, int& w, int& h) const {
+  const Glyph* g = find(cp, style);
+  if (!g) return false;
+  const int s = (int)style;
+  w = (int)std::lround(g->advance * em_px);
+  h = (int)std::lround((header_->ascender[s] - header_->descender[s]) * em_px);
+  return true;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> GlyphAtlas::mask(char32_t cp, FaStyle style, double em_px, int dev,
+                                                    double x, double y, double& mx, double& my) const {
+  const Glyph* g = find(cp, style);
+  if (!g || em_px <= 0.0 || g->w == 0 || g->h == 0) return {};
+
+  const double s = em_px / header_->em_px;  // units per source px
+  const double spread = header_->spread;
+  const double d = std::max(1, dev);
+
+  // SDF cell in units; the mask itself snaps to device pixels so cairo
+  // never resamples it.
+  const double gx = x + g->bearing_x * em_px - spread * s;
+  const double gy = y + header_->ascender[(int)style] * em_px - g->bearing_y * em_px - spread * s;
+
+  const int x0 = (int)std::floor(gx * d), y0 = (int)std::floor(gy * d);
+  const int x1 = (int)std::ceil((gx + g->w * s) * d), y1 = (int)std::ceil((gy + g->h * s) * d);
+  if (x1 <= x0 || y1 <= y0) return {};
+
+  auto surface = Cairo::ImageSurface::create(Cairo::FORMAT_A8, x1 - x0, y1 - y0);
+  surface->flush();
+  unsigned char* out = surface->get_data();
+  const int stride = surface->get_stride();
+
+  const uint8_t* cell = pixels_ + (size_t)g->y * header_->width + g->x;
+  const size_t row = header_->width;
+  const double ramp = s * d * spread / 127.0;  // SDF step -> device px
+
+  auto sample = [&](double sx, double sy) {
+    // Bilinear; beyond the cell everything is "far outside".
+    const int ix = (int)std::floor(sx), iy = (int)std::floor(sy);
+    const double fx = sx - ix, fy = sy - iy;
+    auto at = [&](int cx, int cy) -> double {
+      if (cx < 0 || cy < 0 || cx >= g->w || cy >= g->h) return 0.0;
+      return cell[(size_t)cy * row + cx];
+    };
+    const double top = at(ix, iy) + (at(ix + 1, iy) - at(ix, iy)) * fx;
+    const double bot = at(ix, iy + 1) + (at(ix + 1, iy + 1) - at(ix, iy + 1)) * fx;
+    return top + (bot - top) * fy;
+  };
+
+  for (int py = 0; py < y1 - y0; ++py) {
+    const double sy = ((y0 + py + 0.5) / d - gy) / s - 0.5;
+    unsigned char* dst = out + (size_t)py * stride;
+    for (int px = 0; px < x1 - x0; ++px) {
+      const double sx = ((x0 + px + 0.5) / d - gx) / s - 0.5;
+      const double a = std::clamp((sample(sx, sy) - 128.0) * ramp + 0.5, 0.0, 1.0);
+      dst[px] = (unsigned char)std::lround(a * 255.0);
+    }
+  }
+  surface->mark_dirty();
+  cairo_surface_set_device_scale(surface->cobj(), d, d);
+
+  mx = x0 / d;
+  my = y0 / d;
+  return surface;
+}
+
+bool GlyphAtlas::draw_centered(const Cairo::RefPtr<Cairo::Context>& cr, char32_t cp, FaStyle style,
+                               double em_px, double x, double y, double w, double h) const {
+  int lw = 0, lh = 0;
+  if (!logical_size(cp, style, em_px, lw, lh)) return false;
+
+  double sx = 1.0, sy = 1.0;
+  cairo_surface_get_device_scale(cairo_get_target(cr->cobj()), &sx, &sy);
+  double mx = 0.0, my = 0.0;
+  auto m = mask(cp, style, em_px, std::max(1, (int)std::lround(sx)),
+                x + (w - lw) * 0.5, y + (h - lh) * 0.5, mx, my);
+  if (m) cr->mask(m, mx, my);  // null: blank glyph
+  return true;
+}
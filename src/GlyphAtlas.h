@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cairomm/context.h>
+#include <cairomm/surface.h>
+
+#include <cstdint>
+#include <string>
+
+#include "Icons.h"
+
+typedef struct _GMappedFile GMappedFile;
+
+// Signed-distance-field atlas of the Font Awesome glyphs the launcher
+// draws, generated at build time by tools/sv-atlas-gen (see meson.build).
+// Glyphs found here are drawn without fontconfig/FreeType/Pango at any
+// scale; anything else falls back to the font path.
+namespace GlyphAtlasFormat {
+
+inline constexpr char kMagic[8] = { 'S', 'V', 'A', 'T', 'L', 'A', 'S', '\0' };
+inline constexpr uint32_t kVersion = 1;
+
+// File layout: Header, Glyph[count] sorted by (codepoint, style), then
+// width * height SDF bytes (128 = edge, larger = inside, +-127 = +-spread px).
+// Metrics are in ems, y up from the baseline, as FreeType reports them.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t em_px;      // source pixels per em
+  uint32_t spread;     // source pixels covered by the +-127 range
+  uint32_t width;
+  uint32_t height;
+  uint32_t count;
+  float ascender[3];   // per FaStyle
+  float descender[3];  // negative below the baseline
+};
+
+struct Glyph {
+  uint32_t codepoint;
+  uint8_t style;       // FaStyle
+  uint8_t pad[3];
+  uint16_t x, y, w, h; // SDF cell, including `spread` px on each side
+  float advance;
+  float bearing_x;     // ink left from the pen
+  float bearing_y;     // ink top above the baseline
+};
+
+static_assert(sizeof(Header) == 56, "atlas header layout");
+static_assert(sizeof(Glyph) == 28, "atlas glyph layout");
+
+} // namespace GlyphAtlasFormat
+
+class GlyphAtlas {
+public:
+  static GlyphAtlas& instance();
+
+  // Maps the atlas: $SV_DASHBOARD_ATLAS, next to the executable, or
+  // <datadir>/sv-dashboard-gtk/glyphs.atlas. Idempotent; false if none.
+  bool load();
+  bool loaded() const { return glyphs_ != nullptr; }
+
+  bool has(char32_t cp, FaStyle style) const;
+  // Every tile glyph of `config` plus the nav/scheme glyphs.
+  bool covers(const IconConfig& config) const;
+
+  // Pango-equivalent logical box of the glyph at `em_px` (font size in
+  // device-independent pixels), i.e. what a one-glyph layout reports.
+  bool logical_size(char32_t cp, FaStyle style, double em_px, int& w, int& h) const;
+
+  // Coverage mask of the glyph at `em_px` whose logical box starts at
+  // (x, y), rendered at `dev` pixels per unit and aligned to that pixel
+  // grid; paint it at (mx, my). Null if the glyph is unknown or blank.
+  Cairo::RefPtr<Cairo::ImageSurface> mask(char32_t cp, FaStyle style, double em_px, int dev,
+                                          double x, double y, double& mx, double& my) const;
+
+  // Fills the glyph in the current source, centered in (x, y, w, h) the way
+  // TileRender centers a Pango layout. False if the glyph is not in the atlas.
+  bool draw_centered(const Cairo::RefPtr<Cairo::Context>& cr, char32_t cp, FaStyle style,
+                     double em_px, double x, double y, double w, double h) const;
+
+private:
+  GlyphAtlas() = default;
+  ~GlyphAtlas();
+
+  bool map(const std::string& path);
+  const GlyphAtlasFormat::Glyph* find(char32_t cp, FaStyle style) const;
+
+  bool tried_ = false;
+  GMappedFile* file_ = nullptr;
+  const GlyphAtlasFormat::Header* header_ = nullptr;
+  const GlyphAtlasFormat::Glyph* glyphs_ = nullptr;
+  const uint8_t* pixels_ = nullptr;
+};
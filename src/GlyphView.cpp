@@ -0,0 +1,66 @@
+#include "GlyphView.h"
+#include "GlyphAtlas.h"
+#include "TileRender.h"
+
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+
+GlyphView::GlyphView(char32_t codepoint, FaStyle style)
+: codepoint_(codepoint), style_(style)
+{
+  set_halign(Gtk::ALIGN_CENTER);
+  set_valign(Gtk::ALIGN_CENTER);
+}
+
+void GlyphView::set_px(int px) {
+  if (px == px_) return;
+  px_ = px;
+  measure();
+  queue_resize();
+}
+
+void GlyphView::measure() {
+  mask_.reset();
+  if (GlyphAtlas::instance().logical_size(codepoint_, style_, TileRender::em_px(*this, px_), w_, h_)) {
+    layout_.reset();
+    return;
+  }
+
+  if (!layout_) layout_ = create_pango_layout(TileRender::to_utf8(codepoint_));
+  Pango::FontDescription fd = TileRender::glyph_font(style_);
+  fd.set_size(px_ * Pango::SCALE);
+  layout_->set_font_description(fd);
+  layout_->get_pixel_size(w_, h_);
+}
+
+void GlyphView::get_preferred_width_vfunc(int& min_w, int& nat_w) const {
+  min_w = nat_w = std::max(1, w_);
+}
+
+void GlyphView::get_preferred_height_vfunc(int& min_h, int& nat_h) const {
+  min_h = nat_h = std::max(1, h_);
+}
+
+bool GlyphView::on_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
+  const int w = get_allocated_width();
+  const int h = get_allocated_height();
+  const auto fg = get_style_context()->get_color(get_state_flags());
+  cr->set_source_rgba(fg.get_red(), fg.get_green(), fg.get_blue(), fg.get_alpha());
+
+  if (layout_) {
+    cr->move_to((w - w_) * 0.5, (h - h_) * 0.5);
+    pango_cairo_show_layout(cr->cobj(), layout_->gobj());
+    return true;
+  }
+
+  const int dev = get_scale_factor();
+  const int key[4] = { px_, w, h, dev };
+  if (!std::equal(key, key + 4, mask_key_)) {
+    std::copy(key, key + 4, mask_key_);
+    mask_ = GlyphAtlas::instance().mask(codepoint_, style_, TileRender::em_px(*this, px_), dev,
+                                        (w - w_) * 0.5, (h - h_) * 0.5, mask_x_, mask_y_);
+  }
+  if (mask_) cr->mask(mask_, mask_x_, mask_y_);
+  return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cairomm/surface.h>
+#include <gtkmm/drawingarea.h>
+#include <pangomm/layout.h>
+
+#include "Icons.h"
+
+// One Font Awesome glyph in the CSS `color`, sized like a Gtk::Label set in
+// the same font. Used for the nav and scheme buttons; drawn from GlyphAtlas
+// when it has the glyph, so those need no font lookup either.
+class GlyphView : public Gtk::DrawingArea {
+public:
+  explicit GlyphView(char32_t codepoint, FaStyle style = FaStyle::Solid);
+
+  // Font size as UiMetrics::nav_px / scheme_px.
+  void set_px(int px);
+
+protected:
+  bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override;
+  void get_preferred_width_vfunc(int& min_w, int& nat_w) const override;
+  void get_preferred_height_vfunc(int& min_h, int& nat_h) const override;
+
+private:
+  void measure();
+
+  char32_t codepoint_;
+  FaStyle style_;
+  int px_ = 0;
+  int w_ = 1, h_ = 1;
+
+  // Atlas mask for the current size, allocation and scale factor.
+  Cairo::RefPtr<Cairo::ImageSurface> mask_;
+  double mask_x_ = 0.0, mask_y_ = 0.0;
+  int mask_key_[4] = { 0, 0, 0, 0 };
+
+  Glib::RefPtr<Pango::Layout> layout_;  // font fallback only
+};
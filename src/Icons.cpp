@@ -1,74 +1,82 @@
 #include "Icons.h"
-
+#include "AllocStats.h"
+#include "ConfigCache.h"
+#include "JsonPull.h"
+#include "Theme.h"
+#include "Trace.h"
+#include "fa_glyphs.h"
+
+#include <gdk/gdk.h>
 #include <json-glib/json-glib.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 
 namespace {
 
-struct GlyphSpec {
-  char32_t codepoint{};
-  bool isBrand{false};
-};
+// Must match fa_hash() in scripts/gen-fa-glyphs.py.
+constexpr uint32_t fa_hash(std::string_view s, uint32_t seed) {
+  uint32_t h = 2166136261u ^ seed;
+  for (char c : s) {
+    h ^= (unsigned char)c;
+    h *= 16777619u;
+  }
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
 
-const std::unordered_map<std::string, GlyphSpec>& glyph_map() {
-  static const std::unordered_map<std::string, GlyphSpec> map = {
-    {"chart",        {U'\uf5a0', false}},
-    {"chart-area",   {U'\uf5a0', false}},
-    {"dashboard",    {U'\uf624', false}},
-    {"tachometer-alt", {U'\uf624', false}},
-    {"autopilot",    {U'\uf1d8', false}},
-    {"paper-plane",  {U'\uf1d8', false}},
-    {"weather",      {U'\uf743', false}},
-    {"cloud-sun-rain", {U'\uf743', false}},
-    {"camera",       {U'\uf030', false}},
-    {"race",         {U'\uf0ac', false}},
-    {"flag-checkered", {U'\uf0ac', false}},
-    {"multimedia",   {U'\uf001', false}},
-    {"music",        {U'\uf001', false}},
-    {"youtube",      {U'\uf167', true}},
-    {"travel",       {U'\uf6ec', false}},
-    {"route",        {U'\uf6ec', false}},
-    {"internet",     {U'\uf268', true}},
-    {"globe",        {U'\uf268', true}},
-    {"email",        {U'\uf0e0', false}},
-    {"envelope",     {U'\uf0e0', false}},
-    {"radio",        {U'\uf8d7', false}},
-    {"broadcast-tower", {U'\uf8d7', false}},
-    {"sky",          {U'\uf005', false}},
-    {"star",         {U'\uf005', false}},
-    {"buoy",         {U'\uf13d', false}},
-    {"anchor",       {U'\uf13d', false}},
-    {"provisioning", {U'\uf2e7', false}},
-    {"shopping-basket", {U'\uf2e7', false}},
-    {"ship",         {U'\uf21a', false}},
-    {"terminal",     {U'\uf120', false}},
-    {"tasks",        {U'\uf0ae', false}},
-    {"folder",       {U'\uf07b', false}},
-    {"solar",        {U'\uf5ba', false}},
-    {"solar-panel",  {U'\uf5ba', false}},
-    {"drone",        {U'\uf072', false}},
-    {"facebook",     {U'\uf39e', true}},
-    {"vessel",       {U'\uf21a', false}},
-    {"school",       {U'\uf549', false}},
-    {"knot",         {U'\uf6f0', false}},
-    {"colreg",       {U'\uf2c1', false}},
-    {"book",         {U'\uf2c1', false}},
-    {"chess",        {U'\uf439', false}},
-  };
-  return map;
+// O(1), allocation-free lookup in the generated minimal perfect hash.
+const fa_glyphs::Entry* find_fa(std::string_view name) {
+  const uint32_t bucket = fa_hash(name, 0) % fa_glyphs::kBuckets;
+  const auto& e = fa_glyphs::kEntries[fa_hash(name, fa_glyphs::kDisplace[bucket]) % fa_glyphs::kCount];
+  return e.name == name ? &e : nullptr;
+}
+
+FaStyle pick_style(uint8_t available, int wanted) {
+  if (wanted >= 0 && (available & (1u << wanted))) return (FaStyle)wanted;
+  if (available & fa_glyphs::kSolid)   return FaStyle::Solid;
+  if (available & fa_glyphs::kRegular) return FaStyle::Regular;
+  return FaStyle::Brands;
 }
 
+} // namespace
+
 GlyphSpec glyph_for_image(const std::string& name) {
-  const auto& map = glyph_map();
-  auto it = map.find(name);
-  if (it != map.end()) {
-    return it->second;
+  // Accepts "star", "fa-star" and class lists like "fa-regular fa-star" / "far fa-star".
+  int wanted = -1;
+  std::string_view icon;
+
+  std::string_view rest(name);
+  while (!rest.empty()) {
+    const auto sp = rest.find(' ');
+    std::string_view tok = rest.substr(0, sp);
+    rest = (sp == std::string_view::npos) ? std::string_view{} : rest.substr(sp + 1);
+    if (tok.empty()) continue;
+
+    if      (tok == "fa-solid"   || tok == "fas") wanted = (int)FaStyle::Solid;
+    else if (tok == "fa-regular" || tok == "far") wanted = (int)FaStyle::Regular;
+    else if (tok == "fa-brands"  || tok == "fab") wanted = (int)FaStyle::Brands;
+    else if (tok == "fa") continue;
+    else icon = tok;
   }
-  return {U'\uf128', false};
+
+  const fa_glyphs::Entry* e = find_fa(icon);
+  if (!e && icon.rfind("fa-", 0) == 0) e = find_fa(icon.substr(3));
+  if (e) return { e->codepoint, pick_style(e->styles, wanted) };
+
+  return {GLYPH_UNKNOWN, FaStyle::Solid};
 }
 
 std::string slugify_color(const std::string& input) {
@@ -90,6 +98,8 @@ std::string slugify_color(const std::string& input) {
   return out;
 }
 
+namespace {
+
 std::string color_class_for(const std::string& color) {
   if (color.rfind("bg-", 0) == 0) {
     return color;
@@ -97,17 +107,17 @@ std::string color_class_for(const std::string& color) {
   return "bg-" + slugify_color(color);
 }
 
-std::vector<std::string> read_args(JsonObject* obj) {
+std::vector<std::string> read_strings(JsonObject* obj, const char* key) {
   std::vector<std::string> args;
-  if (!json_object_has_member(obj, "args")) return args;
-  auto* arr = json_object_get_array_member(obj, "args");
+  if (!json_object_has_member(obj, key)) return args;
+  auto* arr = json_object_get_array_member(obj, key);
   if (!arr) return args;
   const guint n = json_array_get_length(arr);
   args.reserve(n);
   for (guint i = 0; i < n; ++i) {
     auto* node = json_array_get_element(arr, i);
     if (JSON_NODE_HOLDS_VALUE(node)) {
-      args.emplace_back(json_node_get_string(node));
+      if (const char* v = json_node_get_string(node)) args.emplace_back(v);
     }
   }
   return args;
@@ -138,13 +148,125 @@ const std::unordered_map<std::string, std::string>& default_palette_map() {
   return map;
 }
 
-std::vector<IconSpec> read_page(JsonObject* root,
-                                const char* key,
-                                std::unordered_map<std::string, std::string>& palette) {
-  std::vector<IconSpec> out;
-  if (!json_object_has_member(root, key)) return out;
+using PaletteMap = std::unordered_map<std::string, std::string>;
+
+// Configs at least this big are parsed with the streaming reader instead of the DOM.
+constexpr std::size_t kStreamThreshold = 256 * 1024;
+
+// One commandsN entry as read from JSON, before glyph/palette resolution.
+// Both the DOM and the streaming reader fill this.
+struct IconFields {
+  std::string name;
+  std::string title;
+  std::string fa;
+  std::string bg = "#455A64";
+  std::string cmd;
+  std::vector<std::string> args;
+  std::vector<std::string> prewarm;
+  int cpu_pct = -1;  // -1: inherit the root "budgets"
+  int rss_mb = -1;
+};
+
+void append_icon(IconFields&& f, std::vector<IconSpec>& out, PaletteMap& palette) {
+  if (f.fa.empty()) return;
+
+  auto glyph = glyph_for_image(f.fa);
+  std::string class_name = color_class_for(f.bg);
+  if (!f.bg.empty()) {
+    if (f.bg.rfind("bg-", 0) == 0) {
+      auto it = default_palette_map().find(f.bg);
+      if (it != default_palette_map().end()) {
+        palette[class_name] = it->second;
+      }
+    } else {
+      palette[class_name] = f.bg;
+    }
+  }
+
+  IconSpec spec;
+  spec.codepoint = glyph.codepoint;
+  spec.style = glyph.style;
+  spec.label = std::move(f.title);
+  spec.colorClass = std::move(class_name);
+  spec.command = std::move(f.cmd);
+  spec.args = std::move(f.args);
+  spec.prewarm = std::move(f.prewarm);
+  spec.budget = { f.cpu_pct, f.rss_mb };
+  spec.name = std::move(f.name);
+
+  out.push_back(std::move(spec));
+}
+
+// Pages as found in the file, before ordering/splitting by finish_pages().
+struct RawPages {
+  std::map<int, std::vector<IconSpec>> numbered;  // commandsN
+  std::vector<std::vector<IconSpec>> listed;      // "pages": [[...], ...]
+  bool has_listed = false;
+  Budget budgets;                                 // root defaults
+};
+
+// "commands7" -> 7; 0 for anything else.
+int commands_index(const std::string& key) {
+  if (key.rfind("commands", 0) != 0 || key.size() == 8 || key.size() > 12) return 0;
+  int n = 0;
+  for (std::size_t i = 8; i < key.size(); ++i) {
+    if (key[i] < '0' || key[i] > '9') return 0;
+    n = n * 10 + (key[i] - '0');
+  }
+  return n;
+}
+
+int clamp_grid(gint64 v, int fallback) {
+  if (v < 1) return fallback;
+  return (int)std::min<gint64>(v, kMaxGrid);
+}
 
-  auto* arr = json_object_get_array_member(root, key);
+// "pages" wins over commandsN. Empty pages are dropped and overfull ones
+// continue on the next page, so every page fits the grid.
+void finish_pages(RawPages&& raw, IconConfig& cfg) {
+  std::vector<std::vector<IconSpec>> src;
+  if (raw.has_listed) {
+    src = std::move(raw.listed);
+  } else {
+    for (auto& entry : raw.numbered) src.push_back(std::move(entry.second));
+  }
+
+  for (auto& page : src) {
+    for (auto& spec : page) {
+      if (spec.budget.cpu_pct < 0) spec.budget.cpu_pct = raw.budgets.cpu_pct;
+      if (spec.budget.rss_mb < 0) spec.budget.rss_mb = raw.budgets.rss_mb;
+    }
+  }
+
+  const std::size_t per_page = (std::size_t)(cfg.cols * cfg.rows);
+  cfg.pages.clear();
+  for (auto& page : src) {
+    for (std::size_t i = 0; i < page.size(); i += per_page) {
+      const auto first = page.begin() + i;
+      const auto last = page.begin() + std::min(page.size(), i + per_page);
+      cfg.pages.emplace_back(std::make_move_iterator(first), std::make_move_iterator(last));
+    }
+  }
+}
+
+// {"cpu": 80, "rss_mb": 400}; absent members keep their value.
+void read_budget(JsonObject* obj, const char* key, int& cpu_pct, int& rss_mb) {
+  if (!json_object_has_member(obj, key)) return;
+  auto* node = json_object_get_member(obj, key);
+  if (!JSON_NODE_HOLDS_OBJECT(node)) return;
+  auto* b = json_node_get_object(node);
+
+  auto num = [b](const char* k, int& out) {
+    if (!json_object_has_member(b, k)) return;
+    auto* v = json_object_get_member(b, k);
+    if (JSON_NODE_HOLDS_VALUE(v)) out = std::max(0, (int)json_node_get_int(v));
+  };
+  num("cpu", cpu_pct);
+  num("rss_mb", rss_mb);
+}
+
+std::vector<IconSpec> read_icons(JsonArray* arr, PaletteMap& palette) {
+  std::vector<IconSpec> out;
   if (!arr) return out;
 
   const guint n = json_array_get_length(arr);
@@ -156,143 +278,637 @@ std::vector<IconSpec> read_page(JsonObject* root,
     auto* obj = json_node_get_object(node);
     if (!obj) continue;
 
+    const char* name = get_string_member(obj, "name", "");
     const char* title = get_string_member(obj, "title", "");
     const char* fa = get_string_member(obj, "fa", "");
     const char* bg = get_string_member(obj, "bg", "#455A64");
     const char* cmd = get_string_member(obj, "cmd", "");
 
-    if (!fa || !*fa) {
-      continue;
-    }
-    auto glyph = glyph_for_image(fa);
-    std::string bg_value = bg ? bg : "#455A64";
-    std::string class_name = color_class_for(bg_value);
-    if (!bg_value.empty()) {
-      if (bg_value.rfind("bg-", 0) == 0) {
-        auto it = default_palette_map().find(bg_value);
-        if (it != default_palette_map().end()) {
-          palette[class_name] = it->second;
+    IconFields f;
+    f.name = name ? name : "";
+    f.title = title ? title : "";
+    f.fa = fa ? fa : "";
+    f.bg = bg ? bg : "#455A64";
+    f.cmd = cmd ? cmd : "";
+    f.args = read_strings(obj, "args");
+    f.prewarm = read_strings(obj, "prewarm");
+    read_budget(obj, "budget", f.cpu_pct, f.rss_mb);
+    append_icon(std::move(f), out, palette);
+  }
+
+  return out;
+}
+
+void read_pages(JsonObject* root, RawPages& raw, PaletteMap& palette) {
+  GList* members = json_object_get_members(root);
+  for (GList* l = members; l; l = l->next) {
+    const std::string key = (const char*)l->data;
+    auto* node = json_object_get_member(root, key.c_str());
+    if (!JSON_NODE_HOLDS_ARRAY(node)) continue;
+
+    if (key == "pages") {
+      raw.has_listed = true;
+      auto* arr = json_node_get_array(node);
+      const guint n = json_array_get_length(arr);
+      for (guint i = 0; i < n; ++i) {
+        auto* page = json_array_get_element(arr, i);
+        if (JSON_NODE_HOLDS_ARRAY(page)) {
+          raw.listed.push_back(read_icons(json_node_get_array(page), palette));
         }
-      } else {
-        palette[class_name] = bg_value;
       }
+    } else if (const int idx = commands_index(key)) {
+      raw.numbered[idx] = read_icons(json_node_get_array(node), palette);
     }
+  }
+  g_list_free(members);
+}
 
-    IconSpec spec;
-    spec.codepoint = glyph.codepoint;
-    spec.isBrand = glyph.isBrand;
-    spec.label = title ? title : "";
-    spec.colorClass = class_name;
-    spec.command = cmd ? cmd : "";
-    spec.args = read_args(obj);
+void read_grid(JsonObject* root, IconConfig& cfg) {
+  if (!json_object_has_member(root, "grid")) return;
+  auto* node = json_object_get_member(root, "grid");
+  if (!JSON_NODE_HOLDS_OBJECT(node)) return;
+  auto* grid = json_node_get_object(node);
+
+  auto num = [grid](const char* key, int fallback) {
+    if (!json_object_has_member(grid, key)) return fallback;
+    auto* v = json_object_get_member(grid, key);
+    if (!JSON_NODE_HOLDS_VALUE(v)) return fallback;
+    return clamp_grid(json_node_get_int(v), fallback);
+  };
+  cfg.cols = num("cols", kCols);
+  cfg.rows = num("rows", kRows);
+}
 
+void read_idle(JsonObject* root, IdleSpec& idle) {
+  if (!json_object_has_member(root, "idle")) return;
+  auto* node = json_object_get_member(root, "idle");
+  if (!JSON_NODE_HOLDS_OBJECT(node)) return;
+  auto* obj = json_node_get_object(node);
+
+  auto value = [obj](const char* key) -> JsonNode* {
+    if (!json_object_has_member(obj, key)) return nullptr;
+    auto* v = json_object_get_member(obj, key);
+    return JSON_NODE_HOLDS_VALUE(v) ? v : nullptr;
+  };
+  if (auto* v = value("after_s")) idle.after_s = std::max(0, (int)json_node_get_int(v));
+  if (auto* v = value("night")) idle.night = json_node_get_boolean(v);
+  if (auto* v = value("backlight")) idle.backlight_pct = std::clamp((int)json_node_get_int(v), 0, 100);
+  if (auto* v = value("backlight_path")) {
+    if (const char* s = json_node_get_string(v)) idle.backlight = s;
+  }
+}
+
+// Scheme names become "theme-<slug>" window classes; one that lands on a
+// class the theme uses for itself is dropped.
+bool set_scheme_name(SchemeSpec& spec, const std::string& name) {
+  spec.name = slugify_color(name);
+  if (Theme::scheme_class(spec) != Theme::kPaletteClass) return true;
+  g_warning("icons.json: scheme name \"%s\" is reserved, scheme ignored", name.c_str());
+  return false;
+}
+
+std::vector<SchemeSpec> read_schemes(JsonObject* root) {
+  std::vector<SchemeSpec> out;
+  if (!json_object_has_member(root, "schemes")) return out;
+
+  auto* arr = json_object_get_array_member(root, "schemes");
+  if (!arr) return out;
+
+  const guint n = json_array_get_length(arr);
+  out.reserve(n);
+
+  for (guint i = 0; i < n; ++i) {
+    auto* node = json_array_get_element(arr, i);
+    if (!JSON_NODE_HOLDS_OBJECT(node)) continue;
+    auto* obj = json_node_get_object(node);
+    if (!obj) continue;
+
+    const char* name = get_string_member(obj, "name", "");
+    if (!name || !*name) continue;
+
+    auto str = [obj](const char* key) {
+      const char* v = get_string_member(obj, key, "");
+      return std::string(v ? v : "");
+    };
+
+    SchemeSpec spec;
+    if (!set_scheme_name(spec, name)) continue;
+    spec.labelColor = str("label");
+    spec.iconColor = str("icon");
+    spec.iconBackground = str("background");
     out.push_back(std::move(spec));
   }
 
   return out;
 }
 
-IconConfig default_icon_config() {
-  IconConfig cfg;
-  cfg.page1 = {
-    { U'\uf5a0', "Freeboard",     false, "bg-azure", "", {} },
-    { U'\uf005', "Sky",           false, "bg-indigo", "", {} },
-    { U'\uf13d', "Moorings",      false, "bg-blue", "", {} },
-    { U'\uf2e7', "Provisioning",  false, "bg-slate", "", {} },
-    { U'\uf5a0', "AvNav",         false, "bg-azure", "", {} },
-
-    { U'\uf21a', "Vessel",        false, "bg-blue", "", {} },
-    { U'\uf013', "SignalK",       false, "bg-teal", "", {} },
-    { U'\uf120', "Terminal",      false, "bg-slate-dark", "", {} },
-    { U'\uf0ae', "Tasks",         false, "bg-slate-dark", "", {} },
-    { U'\uf07b', "Files",         false, "bg-slate", "", {} },
-
-    { U'\uf8d7', "Radio",         false, "bg-purple", "", {} },
-    { U'\uf072', "Drones",        false, "bg-indigo", "", {} },
-    { U'\uf030', "Web Cam",       false, "bg-gray", "", {} },
-    { U'\uf39f', "Messenger",     true,  "bg-blue", "", {} },
-    { U'\uf39e', "Social",        true,  "bg-blue", "", {} },
-  };
+// "Chart" or {"tile": "Autopilot", "after": ["Instruments"]}.
+std::vector<LaunchStep> read_steps(JsonArray* arr) {
+  std::vector<LaunchStep> out;
+  if (!arr) return out;
 
-  cfg.page2 = {
-    { U'\uf5a0', "OpenCPN",       false, "bg-blue", "", {} },
-    { U'\uf624', "KIP",           false, "bg-teal", "", {} },
-    { U'\uf5ba', "Power",         false, "bg-teal-light", "", {} },
-    { U'\uf743', "GRIB",          false, "bg-blue", "", {} },
-    { U'\uf030', "Camera",        false, "bg-gray", "", {} },
-
-    { U'\uf5a0', "qtVlm",         false, "bg-blue", "", {} },
-    { U'\uf624', "Instruments",   false, "bg-teal", "", {} },
-    { U'\uf1d8', "PyPilot",       false, "bg-cyan", "", {} },
-    { U'\uf72e', "Windy",         false, "bg-indigo", "", {} },
-    { U'\uf0e0', "Email",         false, "bg-blue", "", {} },
-
-    { U'\uf001', "Music",         false, "bg-red", "", {} },
-    { U'\uf167', "Video",         true,  "bg-red", "", {} },
-    { U'\uf011', "Commands",      false, "bg-slate-dark", "", {} },
-    { U'\uf76c', "T-Storms",      false, "bg-violet", "", {} },
-    { U'\uf268', "Chrome",        true,  "bg-blue", "", {} },
-  };
+  const guint n = json_array_get_length(arr);
+  out.reserve(n);
+  for (guint i = 0; i < n; ++i) {
+    auto* node = json_array_get_element(arr, i);
+    LaunchStep step;
+    if (JSON_NODE_HOLDS_VALUE(node)) {
+      if (const char* v = json_node_get_string(node)) step.tile = v;
+    } else if (JSON_NODE_HOLDS_OBJECT(node)) {
+      auto* obj = json_node_get_object(node);
+      const char* tile = get_string_member(obj, "tile", "");
+      step.tile = tile ? tile : "";
+      step.after = read_strings(obj, "after");
+    }
+    if (!step.tile.empty()) out.push_back(std::move(step));
+  }
+  return out;
+}
 
-  cfg.palette.reserve(default_palette_map().size());
-  for (const auto& entry : default_palette_map()) {
-    cfg.palette.emplace_back(entry.first, entry.second);
+void read_launch(JsonObject* root, IconConfig& cfg) {
+  if (json_object_has_member(root, "autostart")) {
+    cfg.autostart = read_steps(json_object_get_array_member(root, "autostart"));
+  }
+
+  if (json_object_has_member(root, "scenes")) {
+    if (auto* arr = json_object_get_array_member(root, "scenes")) {
+      const guint n = json_array_get_length(arr);
+      for (guint i = 0; i < n; ++i) {
+        auto* node = json_array_get_element(arr, i);
+        if (!JSON_NODE_HOLDS_OBJECT(node)) continue;
+        auto* obj = json_node_get_object(node);
+        const char* name = get_string_member(obj, "name", "");
+        if (!name || !*name || !json_object_has_member(obj, "tiles")) continue;
+        cfg.scenes.push_back({ name, read_steps(json_object_get_array_member(obj, "tiles")) });
+      }
+    }
+  }
+
+  if (json_object_has_member(root, "launch")) {
+    auto* node = json_object_get_member(root, "launch");
+    if (!JSON_NODE_HOLDS_OBJECT(node)) return;
+    auto* obj = json_node_get_object(node);
+    if (!json_object_has_member(obj, "parallel")) return;
+    auto* v = json_object_get_member(obj, "parallel");
+    if (JSON_NODE_HOLDS_VALUE(v)) {
+      cfg.launch_parallel = std::clamp((int)json_node_get_int(v), 1, kMaxParallelLaunches);
+    }
   }
-  return cfg;
 }
 
-} // namespace
+// ---- Streaming reader (large configs) ----
 
-IconConfig load_icon_config() {
-  const char* env_path = g_getenv("SV_DASHBOARD_CONFIG");
-  std::string config_path;
-  if (env_path && *env_path) {
-    config_path = env_path;
-  } else {
-    const char* cfg_dir = g_get_user_config_dir();
-    config_path = std::string(cfg_dir ? cfg_dir : ".") + "/sv-dashboard-gtk/icons.json";
+using Tok = JsonPull::Tok;
+
+bool stream_string(JsonPull& p, std::string& out) {
+  const Tok t = p.next();
+  if (t == Tok::String) { out = p.text(); return true; }
+  return p.skip(t); // non-string value: keep the default
+}
+
+bool stream_args(JsonPull& p, std::vector<std::string>& out) {
+  Tok t = p.next();
+  if (t != Tok::ArrBegin) return p.skip(t);
+  while ((t = p.next()) != Tok::ArrEnd) {
+    if (t == Tok::String) out.push_back(p.text());
+    else if (!p.skip(t)) return false;
   }
+  return true;
+}
 
-  if (!g_file_test(config_path.c_str(), G_FILE_TEST_EXISTS)) {
-    return default_icon_config();
+bool stream_budget(JsonPull& p, int& cpu_pct, int& rss_mb) {
+  Tok t = p.next();
+  if (t != Tok::ObjBegin) return p.skip(t);
+
+  while ((t = p.next()) != Tok::ObjEnd) {
+    if (t != Tok::Key) return false;
+    const std::string key = p.text();
+    int* out = key == "cpu" ? &cpu_pct : key == "rss_mb" ? &rss_mb : nullptr;
+    t = p.next();
+    if (out && t == Tok::Number) {
+      *out = std::max<int>(0, (int)g_ascii_strtoll(p.text().c_str(), nullptr, 10));
+    } else if (!p.skip(t)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// `opened`: the caller already consumed the '['.
+bool stream_icons(JsonPull& p, std::vector<IconSpec>& out, PaletteMap& palette, bool opened = false) {
+  Tok t;
+  if (!opened && (t = p.next()) != Tok::ArrBegin) return p.skip(t);
+
+  while ((t = p.next()) != Tok::ArrEnd) {
+    if (t != Tok::ObjBegin) {
+      if (!p.skip(t)) return false;
+      continue;
+    }
+
+    IconFields f;
+    while ((t = p.next()) != Tok::ObjEnd) {
+      if (t != Tok::Key) return false;
+      const std::string key = p.text();
+      bool ok = true;
+      if      (key == "name")  ok = stream_string(p, f.name);
+      else if (key == "title") ok = stream_string(p, f.title);
+      else if (key == "fa")    ok = stream_string(p, f.fa);
+      else if (key == "bg")    ok = stream_string(p, f.bg);
+      else if (key == "cmd")   ok = stream_string(p, f.cmd);
+      else if (key == "args")  ok = stream_args(p, f.args);
+      else if (key == "prewarm") ok = stream_args(p, f.prewarm);
+      else if (key == "budget")  ok = stream_budget(p, f.cpu_pct, f.rss_mb);
+      else                     ok = p.skip_value();
+      if (!ok) return false;
+    }
+    append_icon(std::move(f), out, palette);
+  }
+  return true;
+}
+
+bool stream_pages(JsonPull& p, RawPages& raw, PaletteMap& palette) {
+  Tok t = p.next();
+  if (t != Tok::ArrBegin) return p.skip(t);
+
+  raw.has_listed = true;
+  while ((t = p.next()) != Tok::ArrEnd) {
+    if (t != Tok::ArrBegin) {
+      if (!p.skip(t)) return false;
+      continue;
+    }
+    raw.listed.emplace_back();
+    if (!stream_icons(p, raw.listed.back(), palette, /*opened=*/true)) return false;
+  }
+  return true;
+}
+
+bool stream_grid(JsonPull& p, IconConfig& cfg) {
+  Tok t = p.next();
+  if (t != Tok::ObjBegin) return p.skip(t);
+
+  while ((t = p.next()) != Tok::ObjEnd) {
+    if (t != Tok::Key) return false;
+    const std::string key = p.text();
+    const bool cols = key == "cols";
+    if (!cols && key != "rows") {
+      if (!p.skip_value()) return false;
+      continue;
+    }
+    t = p.next();
+    if (t != Tok::Number) {
+      if (!p.skip(t)) return false;
+      continue;
+    }
+    const gint64 v = g_ascii_strtoll(p.text().c_str(), nullptr, 10);
+    if (cols) cfg.cols = clamp_grid(v, kCols);
+    else      cfg.rows = clamp_grid(v, kRows);
+  }
+  return true;
+}
+
+bool stream_idle(JsonPull& p, IdleSpec& idle) {
+  Tok t = p.next();
+  if (t != Tok::ObjBegin) return p.skip(t);
+
+  while ((t = p.next()) != Tok::ObjEnd) {
+    if (t != Tok::Key) return false;
+    const std::string key = p.text();
+    if (key == "backlight_path") {
+      if (!stream_string(p, idle.backlight)) return false;
+      continue;
+    }
+    t = p.next();
+    const gint64 v = t == Tok::Number ? g_ascii_strtoll(p.text().c_str(), nullptr, 10) : 0;
+    if      (key == "after_s" && t == Tok::Number)   idle.after_s = (int)std::max<gint64>(0, v);
+    else if (key == "backlight" && t == Tok::Number) idle.backlight_pct = (int)std::clamp<gint64>(v, 0, 100);
+    else if (key == "night" && (t == Tok::True || t == Tok::False)) idle.night = t == Tok::True;
+    else if (!p.skip(t)) return false;
   }
+  return true;
+}
+
+bool stream_schemes(JsonPull& p, std::vector<SchemeSpec>& out) {
+  Tok t = p.next();
+  if (t != Tok::ArrBegin) return p.skip(t);
+
+  while ((t = p.next()) != Tok::ArrEnd) {
+    if (t != Tok::ObjBegin) {
+      if (!p.skip(t)) return false;
+      continue;
+    }
+
+    SchemeSpec spec;
+    std::string name;
+    while ((t = p.next()) != Tok::ObjEnd) {
+      if (t != Tok::Key) return false;
+      const std::string key = p.text();
+      bool ok = true;
+      if      (key == "name")       ok = stream_string(p, name);
+      else if (key == "label")      ok = stream_string(p, spec.labelColor);
+      else if (key == "icon")       ok = stream_string(p, spec.iconColor);
+      else if (key == "background") ok = stream_string(p, spec.iconBackground);
+      else                          ok = p.skip_value();
+      if (!ok) return false;
+    }
+    if (name.empty() || !set_scheme_name(spec, name)) continue;
+    out.push_back(std::move(spec));
+  }
+  return true;
+}
+
+bool stream_steps(JsonPull& p, std::vector<LaunchStep>& out) {
+  Tok t = p.next();
+  if (t != Tok::ArrBegin) return p.skip(t);
+
+  while ((t = p.next()) != Tok::ArrEnd) {
+    LaunchStep step;
+    if (t == Tok::String) {
+      step.tile = p.text();
+    } else if (t == Tok::ObjBegin) {
+      while ((t = p.next()) != Tok::ObjEnd) {
+        if (t != Tok::Key) return false;
+        const std::string key = p.text();
+        bool ok = true;
+        if      (key == "tile")  ok = stream_string(p, step.tile);
+        else if (key == "after") ok = stream_args(p, step.after);
+        else                     ok = p.skip_value();
+        if (!ok) return false;
+      }
+    } else if (!p.skip(t)) {
+      return false;
+    }
+    if (!step.tile.empty()) out.push_back(std::move(step));
+  }
+  return true;
+}
 
+bool stream_scenes(JsonPull& p, std::vector<SceneSpec>& out) {
+  Tok t = p.next();
+  if (t != Tok::ArrBegin) return p.skip(t);
+
+  while ((t = p.next()) != Tok::ArrEnd) {
+    if (t != Tok::ObjBegin) {
+      if (!p.skip(t)) return false;
+      continue;
+    }
+
+    SceneSpec scene;
+    while ((t = p.next()) != Tok::ObjEnd) {
+      if (t != Tok::Key) return false;
+      const std::string key = p.text();
+      bool ok = true;
+      if      (key == "name")  ok = stream_string(p, scene.name);
+      else if (key == "tiles") ok = stream_steps(p, scene.steps);
+      else                     ok = p.skip_value();
+      if (!ok) return false;
+    }
+    if (!scene.name.empty()) out.push_back(std::move(scene));
+  }
+  return true;
+}
+
+bool stream_launch(JsonPull& p, IconConfig& cfg) {
+  Tok t = p.next();
+  if (t != Tok::ObjBegin) return p.skip(t);
+
+  while ((t = p.next()) != Tok::ObjEnd) {
+    if (t != Tok::Key) return false;
+    const std::string key = p.text();
+    t = p.next();
+    if (key == "parallel" && t == Tok::Number) {
+      const gint64 v = g_ascii_strtoll(p.text().c_str(), nullptr, 10);
+      cfg.launch_parallel = (int)std::clamp<gint64>(v, 1, kMaxParallelLaunches);
+    } else if (!p.skip(t)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool stream_icon_config(const char* data, std::size_t len, IconConfig& cfg,
+                        RawPages& raw, PaletteMap& palette) {
+  JsonPull p(data, len);
+  if (p.next() != Tok::ObjBegin) return false;
+
+  Tok t;
+  while ((t = p.next()) != Tok::ObjEnd) {
+    if (t != Tok::Key) return false;
+    const std::string key = p.text();
+    bool ok = true;
+    if      (key == "pages")   ok = stream_pages(p, raw, palette);
+    else if (key == "grid")    ok = stream_grid(p, cfg);
+    else if (key == "budgets") ok = stream_budget(p, raw.budgets.cpu_pct, raw.budgets.rss_mb);
+    else if (key == "schemes") ok = stream_schemes(p, cfg.schemes);
+    else if (key == "idle")    ok = stream_idle(p, cfg.idle);
+    else if (key == "autostart") ok = stream_steps(p, cfg.autostart);
+    else if (key == "scenes")  ok = stream_scenes(p, cfg.scenes);
+    else if (key == "launch")  ok = stream_launch(p, cfg);
+    else if (const int idx = commands_index(key)) ok = stream_icons(p, raw.numbered[idx], palette);
+    else                       ok = p.skip_value();
+    if (!ok) return false;
+  }
+  return true;
+}
+
+bool dom_icon_config(const char* data, std::size_t len, IconConfig& cfg,
+                     RawPages& raw, PaletteMap& palette_map) {
   GError* error = nullptr;
   JsonParser* parser = json_parser_new();
-  gboolean ok = json_parser_load_from_file(parser, config_path.c_str(), &error);
+  gboolean ok = json_parser_load_from_data(parser, data, (gssize)len, &error);
   if (!ok || error) {
     if (error) g_error_free(error);
     g_object_unref(parser);
-    return default_icon_config();
+    return false;
   }
 
   JsonNode* root_node = json_parser_get_root(parser);
   if (!JSON_NODE_HOLDS_OBJECT(root_node)) {
     g_object_unref(parser);
-    return default_icon_config();
+    return false;
   }
 
   auto* root_obj = json_node_get_object(root_node);
   if (!root_obj) {
     g_object_unref(parser);
-    return default_icon_config();
+    return false;
   }
 
-  std::unordered_map<std::string, std::string> palette_map;
-  IconConfig cfg;
-  cfg.page1 = read_page(root_obj, "commands1", palette_map);
-  cfg.page2 = read_page(root_obj, "commands2", palette_map);
+  read_pages(root_obj, raw, palette_map);
+  read_budget(root_obj, "budgets", raw.budgets.cpu_pct, raw.budgets.rss_mb);
+  read_grid(root_obj, cfg);
+  read_idle(root_obj, cfg.idle);
+  cfg.schemes = read_schemes(root_obj);
+  read_launch(root_obj, cfg);
+
+  g_object_unref(parser);
+  return true;
+}
+
+// Colors are pasted into the generated CSS, where one GTK cannot parse
+// fails the whole sheet. Invalid ones are dropped here with a warning; the
+// tile or scheme then keeps the default.
+bool valid_color(const std::string& color) {
+  GdkRGBA rgba;
+  return gdk_rgba_parse(&rgba, color.c_str());
+}
+
+void drop_invalid_colors(IconConfig& cfg) {
+  auto& palette = cfg.palette;
+  palette.erase(std::remove_if(palette.begin(), palette.end(), [](const auto& entry) {
+    if (valid_color(entry.second)) return false;
+    g_warning("icons.json: invalid color \"%s\" ignored", entry.second.c_str());
+    return true;
+  }), palette.end());
+
+  for (auto& s : cfg.schemes) {
+    for (std::string* color : { &s.labelColor, &s.iconColor, &s.iconBackground }) {
+      if (color->empty() || (color == &s.iconBackground && *color == "palette") || valid_color(*color)) continue;
+      g_warning("icons.json: invalid color \"%s\" in scheme %s ignored", color->c_str(), s.name.c_str());
+      color->clear();
+    }
+  }
+}
+
+bool parse_data(const char* data, std::size_t len, bool stream, IconConfig& cfg) {
+  PaletteMap palette_map;
+  RawPages raw;
+
+  // An empty file maps to null contents.
+  const bool ok = len && (stream ? stream_icon_config(data, len, cfg, raw, palette_map)
+                                 : dom_icon_config(data, len, cfg, raw, palette_map));
+  if (!ok) return false;
+  finish_pages(std::move(raw), cfg);
 
   cfg.palette.reserve(palette_map.size());
   for (const auto& entry : palette_map) {
     cfg.palette.emplace_back(entry.first, entry.second);
   }
+  drop_invalid_colors(cfg);
 
-  g_object_unref(parser);
+  return !cfg.pages.empty();
+}
+
+// Parse icons.json. Returns false (and leaves the caller to fall back) on
+// unreadable/invalid files or configs without any tiles. `src` describes
+// the bytes that were parsed, for the snapshot.
+bool parse_icon_config(const std::string& config_path, IconConfig& cfg,
+                       ConfigCache::Source* src = nullptr) {
+  ConfigCache::Source read;
+  GMappedFile* mf = ConfigCache::map_source(config_path, read);
+  if (!mf) return false;
+  if (src) *src = read;
+
+  const std::size_t len = g_mapped_file_get_length(mf);
+  const bool ok = parse_data(g_mapped_file_get_contents(mf), len, len >= kStreamThreshold, cfg);
+  g_mapped_file_unref(mf);
+  return ok;
+}
+
+} // namespace
 
-  if (cfg.page1.empty() && cfg.page2.empty()) {
+IconConfig default_icon_config() {
+  IconConfig cfg;
+  cfg.pages.resize(2);
+  cfg.pages[0] = {
+    { U'\uf5a0', "Freeboard",     FaStyle::Solid,  "bg-azure", "", {}, {}, {} },
+    { U'\uf005', "Sky",           FaStyle::Solid,  "bg-indigo", "", {}, {}, {} },
+    { U'\uf13d', "Moorings",      FaStyle::Solid,  "bg-blue", "", {}, {}, {} },
+    { U'\uf2e7', "Provisioning",  FaStyle::Solid,  "bg-slate", "", {}, {}, {} },
+    { U'\uf5a0', "AvNav",         FaStyle::Solid,  "bg-azure", "", {}, {}, {} },
+
+    { U'\uf21a', "Vessel",        FaStyle::Solid,  "bg-blue", "", {}, {}, {} },
+    { U'\uf013', "SignalK",       FaStyle::Solid,  "bg-teal", "", {}, {}, {} },
+    { U'\uf120', "Terminal",      FaStyle::Solid,  "bg-slate-dark", "", {}, {}, {} },
+    { U'\uf0ae', "Tasks",         FaStyle::Solid,  "bg-slate-dark", "", {}, {}, {} },
+    { U'\uf07b', "Files",         FaStyle::Solid,  "bg-slate", "", {}, {}, {} },
+
+    { U'\uf8d7', "Radio",         FaStyle::Solid,  "bg-purple", "", {}, {}, {} },
+    { U'\uf072', "Drones",        FaStyle::Solid,  "bg-indigo", "", {}, {}, {} },
+    { U'\uf030', "Web Cam",       FaStyle::Solid,  "bg-gray", "", {}, {}, {} },
+    { U'\uf39f', "Messenger",     FaStyle::Brands, "bg-blue", "", {}, {}, {} },
+    { U'\uf39e', "Social",        FaStyle::Brands, "bg-blue", "", {}, {}, {} },
+  };
+
+  cfg.pages[1] = {
+    { U'\uf5a0', "OpenCPN",       FaStyle::Solid,  "bg-blue", "", {}, {}, {} },
+    { U'\uf624', "KIP",           FaStyle::Solid,  "bg-teal", "", {}, {}, {} },
+    { U'\uf5ba', "Power",         FaStyle::Solid,  "bg-teal-light", "", {}, {}, {} },
+    { U'\uf743', "GRIB",          FaStyle::Solid,  "bg-blue", "", {}, {}, {} },
+    { U'\uf030', "Camera",        FaStyle::Solid,  "bg-gray", "", {}, {}, {} },
+
+    { U'\uf5a0', "qtVlm",         FaStyle::Solid,  "bg-blue", "", {}, {}, {} },
+    { U'\uf624', "Instruments",   FaStyle::Solid,  "bg-teal", "", {}, {}, {} },
+    { U'\uf1d8', "PyPilot",       FaStyle::Solid,  "bg-cyan", "", {}, {}, {} },
+    { U'\uf72e', "Windy",         FaStyle::Solid,  "bg-indigo", "", {}, {}, {} },
+    { U'\uf0e0', "Email",         FaStyle::Solid,  "bg-blue", "", {}, {}, {} },
+
+    { U'\uf001', "Music",         FaStyle::Solid,  "bg-red", "", {}, {}, {} },
+    { U'\uf167', "Video",         FaStyle::Brands, "bg-red", "", {}, {}, {} },
+    { U'\uf011', "Commands",      FaStyle::Solid,  "bg-slate-dark", "", {}, {}, {} },
+    { U'\uf76c', "T-Storms",      FaStyle::Solid,  "bg-violet", "", {}, {}, {} },
+    { U'\uf268', "Chrome",        FaStyle::Brands, "bg-blue", "", {}, {}, {} },
+  };
+
+  cfg.palette.reserve(default_palette_map().size());
+  for (const auto& entry : default_palette_map()) {
+    cfg.palette.emplace_back(entry.first, entry.second);
+  }
+  return cfg;
+}
+
+std::string icon_config_path() {
+  const char* env_path = g_getenv("SV_DASHBOARD_CONFIG");
+  if (env_path && *env_path) return env_path;
+
+  const char* cfg_dir = g_get_user_config_dir();
+  return std::string(cfg_dir ? cfg_dir : ".") + "/sv-dashboard-gtk/icons.json";
+}
+
+IconConfig load_icon_config() {
+  SV_TRACE_SCOPE("load_icon_config");
+  SV_ALLOC_SCOPE(Config);
+
+  const std::string config_path = icon_config_path();
+  if (!g_file_test(config_path.c_str(), G_FILE_TEST_EXISTS)) {
     return default_icon_config();
   }
 
+  // SV_DASHBOARD_NO_CONFIG_CACHE=1 forces a JSON parse (e.g. when debugging the parser).
+  const bool use_cache = !g_getenv("SV_DASHBOARD_NO_CONFIG_CACHE");
+
+  IconConfig cfg;
+  if (use_cache && ConfigCache::load(config_path, cfg)) return cfg;
+
+  ConfigCache::Source src;
+  if (!parse_icon_config(config_path, cfg, &src)) return default_icon_config();
+  if (use_cache) ConfigCache::store(config_path, src, cfg);
+  return cfg;
+}
+
+bool reload_icon_config(IconConfig& out) {
+  SV_TRACE_SCOPE("reload_icon_config");
+  SV_ALLOC_SCOPE(Config);
+
+  const std::string config_path = icon_config_path();
+  if (!g_file_test(config_path.c_str(), G_FILE_TEST_EXISTS)) return false;
+
+  IconConfig cfg;
+  ConfigCache::Source src;
+  if (!parse_icon_config(config_path, cfg, &src)) return false;
+  if (!g_getenv("SV_DASHBOARD_NO_CONFIG_CACHE")) ConfigCache::store(config_path, src, cfg);
+  out = std::move(cfg);
+  return true;
+}
+
+IconConfig load_icon_config_from_file(const std::string& config_path) {
+  IconConfig cfg;
+  if (!parse_icon_config(config_path, cfg)) return default_icon_config();
   return cfg;
 }
+
+bool parse_icon_config_data(const char* data, std::size_t len, bool stream, IconConfig& out) {
+  IconConfig cfg;
+  if (!parse_data(data, len, stream, cfg)) return false;
+  out = std::move(cfg);
+  return true;
+}
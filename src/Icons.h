@@ -1,28 +1,134 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
+// Font Awesome font a glyph is drawn from.
+enum class FaStyle : uint8_t { Solid, Regular, Brands };
+
+// Resource budget for a launched app; 0 = no limit.
+struct Budget {
+  int cpu_pct = 0;  // of one core
+  int rss_mb = 0;
+
+  bool operator==(const Budget&) const = default;
+};
+
 struct IconSpec {
   char32_t codepoint{};
   std::string label;
-  bool isBrand{false};
+  FaStyle style{FaStyle::Solid};
   std::string colorClass;
   std::string command;
   std::vector<std::string> args;
+  std::vector<std::string> prewarm;  // extra files/dirs the app reads at startup
+  Budget budget;                     // tile "budget", else the root "budgets"
+  std::string name;                  // "name": stable id for scenes, status, control
+
+  bool operator==(const IconSpec&) const = default;
+};
+
+// A color scheme. Built-in Day/Dusk/Night can be overridden (by name) and
+// extended from the "schemes" array in icons.json. Empty fields inherit.
+struct SchemeSpec {
+  std::string name;            // CSS-safe slug, e.g. "night"
+  std::string labelColor;      // .tile-label, .nav
+  std::string iconColor;       // glyph color
+  std::string iconBackground;  // CSS color, or "palette" for per-tile bg-* colors
+
+  bool operator==(const SchemeSpec&) const = default;
+};
+
+// Low-power mode after a period without input ("idle" in icons.json).
+struct IdleSpec {
+  int after_s = 300;          // 0 = never
+  bool night = false;         // switch to the Night scheme while idle
+  int backlight_pct = -1;     // brightness while idle, -1 = leave alone
+  std::string backlight;      // /sys/class/backlight/<dev>; empty = first found
+
+  bool operator==(const IdleSpec&) const = default;
+};
+
+// A tile (by name, else title) started from a scene or the autostart list, once the
+// tiles in `after` have come up.
+struct LaunchStep {
+  std::string tile;
+  std::vector<std::string> after;
+
+  bool operator==(const LaunchStep&) const = default;
+};
+
+// Tiles started together ("scenes" in icons.json); a tile with
+// "cmd": "scene" and the scene name in args starts it.
+struct SceneSpec {
+  std::string name;
+  std::vector<LaunchStep> steps;
+
+  bool operator==(const SceneSpec&) const = default;
 };
 
+inline constexpr int kMaxParallelLaunches = 8;
+
+inline constexpr int kCols = 5;
+inline constexpr int kRows = 3;
+inline constexpr int kMaxGrid = 12;
+
 struct IconConfig {
-  std::vector<IconSpec> page1;
-  std::vector<IconSpec> page2;
+  // Never empty pages; none holds more than cols * rows tiles.
+  std::vector<std::vector<IconSpec>> pages;
+  int cols = kCols;
+  int rows = kRows;
   std::vector<std::pair<std::string, std::string>> palette;
+  std::vector<SchemeSpec> schemes;
+  IdleSpec idle;
+  std::vector<LaunchStep> autostart;
+  std::vector<SceneSpec> scenes;
+  int launch_parallel = 1;  // "launch": { "parallel": N }, 1..kMaxParallelLaunches
+
+  bool operator==(const IconConfig&) const = default;
 };
 
+// Resolved icons.json path: $SV_DASHBOARD_CONFIG or <user config dir>/sv-dashboard-gtk/icons.json
+std::string icon_config_path();
+
+// Loads icon_config_path(), falling back to the built-in layout.
 IconConfig load_icon_config();
+IconConfig load_icon_config_from_file(const std::string& path);
+// Parses icons.json text with the streaming reader (`stream`) or the DOM,
+// whatever its size, and without the snapshot; for sv-bench --check-config.
+bool parse_icon_config_data(const char* data, std::size_t len, bool stream, IconConfig& out);
+// The built-in layout used when no icons.json exists.
+IconConfig default_icon_config();
 
-inline constexpr int kCols = 5;
-inline constexpr int kRows = 3;
+// Live reload: parses icon_config_path() (ignoring the snapshot cache, whose
+// mtime granularity can miss quick edits) and refreshes the cache. False if
+// the file is missing or invalid, so the caller keeps its current config.
+bool reload_icon_config(IconConfig& out);
+
+struct GlyphSpec {
+  char32_t codepoint{};
+  FaStyle style{FaStyle::Solid};
+};
+
+// Font Awesome icon name (or launcher alias) -> glyph; unknown names map to U+F128.
+// Covers every free FA icon name/alias via a generated perfect hash (fa_glyphs.h).
+// Accepts "star", "fa-star" and "fa-regular fa-star"; without an explicit
+// style, solid is preferred over regular over brands.
+GlyphSpec glyph_for_image(const std::string& name);
+
+// CSS-class-safe slug ("#1976D2" -> "hex-1976d2", "Sea Green" -> "sea-green").
+std::string slugify_color(const std::string& input);
 
 // Nav chevrons
 inline constexpr char32_t CHEV_LEFT  = U'\uf053';
 inline constexpr char32_t CHEV_RIGHT = U'\uf054';
+
+// Scheme buttons (solid)
+inline constexpr char32_t SCHEME_DAY   = U'\uf185';  // sun
+inline constexpr char32_t SCHEME_DUSK  = U'\uf6c4';  // cloud-sun
+inline constexpr char32_t SCHEME_NIGHT = U'\uf186';  // moon
+
+// Unknown icon names
+inline constexpr char32_t GLYPH_UNKNOWN = U'\uf128';
@@ -0,0 +1,65 @@
+#include "IdleManager.h"
+
+#include <glib.h>
+
+#include <algorithm>
+
+IdleManager::~IdleManager() {
+  timer_.disconnect();
+}
+
+void IdleManager::attach(Gtk::Window& win) {
+  press_ = Gtk::GestureMultiPress::create(win);
+  press_->set_propagation_phase(Gtk::PHASE_CAPTURE);
+  press_->set_button(0);
+  press_->signal_pressed().connect([this](int, double, double) {
+    // Claiming in the capture phase keeps the tap away from the tiles.
+    if (note_input()) press_->set_state(Gtk::EVENT_SEQUENCE_CLAIMED);
+  });
+}
+
+void IdleManager::configure(const IdleSpec& spec) {
+  const bool was_sleeping = sleeping_;
+  if (was_sleeping) wake();
+  spec_ = spec;
+
+  timer_.disconnect();
+  last_input_us_ = g_get_monotonic_time();
+  if (spec_.after_s > 0) arm((int64_t)spec_.after_s * G_USEC_PER_SEC);
+}
+
+bool IdleManager::note_input() {
+  last_input_us_ = g_get_monotonic_time();
+  if (!sleeping_) return false;
+  wake();
+  return true;
+}
+
+void IdleManager::arm(int64_t in_us) {
+  // Whole seconds, so GLib may batch the wakeup with others.
+  const guint s = (guint)std::max<int64_t>(1, (in_us + G_USEC_PER_SEC - 1) / G_USEC_PER_SEC);
+  timer_ = Glib::signal_timeout().connect_seconds(sigc::mem_fun(*this, &IdleManager::on_timer), s);
+}
+
+bool IdleManager::on_timer() {
+  const int64_t idle_us = g_get_monotonic_time() - last_input_us_;
+  const int64_t after_us = (int64_t)spec_.after_s * G_USEC_PER_SEC;
+  if (idle_us >= after_us) sleep();
+  else arm(after_us - idle_us);  // input since arming: check again when it would expire
+  return false;
+}
+
+void IdleManager::sleep() {
+  if (sleeping_) return;
+  sleeping_ = true;
+  g_debug("idle: sleeping after %d s", spec_.after_s);
+  changed_.emit(true);
+}
+
+void IdleManager::wake() {
+  if (!sleeping_) return;
+  sleeping_ = false;
+  changed_.emit(false);
+  g_debug("idle: awake");
+  if (spec_.after_s > 0) arm((int64_t)spec_.after_s * G_USEC_PER_SEC);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <gtkmm/gesturemultipress.h>
+#include <gtkmm/window.h>
+#include <glibmm/main.h>
+#include <sigc++/signal.h>
+
+#include <cstdint>
+#include <string>
+
+#include "Icons.h"
+
+// Low-power mode after IdleSpec::after_s without a tap or key press.
+// Input only stamps a time; a single timer per idle period checks it, so an
+// active dashboard costs no extra wakeups. signal_changed(true) tells the
+// window to stop its periodic work; MainApp dims the backlight once every
+// window is asleep (Backlight).
+// The first tap or key wakes it synchronously (before the next frame) and is
+// swallowed, so touching a dark screen never launches anything.
+class IdleManager {
+public:
+  IdleManager() = default;
+  ~IdleManager();
+
+  IdleManager(const IdleManager&) = delete;
+  IdleManager& operator=(const IdleManager&) = delete;
+
+  // Watches presses on `win` (capture phase).
+  void attach(Gtk::Window& win);
+  void configure(const IdleSpec& spec);
+
+  // Call for input the press gesture does not see (keys). Returns true if
+  // the event woke the dashboard and should not be handled further.
+  bool note_input();
+
+  bool sleeping() const { return sleeping_; }
+  sigc::signal<void(bool)>& signal_changed() { return changed_; }
+
+private:
+  void arm(int64_t in_us);
+  bool on_timer();
+  void sleep();
+  void wake();
+
+  IdleSpec spec_;
+  int64_t last_input_us_ = 0;
+  sigc::connection timer_;
+  Glib::RefPtr<Gtk::GestureMultiPress> press_;
+  bool sleeping_ = false;
+
+
+  sigc::signal<void(bool)> changed_;
+};
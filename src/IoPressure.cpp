@@ -0,0 +1,40 @@
+#include "IoPressure.h"
+
+#include <glib.h>
+
+#include <cstdio>
+
+namespace IoPressure {
+
+bool read(Sample& out) {
+#ifdef __linux__
+  FILE* f = std::fopen("/proc/pressure/io", "r");
+  if (!f) return false;
+  double avg10 = 0.0;
+  unsigned long long total = 0;
+  // "some avg10=1.23 avg60=0.50 avg300=0.10 total=123456"
+  const bool ok = std::fscanf(f, "some avg10=%lf avg60=%*f avg300=%*f total=%llu", &avg10, &total) == 2;
+  std::fclose(f);
+  if (!ok) return false;
+  out.avg10 = avg10;
+  out.total_us = total;
+  return true;
+#else
+  (void)out;
+  return false;
+#endif
+}
+
+bool busy(double max_pct) {
+  Sample s;
+  if (read(s)) return s.avg10 > max_pct;
+
+  double load = 0.0;
+  if (FILE* f = std::fopen("/proc/loadavg", "r")) {
+    if (std::fscanf(f, "%lf", &load) != 1) load = 0.0;
+    std::fclose(f);
+  }
+  return load > (double)g_get_num_processors();
+}
+
+} // namespace IoPressure
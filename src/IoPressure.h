@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+// System-wide I/O contention from /proc/pressure/io ("some" line), for work
+// that should yield to the disk: prewarming and staged launches. Without PSI
+// (old kernels, non-Linux) the load average stands in.
+namespace IoPressure {
+
+struct Sample {
+  double avg10 = 0.0;     // % of the last 10 s some task waited on I/O
+  uint64_t total_us = 0;  // cumulative stall time
+};
+
+// False if PSI is unavailable.
+bool read(Sample& out);
+
+// avg10 above max_pct; without PSI, a load average above the CPU count.
+bool busy(double max_pct);
+
+} // namespace IoPressure
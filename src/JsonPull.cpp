@@ -0,0 +1,119 @@
+#include "JsonPull.h"
+
+#include <glib.h>
+
+#include <cstring>
+
+void JsonPull::skip_ws() {
+  while (p_ < end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r' || *p_ == ',')) ++p_;
+}
+
+static int hex4(const char* s) {
+  int v = 0;
+  for (int i = 0; i < 4; ++i) {
+    const int d = g_ascii_xdigit_value(s[i]);
+    if (d < 0) return -1;
+    v = (v << 4) | d;
+  }
+  return v;
+}
+
+bool JsonPull::read_string() {
+  // p_ is just past the opening quote
+  text_.clear();
+  while (p_ < end_) {
+    const char c = *p_++;
+    if (c == '"') return true;
+    if (c == '\0') return false;  // json-glib rejects it too (UTF-8 check)
+    if (c != '\\') { text_.push_back(c); continue; }
+    if (p_ >= end_) return false;
+
+    const char e = *p_++;
+    switch (e) {
+      case '"': case '\\': case '/': text_.push_back(e); break;
+      case 'b': text_.push_back('\b'); break;
+      case 'f': text_.push_back('\f'); break;
+      case 'n': text_.push_back('\n'); break;
+      case 'r': text_.push_back('\r'); break;
+      case 't': text_.push_back('\t'); break;
+      case 'u': {
+        if (end_ - p_ < 4) return false;
+        int cp = hex4(p_);
+        if (cp < 0) return false;
+        p_ += 4;
+        // Surrogate pair
+        if (cp >= 0xD800 && cp <= 0xDBFF && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+          const int lo = hex4(p_ + 2);
+          if (lo >= 0xDC00 && lo <= 0xDFFF) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+            p_ += 6;
+          }
+        }
+        gchar buf[8] = {0};
+        const int len = g_unichar_to_utf8((gunichar)cp, buf);
+        text_.append(buf, len);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+JsonPull::Tok JsonPull::next() {
+  skip_ws();
+  if (p_ >= end_) return Tok::End;
+
+  const char c = *p_;
+  switch (c) {
+    case '{': ++p_; return Tok::ObjBegin;
+    case '}': ++p_; return Tok::ObjEnd;
+    case '[': ++p_; return Tok::ArrBegin;
+    case ']': ++p_; return Tok::ArrEnd;
+    case '"': {
+      ++p_;
+      if (!read_string()) return Tok::Error;
+      skip_ws();
+      if (p_ < end_ && *p_ == ':') { ++p_; return Tok::Key; }
+      return Tok::String;
+    }
+    default:
+      break;
+  }
+
+  auto literal = [this](const char* word) {
+    const std::size_t n = std::strlen(word);
+    if ((std::size_t)(end_ - p_) < n || std::memcmp(p_, word, n) != 0) return false;
+    p_ += n;
+    return true;
+  };
+  if (literal("true"))  return Tok::True;
+  if (literal("false")) return Tok::False;
+  if (literal("null"))  return Tok::Null;
+
+  if (c == '-' || (c >= '0' && c <= '9')) {
+    const char* b = p_;
+    // strchr() would also match the terminator, i.e. an embedded NUL.
+    while (p_ < end_ && ((*p_ && std::strchr("+-.eE", *p_)) || (*p_ >= '0' && *p_ <= '9'))) ++p_;
+    text_.assign(b, p_);
+    return Tok::Number;
+  }
+  return Tok::Error;
+}
+
+bool JsonPull::skip(Tok first) {
+  int depth = 0;
+  Tok t = first;
+  for (;;) {
+    switch (t) {
+      case Tok::ObjBegin: case Tok::ArrBegin: ++depth; break;
+      case Tok::ObjEnd:   case Tok::ArrEnd:   --depth; break;
+      case Tok::Key: break;
+      case Tok::End: case Tok::Error: return false;
+      default: break;
+    }
+    if (depth <= 0 && t != Tok::Key) return depth == 0;
+    t = next();
+  }
+}
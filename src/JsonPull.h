@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Minimal pull tokenizer over an in-memory JSON document. Used for large
+// icons.json files so they are read in one pass without building a json-glib
+// DOM. ',' and ':' are consumed implicitly; a string followed by ':' is
+// reported as Key. Structure is not validated beyond what the reader needs.
+class JsonPull {
+public:
+  enum class Tok { ObjBegin, ObjEnd, ArrBegin, ArrEnd, Key, String, Number, True, False, Null, End, Error };
+
+  JsonPull(const char* data, std::size_t len) : p_(data), end_(data + len) {}
+
+  Tok next();
+
+  // Unescaped text of the last Key/String, or raw text of the last Number.
+  const std::string& text() const { return text_; }
+
+  // Skip the value whose first token was `first` (nested containers included).
+  bool skip(Tok first);
+  // Skip the next complete value.
+  bool skip_value() { return skip(next()); }
+
+private:
+  bool read_string();
+  void skip_ws();
+
+  const char* p_;
+  const char* end_;
+  std::string text_;
+};
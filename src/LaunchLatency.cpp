@@ -0,0 +1,321 @@
+#include "LaunchLatency.h"
+#include "RuntimeEnv.h"
+#include "X11Util.h"
+
+#include <glib.h>
+#include <json-glib/json-glib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+std::string latency_path() {
+  gchar* p = g_build_filename(g_get_user_cache_dir(), "sv-dashboard-gtk", "launch-latency.json", nullptr);
+  std::string out = p ? p : "";
+  g_free(p);
+  return out;
+}
+
+pid_t parent_of(pid_t pid) {
+#ifdef __linux__
+  char path[64];
+  g_snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+  gchar* data = nullptr;
+  if (!g_file_get_contents(path, &data, nullptr, nullptr)) return 0;
+  // "pid (comm) state ppid ..."; comm may contain spaces/parens.
+  int ppid = 0;
+  const char* close = std::strrchr(data, ')');
+  if (close && std::sscanf(close + 1, " %*c %d", &ppid) != 1) ppid = 0;
+  g_free(data);
+  return (pid_t)ppid;
+#else
+  (void)pid;
+  return 0;
+#endif
+}
+
+bool is_same_or_descendant(pid_t pid, pid_t ancestor) {
+  for (int depth = 0; pid > 1 && depth < 16; ++depth) {
+    if (pid == ancestor) return true;
+    pid = parent_of(pid);
+  }
+  return false;
+}
+
+int bucket_for(double ms) {
+  if (ms <= LaunchLatency::kBaseMs) return 0;
+  const int b = (int)std::ceil(2.0 * std::log2(ms / LaunchLatency::kBaseMs));
+  return std::clamp(b, 0, LaunchLatency::kBuckets - 1);
+}
+
+double bucket_bound(int b) {
+  return LaunchLatency::kBaseMs * std::exp2(b / 2.0);
+}
+
+} // namespace
+
+void LaunchLatency::Histogram::add(double ms, double spawn_ms) {
+  min_ms = count ? std::min(min_ms, ms) : ms;
+  max_ms = count ? std::max(max_ms, ms) : ms;
+  ++count;
+  sum_ms += ms;
+  spawn_sum_ms += spawn_ms;
+  ++buckets[bucket_for(ms)];
+}
+
+double LaunchLatency::Histogram::percentile(double p) const {
+  if (!count) return 0.0;
+  const double want = p * (double)count;
+  uint64_t seen = 0;
+  for (int b = 0; b < kBuckets; ++b) {
+    seen += buckets[b];
+    if ((double)seen >= want) return std::min(bucket_bound(b), max_ms);
+  }
+  return max_ms;
+}
+
+LaunchLatency& LaunchLatency::instance() {
+  static LaunchLatency latency;
+  return latency;
+}
+
+void LaunchLatency::track(const std::string& tile, int64_t press_us, int64_t spawn_us, pid_t pid) {
+  if (!watching_) {
+    watching_ = watch_client_list([this] { on_clients_changed(); });
+    if (!watching_) return;  // not X11: nothing to measure against
+  }
+
+  if (pending_.empty()) {
+    // Only windows mapped from now on can belong to this launch.
+    known_windows_.clear();
+    for (const auto& cw : client_windows()) known_windows_.push_back(cw.xid);
+  }
+  pending_.push_back({ tile, press_us, spawn_us, pid });
+  arm_timeout();
+}
+
+void LaunchLatency::arm_timeout() {
+  if (suspended_ || timeout_.connected() || pending_.empty()) return;
+  timeout_ = Glib::signal_timeout().connect_seconds(
+      sigc::mem_fun(*this, &LaunchLatency::on_timeout_check), 5);
+}
+
+void LaunchLatency::suspend() {
+  suspended_ = true;
+  timeout_.disconnect();
+  flush();  // no timer left to wake an idle dashboard
+}
+
+void LaunchLatency::resume() {
+  suspended_ = false;
+  arm_timeout();
+}
+
+void LaunchLatency::finish(std::vector<Pending>::iterator it, int64_t now_us) {
+  if (!loaded_) load();
+
+  const double ms = (now_us - it->press_us) / 1000.0;
+  hist_[it->tile].add(ms, (it->spawn_us - it->press_us) / 1000.0);
+  last_tile_ = it->tile;
+  last_ms_ = ms;
+  g_debug("launch latency %s: %.0f ms", it->tile.c_str(), ms);
+
+  const std::string tile = it->tile;
+  pending_.erase(it);
+  if (pending_.empty()) timeout_.disconnect();
+  mark_dirty();
+  settled_.emit(tile);
+}
+
+void LaunchLatency::on_clients_changed() {
+  if (pending_.empty()) return;
+  const int64_t now = g_get_monotonic_time();
+
+  std::vector<unsigned long> current;
+  for (const auto& cw : client_windows()) {
+    current.push_back(cw.xid);
+    if (std::find(known_windows_.begin(), known_windows_.end(), cw.xid) != known_windows_.end()) continue;
+    if (!cw.pid) continue;
+
+    auto it = std::find_if(pending_.begin(), pending_.end(),
+                           [&cw](const Pending& p) { return is_same_or_descendant(cw.pid, p.pid); });
+    if (it != pending_.end()) finish(it, now);
+  }
+  known_windows_ = std::move(current);
+}
+
+void LaunchLatency::child_exited(pid_t pid) {
+  auto it = std::find_if(pending_.begin(), pending_.end(), [pid](const Pending& p) { return p.pid == pid; });
+  if (it == pending_.end()) return;
+
+  if (!loaded_) load();
+  const std::string tile = it->tile;
+  ++hist_[tile].exited;
+  pending_.erase(it);
+  if (pending_.empty()) timeout_.disconnect();
+  mark_dirty();
+  settled_.emit(tile);
+}
+
+bool LaunchLatency::on_timeout_check() {
+  const int64_t now = g_get_monotonic_time();
+  bool changed = false;
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (now - it->press_us > (int64_t)kTimeoutS * G_USEC_PER_SEC) {
+      if (!loaded_) load();
+      ++hist_[it->tile].timeouts;
+      it = pending_.erase(it);
+      changed = true;
+    } else {
+      ++it;
+    }
+  }
+  if (changed) mark_dirty();
+  return !pending_.empty();
+}
+
+// ---- persistence ----
+
+void LaunchLatency::load() {
+  loaded_ = true;
+
+  JsonParser* parser = json_parser_new();
+  if (!json_parser_load_from_file(parser, latency_path().c_str(), nullptr)) {
+    g_object_unref(parser);
+    return;
+  }
+
+  JsonNode* root = json_parser_get_root(parser);
+  JsonObject* tiles = nullptr;
+  if (JSON_NODE_HOLDS_OBJECT(root)) {
+    JsonObject* obj = json_node_get_object(root);
+    if (json_object_has_member(obj, "tiles")) tiles = json_object_get_object_member(obj, "tiles");
+  }
+
+  GList* names = tiles ? json_object_get_members(tiles) : nullptr;
+  for (GList* l = names; l; l = l->next) {
+    const char* name = (const char*)l->data;
+    JsonNode* node = json_object_get_member(tiles, name);
+    if (!JSON_NODE_HOLDS_OBJECT(node)) continue;
+    JsonObject* o = json_node_get_object(node);
+
+    auto num = [o](const char* key) {
+      return json_object_has_member(o, key) ? json_object_get_double_member(o, key) : 0.0;
+    };
+
+    Histogram h;
+    h.count = (uint64_t)num("count");
+    h.timeouts = (uint64_t)num("timeouts");
+    h.exited = (uint64_t)num("exited");
+    h.sum_ms = num("sum_ms");
+    h.min_ms = num("min_ms");
+    h.max_ms = num("max_ms");
+    h.spawn_sum_ms = num("spawn_sum_ms");
+    if (json_object_has_member(o, "buckets")) {
+      JsonArray* arr = json_object_get_array_member(o, "buckets");
+      const guint n = arr ? std::min<guint>(json_array_get_length(arr), kBuckets) : 0;
+      for (guint i = 0; i < n; ++i) h.buckets[i] = (uint32_t)json_array_get_int_element(arr, i);
+    }
+    hist_[name] = h;
+  }
+  g_list_free(names);
+  g_object_unref(parser);
+}
+
+std::string LaunchLatency::to_json() {
+  if (!loaded_) load();
+
+  JsonBuilder* b = json_builder_new();
+  json_builder_begin_object(b);
+  json_builder_set_member_name(b, "version");
+  json_builder_add_int_value(b, 1);
+  json_builder_set_member_name(b, "bucket_base_ms");
+  json_builder_add_double_value(b, kBaseMs);
+
+  json_builder_set_member_name(b, "tiles");
+  json_builder_begin_object(b);
+  for (const auto& [tile, h] : hist_) {
+    json_builder_set_member_name(b, tile.c_str());
+    json_builder_begin_object(b);
+
+    auto member = [b](const char* key, double v) {
+      json_builder_set_member_name(b, key);
+      json_builder_add_double_value(b, v);
+    };
+    member("count", (double)h.count);
+    member("timeouts", (double)h.timeouts);
+    member("exited", (double)h.exited);
+    member("sum_ms", h.sum_ms);
+    member("min_ms", h.min_ms);
+    member("max_ms", h.max_ms);
+    member("spawn_sum_ms", h.spawn_sum_ms);
+    member("p50_ms", h.percentile(0.50));
+    member("p90_ms", h.percentile(0.90));
+
+    json_builder_set_member_name(b, "buckets");
+    json_builder_begin_array(b);
+    for (auto c : h.buckets) json_builder_add_int_value(b, c);
+    json_builder_end_array(b);
+
+    json_builder_end_object(b);
+  }
+  json_builder_end_object(b);
+  json_builder_end_object(b);
+
+  JsonGenerator* gen = json_generator_new();
+  json_generator_set_pretty(gen, TRUE);
+  JsonNode* root = json_builder_get_root(b);
+  json_generator_set_root(gen, root);
+  gchar* text = json_generator_to_data(gen, nullptr);
+  std::string out = text ? text : "{}";
+  g_free(text);
+  json_node_free(root);
+  g_object_unref(gen);
+  g_object_unref(b);
+  return out + "\n";
+}
+
+// Settles come while the launched app maps its window; the JSON rebuild
+// and write wait until things are quiet.
+void LaunchLatency::mark_dirty() {
+  if (save_timer_.connected()) return;
+  save_timer_ = Glib::signal_timeout().connect_seconds([this] {
+    save();
+    return false;
+  }, kSaveDelayS);
+}
+
+void LaunchLatency::flush() {
+  if (!save_timer_.connected()) return;
+  save_timer_.disconnect();
+  save();
+}
+
+void LaunchLatency::save() {
+  const std::string path = latency_path();
+  gchar* dir = g_path_get_dirname(path.c_str());
+  RuntimeEnv::ensureDir(dir);
+  g_free(dir);
+
+  const std::string json = to_json();
+  GError* error = nullptr;
+  if (!g_file_set_contents(path.c_str(), json.data(), (gssize)json.size(), &error)) {
+    g_warning("LaunchLatency: cannot write %s: %s", path.c_str(), error ? error->message : "?");
+    if (error) g_error_free(error);
+  }
+}
+
+std::string LaunchLatency::hud_line() const {
+  if (last_tile_.empty()) return {};
+  const auto it = hist_.find(last_tile_);
+  if (it == hist_.end()) return {};
+
+  char buf[160];
+  std::snprintf(buf, sizeof(buf), "launch %.16s %5.0f ms  p50 %.0f  p90 %.0f  n %llu",
+                last_tile_.c_str(), last_ms_, it->second.percentile(0.50),
+                it->second.percentile(0.90), (unsigned long long)it->second.count);
+  return buf;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <glibmm/main.h>
+#include <sigc++/signal.h>
+#include <sys/types.h>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Tap-to-window latency per tile: from the button press, through spawn, to
+// the first top-level window the child (or one of its descendants) maps,
+// detected from _NET_CLIENT_LIST changes on the X11 root window. Each tile
+// keeps a log-bucketed histogram persisted in
+// $XDG_CACHE_HOME/sv-dashboard-gtk/launch-latency.json; `--dump-launch-latency`
+// prints it and the HUD shows the last launch. Without X11 nothing is measured.
+class LaunchLatency {
+public:
+  static LaunchLatency& instance();
+
+  // press_us/spawn_us: g_get_monotonic_time() of the press and of spawn.
+  void track(const std::string& tile, int64_t press_us, int64_t spawn_us, pid_t pid);
+  // The child exited before mapping a window.
+  void child_exited(pid_t pid);
+
+  // A tracked launch mapped its first window or exited (tile key).
+  sigc::signal<void(const std::string&)>& signal_settled() { return settled_; }
+
+  // Idle mode: drops the timeout check; pending launches keep waiting.
+  void suspend();
+  void resume();
+
+  // Writes unsaved histograms now (exit, idle); otherwise they are written
+  // kSaveDelayS after a launch settles.
+  void flush();
+
+  // Bucket i holds samples <= kBaseMs * 2^(i/2): 10 ms .. ~8 min.
+  static constexpr int kBuckets = 36;
+  static constexpr double kBaseMs = 10.0;
+
+  struct Histogram {
+    uint64_t count = 0;
+    uint64_t timeouts = 0;   // no window within kTimeoutS
+    uint64_t exited = 0;     // exited without a window
+    double sum_ms = 0.0;
+    double min_ms = 0.0;
+    double max_ms = 0.0;
+    double spawn_sum_ms = 0.0;  // press -> g_spawn_async returned
+    std::array<uint32_t, kBuckets> buckets{};
+
+    void add(double ms, double spawn_ms);
+    double percentile(double p) const;  // bucket upper bound
+  };
+
+  std::string to_json();
+  // One line for the HUD; empty until a launch completed this session.
+  std::string hud_line() const;
+
+private:
+  LaunchLatency() = default;
+
+  struct Pending {
+    std::string tile;
+    int64_t press_us;
+    int64_t spawn_us;
+    pid_t pid;
+  };
+
+  void load();
+  void save();
+  void mark_dirty();
+  void on_clients_changed();
+  bool on_timeout_check();
+  void arm_timeout();
+  void finish(std::vector<Pending>::iterator it, int64_t now_us);
+
+  static constexpr int kTimeoutS = 120;
+  static constexpr unsigned kSaveDelayS = 10;
+
+  std::map<std::string, Histogram> hist_;
+  bool loaded_ = false;
+  bool watching_ = false;
+
+  std::vector<Pending> pending_;
+  std::vector<unsigned long> known_windows_;
+  sigc::connection timeout_;
+  sigc::connection save_timer_;
+  bool suspended_ = false;
+
+  std::string last_tile_;
+  double last_ms_ = 0.0;
+
+  sigc::signal<void(const std::string&)> settled_;
+};
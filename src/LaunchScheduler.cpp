@@ -0,0 +1,158 @@
+#include "LaunchScheduler.h"
+#include "LaunchLatency.h"
+#include "Launcher.h"
+#include "Trace.h"
+
+#include <glib.h>
+
+#include <algorithm>
+
+LaunchScheduler& LaunchScheduler::instance() {
+  static LaunchScheduler scheduler;
+  return scheduler;
+}
+
+LaunchScheduler::LaunchScheduler() {
+  LaunchLatency::instance().signal_settled().connect(sigc::mem_fun(*this, &LaunchScheduler::on_settled));
+}
+
+void LaunchScheduler::set_config(std::shared_ptr<const IconConfig> config) {
+  config_ = std::move(config);
+}
+
+const IconSpec* LaunchScheduler::find_tile(const std::string& tile) const {
+  return config_ ? Launcher::find_tile(*config_, tile) : nullptr;
+}
+
+std::string LaunchScheduler::key_for(const std::string& tile) const {
+  const IconSpec* spec = find_tile(tile);
+  return spec ? Launcher::tile_key(*spec) : tile;
+}
+
+int LaunchScheduler::run(const std::vector<LaunchStep>& steps) {
+  int queued = 0;
+  for (const auto& step : steps) {
+    const IconSpec* spec = find_tile(step.tile);
+    if (!spec) {
+      g_warning("LaunchScheduler: no tile \"%s\"", step.tile.c_str());
+      continue;
+    }
+    if (spec->command == "scene") {
+      g_warning("LaunchScheduler: \"%s\" starts a scene; scenes do not nest", step.tile.c_str());
+      continue;
+    }
+    // Steps may name a tile by name or title; settles report tile_key.
+    std::vector<std::string> after;
+    for (const auto& dep : step.after) after.push_back(key_for(dep));
+    queue_.push_back({ Launcher::tile_key(*spec), *spec, std::move(after) });
+    ++queued;
+  }
+  if (queued) pump();
+  return queued;
+}
+
+bool LaunchScheduler::run_scene(const std::string& name) {
+  if (!config_) return false;
+  for (const auto& scene : config_->scenes) {
+    if (scene.name != name) continue;
+    g_debug("LaunchScheduler: scene %s (%zu tiles)", name.c_str(), scene.steps.size());
+    run(scene.steps);
+    return true;
+  }
+  return false;
+}
+
+bool LaunchScheduler::waiting_on(const Job& job) const {
+  for (const auto& dep : job.after) {
+    if (dep == job.tile) continue;
+    for (const auto& q : queue_) {
+      if (q.tile == dep) return true;
+    }
+    for (const auto& r : running_) {
+      if (r.tile == dep) return true;
+    }
+  }
+  return false;
+}
+
+// Stall share since the previous check when that was recent, else PSI's own
+// 10 s average (which lags a launch that just finished reading).
+bool LaunchScheduler::io_stalled(int64_t now) {
+  IoPressure::Sample s;
+  if (!IoPressure::read(s)) return IoPressure::busy(kMaxStall * 100.0);
+
+  const int64_t dt = now - last_io_us_;
+  const bool recent = last_io_us_ && dt >= 100000 && dt <= 2 * (int64_t)kMaxBackoffMs * 1000 &&
+                      s.total_us >= last_io_.total_us;
+  const double stall = recent ? (double)(s.total_us - last_io_.total_us) / (double)dt : s.avg10 / 100.0;
+  last_io_ = s;
+  last_io_us_ = now;
+  return stall > kMaxStall;
+}
+
+void LaunchScheduler::schedule(unsigned delay_ms) {
+  timer_.disconnect();
+  timer_ = Glib::signal_timeout().connect([this] {
+    pump();
+    return false;
+  }, delay_ms);
+}
+
+void LaunchScheduler::pump() {
+  SV_TRACE_SCOPE("LaunchScheduler::pump");
+  timer_.disconnect();
+  const int64_t now = g_get_monotonic_time();
+
+  // Launches that never reported back give up their slot.
+  running_.erase(std::remove_if(running_.begin(), running_.end(),
+                                [now](const Running& r) { return r.deadline_us <= now; }),
+                 running_.end());
+
+  const int cap = config_ ? config_->launch_parallel : 1;
+  while (!queue_.empty() && (int)running_.size() < cap) {
+    auto it = std::find_if(queue_.begin(), queue_.end(), [this](const Job& j) { return !waiting_on(j); });
+    // Nothing running and nothing ready: the `after` lists form a cycle.
+    const bool cycle = it == queue_.end();
+    if (cycle) {
+      if (!running_.empty()) break;  // a settle frees the dependents
+      it = queue_.begin();
+    }
+
+    if (io_stalled(now)) {
+      if (!io_wait_since_us_) io_wait_since_us_ = now;
+      if (now - io_wait_since_us_ < kMaxIoWaitS * G_USEC_PER_SEC) {
+        backoff_ms_ = backoff_ms_ ? std::min(backoff_ms_ * 2, kMaxBackoffMs) : kMinBackoffMs;
+        schedule(backoff_ms_);
+        return;
+      }
+      g_debug("LaunchScheduler: I/O still stalled after %d s, starting %s anyway",
+              (int)kMaxIoWaitS, it->tile.c_str());
+    }
+    io_wait_since_us_ = 0;
+    backoff_ms_ = 0;
+    if (cycle) g_warning("LaunchScheduler: dependency cycle, starting \"%s\" first", it->tile.c_str());
+
+    Job job = std::move(*it);
+    queue_.erase(it);
+    g_debug("LaunchScheduler: starting %s (%zu queued, %zu running)",
+            job.tile.c_str(), queue_.size(), running_.size());
+    // Nothing spawned (already running, failed): nothing to wait for.
+    if (Launcher::launch(job.spec)) {
+      running_.push_back({ job.tile, now + (int64_t)kSettleS * G_USEC_PER_SEC });
+    }
+  }
+
+  if (!queue_.empty() && !running_.empty()) {
+    int64_t next = running_.front().deadline_us;
+    for (const auto& r : running_) next = std::min(next, r.deadline_us);
+    schedule((unsigned)std::max<int64_t>(1, (next - now) / 1000 + 1));
+  }
+}
+
+void LaunchScheduler::on_settled(const std::string& tile) {
+  auto it = std::find_if(running_.begin(), running_.end(), [&tile](const Running& r) { return r.tile == tile; });
+  if (it == running_.end()) return;
+  running_.erase(it);
+  // Not from inside LaunchLatency's X event handling.
+  if (!queue_.empty()) schedule(0);
+}
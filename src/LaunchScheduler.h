@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glibmm/main.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Icons.h"
+#include "IoPressure.h"
+
+// Staged launches for the autostart list and scenes. Tiles go through
+// Launcher::launch like a tap, but at most `launch_parallel` at a time, each
+// after the tiles in its `after` list. A launch holds its slot until its
+// first window maps, it exits, or kSettleS passes (LaunchLatency tells; there
+// is no window to wait for without X11). While /proc/pressure/io shows the
+// disk stalled, the next start backs off, but never for longer than
+// kMaxIoWaitS in a row. Taps bypass the queue.
+class LaunchScheduler {
+public:
+  static LaunchScheduler& instance();
+
+  // Tiles and scenes are looked up here; queued launches keep their spec.
+  void set_config(std::shared_ptr<const IconConfig> config);
+
+  // Queues the steps behind anything already queued. Unknown tiles are
+  // skipped with a warning, and steps depending on them proceed. Returns
+  // the number of launches queued.
+  int run(const std::vector<LaunchStep>& steps);
+  // False if there is no such scene.
+  bool run_scene(const std::string& name);
+
+  int queued() const { return (int)queue_.size(); }
+  int running() const { return (int)running_.size(); }
+
+private:
+  LaunchScheduler();
+
+  struct Job {
+    std::string tile;  // Launcher::tile_key
+    IconSpec spec;
+    std::vector<std::string> after;
+  };
+
+  struct Running {
+    std::string tile;
+    int64_t deadline_us;
+  };
+
+  const IconSpec* find_tile(const std::string& tile) const;
+  std::string key_for(const std::string& tile) const;  // Launcher::tile_key, else `tile`
+  bool waiting_on(const Job& job) const;  // an `after` tile is queued or running
+  bool io_stalled(int64_t now);
+  void pump();
+  void schedule(unsigned delay_ms);
+  void on_settled(const std::string& tile);
+
+  static constexpr int kSettleS = 20;
+  static constexpr int64_t kMaxIoWaitS = 15;
+  // Share of wall time some task spent stalled on I/O since the last check.
+  static constexpr double kMaxStall = 0.2;
+  static constexpr unsigned kMinBackoffMs = 250;
+  static constexpr unsigned kMaxBackoffMs = 4000;
+
+  std::shared_ptr<const IconConfig> config_;
+  std::vector<Job> queue_;
+  std::vector<Running> running_;
+
+  sigc::connection timer_;
+  unsigned backoff_ms_ = 0;
+  int64_t io_wait_since_us_ = 0;  // 0: not backing off
+  IoPressure::Sample last_io_;
+  int64_t last_io_us_ = 0;
+};
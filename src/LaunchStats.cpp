@@ -0,0 +1,128 @@
+#include "LaunchStats.h"
+#include "RuntimeEnv.h"
+
+#include <glib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+std::string stats_path() {
+  gchar* p = g_build_filename(g_get_user_cache_dir(), "sv-dashboard-gtk", "launch-stats.tsv", nullptr);
+  std::string out = p ? p : "";
+  g_free(p);
+  return out;
+}
+
+int64_t now_s() {
+  return g_get_real_time() / G_USEC_PER_SEC;
+}
+
+} // namespace
+
+LaunchStats& LaunchStats::instance() {
+  static LaunchStats stats;
+  return stats;
+}
+
+double LaunchStats::decayed(const Entry& e, int64_t now) {
+  const double age = (double)std::max<int64_t>(0, now - e.last);
+  return e.score * std::exp2(-age / kHalfLifeS);
+}
+
+// One line per program: count \t last \t score \t program
+void LaunchStats::load() {
+  loaded_ = true;
+
+  gchar* data = nullptr;
+  gsize len = 0;
+  if (!g_file_get_contents(stats_path().c_str(), &data, &len, nullptr)) return;
+
+  std::istringstream in(std::string(data, len));
+  g_free(data);
+
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    Entry e;
+    std::string program;
+    if (!(fields >> e.count >> e.last >> e.score)) continue;
+    fields.get();  // tab
+    std::getline(fields, program);
+    if (!program.empty()) entries_[program] = e;
+  }
+}
+
+void LaunchStats::save() const {
+  std::string out;
+  for (const auto& [program, e] : entries_) {
+    out += std::to_string(e.count) + '\t' + std::to_string(e.last) + '\t' +
+           std::to_string(e.score) + '\t' + program + '\n';
+  }
+
+  const std::string path = stats_path();
+  gchar* dir = g_path_get_dirname(path.c_str());
+  RuntimeEnv::ensureDir(dir);
+  g_free(dir);
+
+  GError* error = nullptr;
+  if (!g_file_set_contents(path.c_str(), out.data(), (gssize)out.size(), &error)) {
+    g_warning("LaunchStats: cannot write %s: %s", path.c_str(), error ? error->message : "?");
+    if (error) g_error_free(error);
+  }
+}
+
+void LaunchStats::record(const std::string& program) {
+  if (program.empty() || program.find_first_of("\t\n") != std::string::npos) return;
+  if (!loaded_) load();
+
+  const int64_t now = now_s();
+  auto& e = entries_[program];
+  e.score = decayed(e, now) + 1.0;
+  e.last = now;
+  ++e.count;
+  last_launch_us_ = g_get_monotonic_time();
+
+  // Forget the least likely programs so the file stays tiny.
+  while (entries_.size() > kMaxEntries) {
+    auto worst = std::min_element(entries_.begin(), entries_.end(), [now](const auto& a, const auto& b) {
+      return decayed(a.second, now) < decayed(b.second, now);
+    });
+    entries_.erase(worst);
+  }
+
+  if (!save_source_) save_source_ = g_timeout_add_seconds(kSaveDelayS, &LaunchStats::on_save, this);
+}
+
+gboolean LaunchStats::on_save(gpointer self) {
+  auto* stats = static_cast<LaunchStats*>(self);
+  stats->save_source_ = 0;
+  stats->save();
+  return G_SOURCE_REMOVE;
+}
+
+void LaunchStats::flush() {
+  if (!save_source_) return;
+  g_source_remove(save_source_);
+  save_source_ = 0;
+  save();
+}
+
+std::vector<std::string> LaunchStats::top(std::size_t n) {
+  if (!loaded_) load();
+
+  const int64_t now = now_s();
+  std::vector<std::pair<double, std::string>> ranked;
+  ranked.reserve(entries_.size());
+  for (const auto& [program, e] : entries_) ranked.emplace_back(decayed(e, now), program);
+
+  std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+  std::vector<std::string> out;
+  for (std::size_t i = 0; i < ranked.size() && i < n; ++i) out.push_back(ranked[i].second);
+  return out;
+}
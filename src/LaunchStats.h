@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Per-program launch history (frequency decayed by recency), persisted under
+// $XDG_CACHE_HOME/sv-dashboard-gtk/launch-stats.tsv. Feeds the prewarmer.
+// Writes are batched kSaveDelayS after a launch, off the tap path, and
+// flush() writes what is left at exit. Main thread only.
+class LaunchStats {
+public:
+  static LaunchStats& instance();
+
+  // Called for every spawned launch of `program` (argv[0]).
+  void record(const std::string& program);
+
+  // Writes pending changes now.
+  void flush();
+
+  // Most likely next launches, best first.
+  std::vector<std::string> top(std::size_t n);
+
+  // Monotonic time of the last record(), 0 if none this session.
+  int64_t last_launch_us() const { return last_launch_us_; }
+
+private:
+  LaunchStats() = default;
+
+  struct Entry {
+    double score = 0.0;    // decayed launch count as of `last`
+    int64_t last = 0;      // unix seconds
+    uint32_t count = 0;    // lifetime launches
+  };
+
+  // Score as of `now` (half-life kHalfLifeS).
+  static double decayed(const Entry& e, int64_t now);
+
+  void load();
+  void save() const;
+  static gboolean on_save(gpointer self);
+
+  static constexpr double kHalfLifeS = 3 * 24 * 3600.0;
+  static constexpr std::size_t kMaxEntries = 128;
+  static constexpr unsigned kSaveDelayS = 10;
+
+  std::unordered_map<std::string, Entry> entries_;
+  bool loaded_ = false;
+  unsigned save_source_ = 0;  // pending write, 0 = clean
+  int64_t last_launch_us_ = 0;
+};
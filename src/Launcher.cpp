@@ -0,0 +1,133 @@
+#include "Launcher.h"
+#include "AllocStats.h"
+#include "LaunchLatency.h"
+#include "LaunchScheduler.h"
+#include "LaunchStats.h"
+#include "ProcessIndex.h"
+#include "ResourceMonitor.h"
+#include "Trace.h"
+#include "X11Util.h"
+
+#include <glib.h>
+
+namespace {
+
+void on_child_exit(GPid pid, gint, gpointer) {
+#ifndef _WIN32
+  ProcessIndex::instance().remove((pid_t)pid);
+  LaunchLatency::instance().child_exited((pid_t)pid);
+  ResourceMonitor::instance().untrack((pid_t)pid);
+#endif
+  g_spawn_close_pid(pid);
+}
+
+} // namespace
+
+namespace Launcher {
+
+std::vector<std::string> build_argv(const IconSpec& spec) {
+  std::string cmd = spec.command;
+  std::vector<std::string> args = spec.args;
+
+  if (cmd == "scene") return {};
+  if (cmd == "onlyone") {
+    if (args.empty()) return {};
+    cmd = args.front();
+    args.erase(args.begin());
+  }
+
+  if (cmd.empty()) return {};
+
+  std::vector<std::string> argv;
+  argv.reserve(1 + args.size());
+  argv.push_back(cmd);
+  argv.insert(argv.end(), args.begin(), args.end());
+  return argv;
+}
+
+std::string tile_key(const IconSpec& spec) {
+  if (!spec.name.empty()) return spec.name;
+  if (!spec.label.empty()) return spec.label;
+  const auto argv = build_argv(spec);
+  return argv.empty() ? std::string() : argv.front();
+}
+
+const IconSpec* find_tile(const IconConfig& config, const std::string& tile) {
+  for (const auto& page : config.pages) {
+    for (const auto& spec : page) {
+      if (spec.name == tile) return &spec;
+    }
+  }
+  for (const auto& page : config.pages) {
+    for (const auto& spec : page) {
+      if (spec.label == tile || tile_key(spec) == tile) return &spec;
+    }
+  }
+  return nullptr;
+}
+
+bool launch(const IconSpec& spec, int64_t press_us) {
+  SV_TRACE_SCOPE("Launcher::launch");
+  SV_ALLOC_SCOPE(Launch);
+  if (!press_us) press_us = g_get_monotonic_time();
+
+  if (spec.command == "scene") {
+    if (spec.args.empty() || !LaunchScheduler::instance().run_scene(spec.args.front())) {
+      g_warning("No scene \"%s\"", spec.args.empty() ? "" : spec.args.front().c_str());
+    }
+    return false;
+  }
+
+  auto argv_strings = build_argv(spec);
+  if (argv_strings.empty()) return false;
+
+  if (spec.command == "onlyone") {
+    const int64_t t0 = g_get_monotonic_time();
+    const auto pids = ProcessIndex::instance().find(argv_strings);
+    if (!pids.empty()) {
+      for (pid_t p : pids) ResourceMonitor::instance().track(tile_key(spec), p);
+      const bool raised = raise_window_for_pids(pids);
+      g_debug("onlyone %s: %zu running, %s (%" G_GINT64_FORMAT " us)",
+              argv_strings.front().c_str(), pids.size(),
+              raised ? "raised" : "no window yet", g_get_monotonic_time() - t0);
+      return false;
+    }
+  }
+
+  std::vector<char*> argv;
+  argv.reserve(argv_strings.size() + 1);
+  for (auto& arg : argv_strings) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  // Not reaped by GLib's double fork, so the pid is the app's own and can
+  // be indexed right away; the child watch reaps it.
+  GPid pid = 0;
+  GError* error = nullptr;
+  g_spawn_async(nullptr,
+                argv.data(),
+                nullptr,
+                (GSpawnFlags)(G_SPAWN_SEARCH_PATH | G_SPAWN_DO_NOT_REAP_CHILD),
+                nullptr,
+                nullptr,
+                &pid,
+                &error);
+  if (error) {
+    g_warning("Failed to launch command: %s", error->message);
+    g_error_free(error);
+    return false;
+  }
+
+#ifndef _WIN32
+  const std::string key = tile_key(spec);
+  ProcessIndex::instance().add((pid_t)pid, argv_strings);
+  LaunchLatency::instance().track(key, press_us, g_get_monotonic_time(), (pid_t)pid);
+  ResourceMonitor::instance().track(key, (pid_t)pid);
+#endif
+  LaunchStats::instance().record(argv_strings.front());
+  g_child_watch_add(pid, &on_child_exit, nullptr);
+  return true;
+}
+
+} // namespace Launcher
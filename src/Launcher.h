@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Icons.h"
+
+namespace Launcher {
+
+// cmd + args, with a leading "onlyone" stripped; empty if nothing to run
+// (also for "scene" tiles).
+std::vector<std::string> build_argv(const IconSpec& spec);
+
+// Name a tile's launches and status are keyed by: its "name", else its
+// label, else the program.
+std::string tile_key(const IconSpec& spec);
+
+// The tile a scene step, autostart entry or control command refers to: the
+// one with that "name", else the first with that title. Null if none.
+const IconSpec* find_tile(const IconConfig& config, const std::string& tile);
+
+// Starts the tile's command. For "onlyone" tiles an already running
+// instance (ours or not) is raised instead; if it has no window yet, the tap
+// is dropped rather than starting a second copy. "scene" tiles queue the
+// scene named in args[0] with LaunchScheduler.
+// `press_us`: monotonic time of the tap (0 = now), for LaunchLatency.
+// True if a new process was spawned.
+bool launch(const IconSpec& spec, int64_t press_us = 0);
+
+} // namespace Launcher
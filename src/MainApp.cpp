@@ -1,7 +1,23 @@
 #include "MainApp.h"
+#include "GlyphAtlas.h"
+#include "LaunchLatency.h"
+#include "LaunchScheduler.h"
+#include "Launcher.h"
 #include "MainWindow.h"
+#include "ProcessIndex.h"
+#include "ResourceMonitor.h"
+#include "ScreenCss.h"
+#include "StatusFeed.h"
+#include "TileCache.h"
+#include "Trace.h"
 
-#include <iostream>
+#include <gdk/gdk.h>
+#include <glib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 Glib::RefPtr<MainApp> MainApp::create() {
   return Glib::RefPtr<MainApp>(new MainApp());
@@ -9,23 +25,212 @@ Glib::RefPtr<MainApp> MainApp::create() {
 
 MainApp::MainApp()
 : Gtk::Application("github.bbn.sv_dashboard")
-{}
+{
+  // Runs concurrently with Gtk::Application registration/startup.
+  startup_.start();
+
+  const char* monitors = g_getenv("SV_DASHBOARD_MONITORS");
+  per_monitor_ = !(monitors && std::strcmp(monitors, "primary") == 0);
+}
 
 void MainApp::on_startup() {
   Gtk::Application::on_startup();
+}
+
+void MainApp::on_activate() {
+  // A second launch only raises the running windows.
+  if (config_) {
+    for (auto* w : windows_) w->present();
+    return;
+  }
+
+  // Join point: config parsed and fonts attached (unless the glyph atlas
+  // has every glyph on screen, only the label face) before the first
+  // Desktop is built.
+  const IconConfig& config = startup_.config();
+  if (GlyphAtlas::instance().load() && GlyphAtlas::instance().covers(config)) {
+    // Icon-only startup: the first frame needs no Font Awesome font; add it
+    // once that frame is out, for glyphs added by a later reload.
+    startup_.finish_labels();
+    Glib::signal_idle().connect_once([this] { startup_.finish_fonts(); });
+  } else {
+    startup_.finish_fonts();
+  }
+  config_ = std::make_shared<const IconConfig>(config);
+  ScreenCss::instance().ensure(*config_);
 
-  // Register bundled fonts before UI is created
-  if (!font_registry_.registerBundledFonts()) {
-    std::cerr << "Failed to register bundled Font Awesome fonts.\n";
+  GdkDisplay* display = gdk_display_get_default();
+  const int n = display ? gdk_display_get_n_monitors(display) : 0;
+  if (per_monitor_ && n > 0) {
+    for (int i = 0; i < n; ++i) open_window(gdk_display_get_monitor(display, i));
+    g_signal_connect(display, "monitor-added", G_CALLBACK(&MainApp::on_monitor_added), this);
+    g_signal_connect(display, "monitor-removed", G_CALLBACK(&MainApp::on_monitor_removed), this);
+  } else {
+    GdkMonitor* m = display ? gdk_display_get_primary_monitor(display) : nullptr;
+    if (!m && n > 0) m = gdk_display_get_monitor(display, 0);
+    open_window(m);
   }
 
-  // NOTE: On some pangomm versions there is no Pango::CairoFontMap::get_default().
-  // It's safe to omit the font-map refresh; restart or early registration usually suffices.
+  backlight_.configure(config_->idle);
+
+  config_watcher_.signal_reloaded().connect(sigc::mem_fun(*this, &MainApp::on_config_reloaded));
+  config_watcher_.start(*config_);
+
+  // Seed the process index off the startup path so the first "onlyone" tap
+  // only has to diff the /proc listing.
+  Glib::signal_idle().connect_once([] { ProcessIndex::instance().refresh(); });
+
+  prewarmer_.set_targets(*config_);
+  prewarmer_.start();
+
+  // After the first frame, staged so the apps do not fight over the disk.
+  LaunchScheduler::instance().set_config(config_);
+  if (!config_->autostart.empty()) {
+    Glib::signal_idle().connect_once([this] { LaunchScheduler::instance().run(config_->autostart); });
+  }
+
+  StatusFeed::instance().start();
+  control_.start([this](const ControlCommand& cmd) { return on_control(cmd); });
 }
 
-void MainApp::on_activate() {
-  auto* win = new MainWindow();
+void MainApp::open_window(GdkMonitor* monitor) {
+  SV_TRACE_SCOPE("MainApp::open_window");
+  auto* win = new MainWindow(config_, monitor);
+  windows_.push_back(win);
   add_window(*win);
-  win->signal_hide().connect([win] { delete win; });
+  win->signal_hide().connect([this, win] { on_window_hidden(win); });
+  win->signal_sleeping().connect([this](bool) { update_services(); });
   win->present();
+  update_services();
+}
+
+void MainApp::on_window_hidden(MainWindow* win) {
+  windows_.erase(std::remove(windows_.begin(), windows_.end(), win), windows_.end());
+  delete win;
+  update_services();
+}
+
+void MainApp::on_monitor_added(GdkDisplay*, GdkMonitor* monitor, gpointer self) {
+  auto* app = static_cast<MainApp*>(self);
+  // Taken over by a window left without a monitor, else a new window.
+  for (auto* w : app->windows_) {
+    if (!w->monitor()) {
+      w->place_on(monitor);
+      return;
+    }
+  }
+  app->open_window(monitor);
+}
+
+void MainApp::on_monitor_removed(GdkDisplay*, GdkMonitor* monitor, gpointer self) {
+  auto* app = static_cast<MainApp*>(self);
+  auto it = std::find_if(app->windows_.begin(), app->windows_.end(),
+                         [monitor](MainWindow* w) { return w->monitor() == monitor; });
+  if (it == app->windows_.end()) return;
+  // The last window stays (the process would exit) and waits for a monitor.
+  if (app->windows_.size() == 1) (*it)->place_on(nullptr);
+  else (*it)->hide();  // deleted by on_window_hidden
+}
+
+void MainApp::on_config_reloaded(const IconConfig& config) {
+  SV_TRACE_SCOPE("MainApp::on_config_reloaded");
+
+  auto next = std::make_shared<const IconConfig>(config);
+  const bool restyled = ScreenCss::instance().apply(*next);
+  if (restyled) TileCache::instance().clear();
+
+  // Puts the old level back; the windows wake on the new idle settings.
+  if (next->idle != config_->idle) backlight_.configure(next->idle);
+  config_ = next;
+  int touched = 0;
+  for (auto* w : windows_) touched += w->apply_config(config_);
+  prewarmer_.set_targets(*config_);
+  LaunchScheduler::instance().set_config(config_);
+
+  g_message("Config reloaded: %d tile(s) updated in %zu window(s)%s", touched,
+            windows_.size(), restyled ? ", colors changed" : "");
+}
+
+std::string MainApp::on_control(const ControlCommand& cmd) {
+  using Verb = ControlCommand::Verb;
+  if (cmd.verb == Verb::Ping) return "ok";
+
+  if (cmd.verb == Verb::Scene) {
+    return LaunchScheduler::instance().run_scene(cmd.arg) ? "ok" : "err no such scene";
+  }
+
+  if (cmd.verb == Verb::Launch) {
+    const IconSpec* spec = Launcher::find_tile(*config_, cmd.arg);
+    if (!spec) return "err no such tile";
+    Launcher::launch(*spec);
+    return "ok";
+  }
+
+  std::vector<MainWindow*> targets = windows_;
+  if (cmd.window >= 0) {
+    if ((std::size_t)cmd.window >= windows_.size()) return "err no such window";
+    targets = { windows_[cmd.window] };
+  }
+  if (targets.empty()) return "err no window";
+
+  char buf[160];
+  switch (cmd.verb) {
+    case Verb::Status: {
+      const MainWindow* w = targets.front();
+      std::snprintf(buf, sizeof(buf), "ok scheme=%s page=%zu/%zu sleeping=%d", w->scheme_name().c_str(),
+                    w->page() + 1, w->page_count(), w->sleeping() ? 1 : 0);
+      return buf;
+    }
+
+    case Verb::Wake:
+      for (auto* w : targets) w->wake();
+      return "ok";
+
+    case Verb::Scheme:
+      for (auto* w : targets) {
+        if (!w->select_scheme(cmd.arg)) return "err unknown scheme";
+      }
+      return "ok";
+
+    case Verb::Page: {
+      char* end = nullptr;
+      const long n = std::strtol(cmd.arg.c_str(), &end, 10);
+      const bool step = cmd.arg == "next" || cmd.arg == "prev";
+      if (!step && (*end || n < 1)) return "err bad page";
+      for (auto* w : targets) {
+        std::size_t idx = (std::size_t)n - 1;
+        if (cmd.arg == "next") idx = std::min(w->page() + 1, w->page_count() - 1);
+        if (cmd.arg == "prev") idx = w->page() > 0 ? w->page() - 1 : 0;
+        if (!w->select_page(idx)) return "err no such page";
+      }
+      std::snprintf(buf, sizeof(buf), "ok %zu", targets.front()->page() + 1);
+      return buf;
+    }
+
+    default:
+      return "err bad command";
+  }
+}
+
+void MainApp::update_services() {
+  const bool all_asleep = !windows_.empty() &&
+      std::all_of(windows_.begin(), windows_.end(), [](MainWindow* w) { return w->sleeping(); });
+  if (all_asleep == services_suspended_) return;
+  services_suspended_ = all_asleep;
+
+  if (all_asleep) {
+    prewarmer_.suspend();
+    ResourceMonitor::instance().suspend();
+    StatusFeed::instance().suspend();
+    LaunchLatency::instance().suspend();
+    // No window draws until one wakes.
+    TileCache::instance().clear();
+    backlight_.dim();
+  } else {
+    backlight_.restore();
+    prewarmer_.resume();
+    ResourceMonitor::instance().resume();
+    StatusFeed::instance().resume();
+    LaunchLatency::instance().resume();
+  }
 }
@@ -3,8 +3,26 @@
 #include <gtkmm/application.h>
 #include <glibmm/refptr.h>
 
-#include "FontRegistry.h"
+#include <memory>
+#include <string>
+#include <vector>
 
+#include "Backlight.h"
+#include "ConfigWatcher.h"
+#include "ControlServer.h"
+#include "Icons.h"
+#include "Prewarmer.h"
+#include "Startup.h"
+
+typedef struct _GdkDisplay GdkDisplay;
+typedef struct _GdkMonitor GdkMonitor;
+
+class MainWindow;
+
+// One process drives a MainWindow per connected monitor (helm, nav
+// station, ...); SV_DASHBOARD_MONITORS=primary limits it to one. The
+// windows share the parsed config, the CSS, the glyph/tile caches and the
+// process trackers; config reloads and idle pausing are handled here once.
 class MainApp : public Gtk::Application {
 public:
   static Glib::RefPtr<MainApp> create();
@@ -16,6 +34,27 @@ protected:
   void on_activate() override;
 
 private:
-  // Keep registry alive for entire app lifetime
-  FontRegistry font_registry_;
+  void open_window(GdkMonitor* monitor);
+  void on_window_hidden(MainWindow* win);
+  void on_config_reloaded(const IconConfig& config);
+  std::string on_control(const ControlCommand& cmd);
+  // Background services run, and the backlight stays up, while any window
+  // is awake.
+  void update_services();
+
+  static void on_monitor_added(GdkDisplay* display, GdkMonitor* monitor, gpointer self);
+  static void on_monitor_removed(GdkDisplay* display, GdkMonitor* monitor, gpointer self);
+
+  // Font registration + config parsing, started before GTK init
+  Startup startup_;
+
+  std::shared_ptr<const IconConfig> config_;
+  std::vector<MainWindow*> windows_;
+  bool per_monitor_ = true;
+  bool services_suspended_ = false;
+
+  ConfigWatcher config_watcher_;
+  Prewarmer prewarmer_;
+  ControlServer control_;
+  Backlight backlight_;
 };
@@ -1,182 +1,226 @@
 #include "MainWindow.h"
+#include "AllocStats.h"
 #include "Desktop.h"
 #include "Icons.h"
 #include "FontRegistry.h"
+#include "Theme.h"
+#include "PerfStats.h"
+#include "ScreenCss.h"
+#include "TileCache.h"
+#include "Trace.h"
+#include "UiMetrics.h"
 
 #include <gdk/gdkkeysyms.h>
 #include <gtk/gtk.h>   // gtk_gesture_set_state
+#include <algorithm>
 #include <cmath>
 #include <string>
+#include <utility>
 #include <vector>
 
-static Glib::ustring cp_to_utf8(char32_t cp) {
-  gunichar gcp = static_cast<gunichar>(cp);
-  gchar buf[8] = {0};
-  const int len = g_unichar_to_utf8(gcp, buf);
-  buf[len] = '\0';
-  return Glib::ustring(buf);
-}
+void MainWindow::apply_metrics_css(int bucket, double scale) {
+  ScreenCss::instance().ensure_metrics(bucket, scale);
 
-// GTK3 often wraps button labels (Alignment -> Label). This finds the label reliably.
-static Gtk::Label* find_label(Gtk::Widget* w) {
-  if (!w) return nullptr;
-  if (auto* l = dynamic_cast<Gtk::Label*>(w)) return l;
+  const std::string cls = Theme::metrics_class(bucket);
+  if (cls == metrics_class_) return;
 
-  if (auto* c = dynamic_cast<Gtk::Container*>(w)) {
-    auto kids = c->get_children();
-    for (auto* k : kids) {
-      if (auto* r = find_label(k)) return r;
-    }
-  }
-  return nullptr;
+  auto sc = get_style_context();
+  if (!metrics_class_.empty()) sc->remove_class(metrics_class_);
+  metrics_class_ = cls;
+  sc->add_class(metrics_class_);
 }
 
-static void set_button_fa_font(Gtk::Button& b, int px, bool heavy = true) {
-  Pango::FontDescription fd;
-  fd.set_family(FontRegistry::kFamilyFree);
-  fd.set_weight(heavy ? Pango::WEIGHT_HEAVY : Pango::WEIGHT_NORMAL);
-  fd.set_size(px * Pango::SCALE);
-
-  if (auto* child = find_label(b.get_child())) {
-    child->override_font(fd);
-  }
-}
-
-void MainWindow::apply_css_provider_once() {
-  css_provider_ = Gtk::CssProvider::create();
-  auto screen = Gdk::Screen::get_default();
-  Gtk::StyleContext::add_provider_for_screen(
-      screen, css_provider_, GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+void MainWindow::refresh_scheme_buttons() {
+  auto set_active = [](Gtk::Button& b, bool on) {
+    auto sc = b.get_style_context();
+    if (on) sc->add_class("active");
+    else    sc->remove_class("active");
+  };
+  set_active(scheme_day_,   scheme_ == kSchemeDay);
+  set_active(scheme_dusk_,  scheme_ == kSchemeDusk);
+  set_active(scheme_night_, scheme_ == kSchemeNight);
 }
 
-Glib::ustring MainWindow::build_css(Scheme s) const {
-  auto itos = [](int v) { return std::to_string(v); };
+void MainWindow::set_scheme(std::size_t idx) {
+  if (idx >= schemes_.size()) return;
+  scheme_ = idx;
 
-  const int scheme_pad_v = std::max(1, (int)std::lround(6  * ui_scale_));
-  const int scheme_pad_h = std::max(2, (int)std::lround(14 * ui_scale_));
-  const int scheme_mr    = std::max(0, (int)std::lround(6  * ui_scale_));
+  // Scheme rules are precompiled; switching is just a class swap on the toplevel.
+  auto sc = get_style_context();
+  if (!scheme_class_.empty()) sc->remove_class(scheme_class_);
+  scheme_class_ = Theme::scheme_class(schemes_[scheme_]);
+  sc->add_class(scheme_class_);
 
-  const int icon_radius  = std::max(3, (int)std::lround(16 * ui_scale_));
+  if (Theme::uses_palette(schemes_[scheme_])) sc->add_class(Theme::kPaletteClass);
+  else                                        sc->remove_class(Theme::kPaletteClass);
 
-  std::string css;
-  css += "window, GtkWindow { background: #000000; }\n";
-  css += ".tile { background: transparent; border: none; box-shadow: none; padding: 0; }\n";
+  // No TileCache::clear(): tiles are keyed by the toplevel's classes
+  // (TileKey::style_id), and other windows keep drawing theirs.
+  refresh_scheme_buttons();
+}
 
-  css += ".scheme-btn { background: transparent; border: none; box-shadow: none; ";
-  css += "padding: " + itos(scheme_pad_v) + "px " + itos(scheme_pad_h) + "px; ";
-  css += "margin-right: " + itos(scheme_mr) + "px; }\n";
-  css += ".scheme-btn:focus { outline: none; }\n";
+bool MainWindow::select_scheme(const std::string& name) {
+  auto it = std::find_if(schemes_.begin(), schemes_.end(),
+                         [&name](const SchemeSpec& s) { return s.name == name; });
+  if (it == schemes_.end()) return false;
+  const std::size_t idx = (std::size_t)(it - schemes_.begin());
+  if (sleeping_ && idle_spec_.night) scheme_before_idle_ = idx;
+  else set_scheme(idx);
+  return true;
+}
 
-  css += ".scheme-day   { color: #d4b000; }\n";
-  css += ".scheme-dusk  { color: #b0b0b0; }\n";
-  css += ".scheme-night { color: #d00000; }\n";
-  css += ".scheme-btn { opacity: 0.65; }\n";
-  css += ".scheme-btn.active { opacity: 1.0; border-bottom: 2px solid currentColor; }\n";
+bool MainWindow::select_page(std::size_t idx) {
+  if (idx >= pages_.size()) return false;
+  idle_.note_input();
+  show_page(idx);
+  return true;
+}
 
-  if (s == Scheme::Day) {
-    css += ".tile-label, .nav { color: #f2f2f2; }\n";
+int MainWindow::apply_config(std::shared_ptr<const IconConfig> config) {
+  SV_TRACE_SCOPE("MainWindow::apply_config");
 
-    // Icon color + background are on tile-icon-box now
-    css += ".tile-icon-box { background:#2b2b2b; color:#ffffff; border-radius:" + itos(icon_radius) + "px; }\n";
+  // ScreenCss already reparsed the sheets; keep this window on its scheme.
+  const auto& schemes = ScreenCss::instance().schemes();
+  if (schemes != schemes_) {
+    const std::string current = schemes_[scheme_].name;
+    schemes_ = schemes;
 
-    for (const auto& entry : palette_) {
-      css += ".tile-icon-box." + entry.first + " { background:" + entry.second + "; }\n";
+    std::size_t idx = kSchemeDay;
+    for (std::size_t i = 0; i < schemes_.size(); ++i) {
+      if (schemes_[i].name == current) idx = i;
     }
-
-  } else if (s == Scheme::Dusk) {
-    css += ".tile-label, .nav { color:#c8c8c8; }\n";
-    // FIX: icon glyph is drawn inside tile-icon-box
-    css += ".tile-icon-box { color:#e6e6e6; background:transparent; border-radius:" + itos(icon_radius) + "px; }\n";
-
-  } else {
-    css += ".tile-label, .nav { color:#d00000; }\n";
-    // FIX: icon glyph is drawn inside tile-icon-box
-    css += ".tile-icon-box { color:#d00000; background:transparent; border-radius:" + itos(icon_radius) + "px; }\n";
+    set_scheme(idx);
+  }
+  if (config->idle != idle_spec_) {
+    idle_spec_ = config->idle;
+    idle_.configure(idle_spec_);
   }
 
-  return Glib::ustring(css);
+  int touched = 0;
+  if (config->cols != config_->cols) {
+    // New grid shape: rebuild lazily from scratch.
+    for (std::size_t i = 0; i < pages_.size(); ++i) drop_page(i);
+  }
+  for (std::size_t i = config->pages.size(); i < pages_.size(); ++i) drop_page(i);
+  config_ = std::move(config);
+  pages_.resize(config_->pages.size(), nullptr);
+  for (std::size_t i = 0; i < pages_.size(); ++i) {
+    if (pages_[i]) touched += pages_[i]->update(config_->pages[i]);
+  }
+  show_page(std::min(page_, pages_.size() - 1));
+  return touched;
 }
 
-void MainWindow::refresh_scheme_buttons() {
-  auto set_active = [](Gtk::Button& b, bool on) {
-    auto sc = b.get_style_context();
-    if (on) sc->add_class("active");
-    else    sc->remove_class("active");
-  };
-  set_active(scheme_day_,   scheme_ == Scheme::Day);
-  set_active(scheme_dusk_,  scheme_ == Scheme::Dusk);
-  set_active(scheme_night_, scheme_ == Scheme::Night);
-}
+void MainWindow::set_sleeping(bool sleeping) {
+  SV_TRACE_SCOPE("MainWindow::set_sleeping");
 
-void MainWindow::set_scheme(Scheme s) {
-  scheme_ = s;
-  css_provider_->load_from_data(build_css(scheme_));
-  refresh_scheme_buttons();
-}
+  sleeping_ = sleeping;
+  if (sleeping) {
+    if (hud_.get_visible()) hud_.toggle();
+    if (resize_tick_id_) {
+      gtk_widget_remove_tick_callback(GTK_WIDGET(gobj()), resize_tick_id_);
+      resize_tick_id_ = 0;
+    }
+    pager_.settle_now();
+    pager_.release_snapshots();
 
-void MainWindow::apply_ui_scale(int w, int h) {
-  constexpr double base_w = 1400.0;
-  constexpr double base_h = 800.0;
+    // Keep only the visible page.
+    for (std::size_t i = 0; i < pages_.size(); ++i) {
+      if (i != page_) drop_page(i);
+    }
 
-  double s = std::min(w / base_w, h / base_h);
-  s = std::max(0.06, std::min(1.0, s));
+    scheme_before_idle_ = scheme_;
+    if (idle_spec_.night && scheme_ != kSchemeNight) set_scheme(kSchemeNight);
+    sleeping_changed_.emit(true);
+    return;
+  }
 
-  const bool want_labels = (h >= 260) && (s >= 0.33);
+  // Synchronous, so the next frame already shows the awake state. A resize
+  // dropped while asleep is applied here.
+  if (idle_spec_.night && scheme_ != scheme_before_idle_) set_scheme(scheme_before_idle_);
+  auto a = overlay_.get_allocation();
+  apply_ui_scale(a.get_width(), a.get_height());
+  sleeping_changed_.emit(false);
+}
 
-  if (std::fabs(s - ui_scale_) < 0.005 && want_labels == show_labels_) return;
+void MainWindow::apply_ui_scale(int w, int h) {
+  const UiMetrics& m = UiScale::metrics_for(std::min(w / (double)kBaseW, h / (double)kBaseH));
 
-  ui_scale_ = s;
-  show_labels_ = want_labels;
+  const bool want_labels = (h >= 260) && (m.scale >= 0.33);
+  const bool tiny = (w <= 420);
 
-  root_.set_spacing(std::max(0, (int)std::lround(8 * ui_scale_)));
+  // Unchanged bucket => zero invalidations.
+  if (&m == metrics_ && want_labels == show_labels_ && tiny == tiny_) return;
 
-  const bool tiny = (w <= 420);
-  btn_left_.set_visible(!tiny);
-  btn_right_.set_visible(!tiny);
+  if (tiny != tiny_ || !metrics_) {
+    btn_left_.set_visible(!tiny);
+    btn_right_.set_visible(!tiny);
+    tiny_ = tiny;
+  }
 
-  const int pad = std::max(0, (int)std::lround(14 * ui_scale_));
-  btn_left_.set_margin_start(pad);
-  btn_left_.set_margin_end(pad);
-  btn_right_.set_margin_start(pad);
-  btn_right_.set_margin_end(pad);
+  if (&m != metrics_) {
+    ++resize_stats().bucket_changes;
 
-  const int nav_px    = std::max(10, (int)std::lround(48 * ui_scale_));
-  const int scheme_px = std::max(6,  (int)std::lround(34 * ui_scale_));
+    root_.set_spacing(m.root_spacing);
 
-  set_button_fa_font(btn_left_,  nav_px, true);
-  set_button_fa_font(btn_right_, nav_px, true);
-  set_button_fa_font(scheme_day_,   scheme_px, true);
-  set_button_fa_font(scheme_dusk_,  scheme_px, true);
-  set_button_fa_font(scheme_night_, scheme_px, true);
+    btn_left_.set_margin_start(m.nav_pad);
+    btn_left_.set_margin_end(m.nav_pad);
+    btn_right_.set_margin_start(m.nav_pad);
+    btn_right_.set_margin_end(m.nav_pad);
 
-  scheme_bar_.set_spacing(std::max(0, (int)std::lround(8 * ui_scale_)));
-  scheme_bar_.set_margin_start(std::max(2, (int)std::lround(14 * ui_scale_)));
-  scheme_bar_.set_margin_bottom(std::max(2, (int)std::lround(12 * ui_scale_)));
+    for (auto* g : { &glyph_left_, &glyph_right_ }) g->set_px(m.nav_px);
+    for (auto* g : { &glyph_day_, &glyph_dusk_, &glyph_night_ }) g->set_px(m.scheme_px);
 
-  if (page1_) page1_->set_ui_scale(ui_scale_, show_labels_);
-  if (page2_) page2_->set_ui_scale(ui_scale_, show_labels_);
+    scheme_bar_.set_spacing(m.scheme_spacing);
+    scheme_bar_.set_margin_start(m.scheme_margin_start);
+    scheme_bar_.set_margin_bottom(m.scheme_margin_bottom);
 
-  css_provider_->load_from_data(build_css(scheme_));
+    TileCache::instance().clear();
+    apply_metrics_css(m.bucket, m.scale);
+  }
 
-  queue_resize();
+  metrics_ = &m;
+  show_labels_ = want_labels;
+
+  // Hidden pages pick the metrics up in show_page().
+  if (page_ < pages_.size() && pages_[page_]) pages_[page_]->set_ui_metrics(m, show_labels_);
 }
 
 void MainWindow::on_overlay_size_allocate(Gtk::Allocation& alloc) {
-  apply_ui_scale(alloc.get_width(), alloc.get_height());
+  ++resize_stats().relayouts;
+
+  // Never restyle/resize from inside the layout pass: coalesce into the next frame.
+  pending_w_ = alloc.get_width();
+  pending_h_ = alloc.get_height();
+  if (!resize_tick_id_) {
+    resize_tick_id_ = gtk_widget_add_tick_callback(
+        GTK_WIDGET(gobj()), &MainWindow::on_resize_tick, this, nullptr);
+  }
 }
 
-void MainWindow::handle_swipe_delta(double dx, double dy, guint32 dt_ms) {
-  if (std::fabs(dx) < kSwipeMinPx) {
-    if (!(std::fabs(dx) >= kSwipeFastMinPx && dt_ms <= kSwipeFastMaxMs)) return;
-  }
-  if (std::fabs(dx) < std::fabs(dy) * 1.2) return;
+gboolean MainWindow::on_resize_tick(GtkWidget*, GdkFrameClock*, gpointer self) {
+  auto* win = static_cast<MainWindow*>(self);
+  win->resize_tick_id_ = 0;
 
-  const auto name = stack_.get_visible_child_name();
-  if (dx < 0) {
-    if (name == "page1") show_page("page2");
-  } else {
-    if (name == "page2") show_page("page1");
-  }
+  auto& stats = resize_stats();
+  ++stats.resize_frames;
+  win->apply_ui_scale(win->pending_w_, win->pending_h_);
+
+  g_debug("resize: bucket %d, %" G_GUINT64_FORMAT " relayouts / %" G_GUINT64_FORMAT
+          " frames / %" G_GUINT64_FORMAT " bucket changes",
+          win->metrics_ ? win->metrics_->bucket : -1,
+          stats.relayouts, stats.resize_frames, stats.bucket_changes);
+  return G_SOURCE_REMOVE;
+}
+
+void MainWindow::on_page_swiped(Gtk::Widget& page) {
+  auto it = std::find(pages_.begin(), pages_.end(), &page);
+  if (it == pages_.end()) return;
+
+  const std::size_t prev = page_;
+  page_ = (std::size_t)(it - pages_.begin());
+  trim_pages(page_, prev);
+  refresh_nav();
 }
 
 void MainWindow::setup_gestures() {
@@ -185,48 +229,67 @@ void MainWindow::setup_gestures() {
 
   drag_->signal_drag_begin().connect([this](double, double) {
     drag_claimed_ = false;
-    drag_t0_us_ = g_get_monotonic_time();
   });
 
+  // Once claimed the page follows the finger; the pager decides on release
+  // whether to fling to the neighbour or snap back.
   drag_->signal_drag_update().connect([this](double dx, double dy) {
     if (!drag_claimed_) {
-      if (std::fabs(dx) >= kSwipeLockPx && std::fabs(dx) > std::fabs(dy) * 1.1) {
-        drag_claimed_ = true;
-        gtk_gesture_set_state(GTK_GESTURE(drag_->gobj()), GTK_EVENT_SEQUENCE_CLAIMED);
-      }
+      if (std::fabs(dx) < kSwipeLockPx || std::fabs(dx) <= std::fabs(dy) * 1.1) return;
+      drag_claimed_ = true;
+      gtk_gesture_set_state(GTK_GESTURE(drag_->gobj()), GTK_EVENT_SEQUENCE_CLAIMED);
+      pager_.drag_begin();
     }
+    perf_note_input();
+    pager_.drag_update(dx);
   });
 
-  drag_->signal_drag_end().connect([this](double dx, double dy) {
-    const gint64 t1_us = g_get_monotonic_time();
-    const guint32 dt_ms = (t1_us > drag_t0_us_) ? (guint32)((t1_us - drag_t0_us_) / 1000) : 0;
-    handle_swipe_delta(dx, dy, dt_ms);
+  drag_->signal_drag_end().connect([this](double, double) {
+    if (drag_claimed_) pager_.drag_end();
+    drag_claimed_ = false;
+  });
+
+  drag_->signal_cancel().connect([this](GdkEventSequence*) {
+    if (drag_claimed_) pager_.drag_end();
     drag_claimed_ = false;
   });
 }
 
-MainWindow::MainWindow() {
-  set_title("BBN Launcher");
-  set_default_size(1400, 800);
+#if SV_DASHBOARD_TRACING
+static void on_first_after_paint(GdkFrameClock* clock, gpointer) {
+  SV_TRACE_INSTANT("first frame presented");
+  g_signal_handlers_disconnect_by_func(clock, (gpointer)&on_first_after_paint, nullptr);
+}
+#endif
+
+MainWindow::MainWindow(std::shared_ptr<const IconConfig> config, GdkMonitor* monitor)
+: config_(std::move(config))
+{
+  SV_TRACE_SCOPE("MainWindow::MainWindow");
 
-  apply_css_provider_once();
+  set_title("BBN Launcher");
+  set_default_size(kBaseW, kBaseH);
+  place_on(monitor);
 
-  stack_.set_transition_type(Gtk::STACK_TRANSITION_TYPE_SLIDE_LEFT_RIGHT);
-  stack_.set_transition_duration(250);
+  auto& css = ScreenCss::instance();
+  css.ensure(*config_);
+  schemes_ = css.schemes();
 
-  auto config = load_icon_config();
-  palette_ = config.palette;
-  page1_ = Gtk::manage(new Desktop(config.page1));
-  page2_ = Gtk::manage(new Desktop(config.page2));
-  stack_.add(*page1_, "page1");
-  stack_.add(*page2_, "page2");
+  pages_.assign(config_->pages.size(), nullptr);
 
   swipe_box_.set_visible_window(false);
   swipe_box_.set_above_child(true);
-  swipe_box_.add(stack_);
+  swipe_box_.add(pager_);
+  pager_.set_neighbour_fn([this](int dir) -> Gtk::Widget* {
+    if (dir < 0 ? page_ == 0 : page_ + 1 >= pages_.size()) return nullptr;
+    Desktop* d = ensure_page(page_ + dir);
+    if (metrics_) d->set_ui_metrics(*metrics_, show_labels_);
+    return d;
+  });
+  pager_.signal_page_changed().connect(sigc::mem_fun(*this, &MainWindow::on_page_swiped));
 
-  btn_left_.set_label(cp_to_utf8(CHEV_LEFT));
-  btn_right_.set_label(cp_to_utf8(CHEV_RIGHT));
+  btn_left_.add(glyph_left_);
+  btn_right_.add(glyph_right_);
   btn_left_.set_relief(Gtk::RELIEF_NONE);
   btn_right_.set_relief(Gtk::RELIEF_NONE);
   btn_left_.set_can_focus(false);
@@ -236,8 +299,8 @@ MainWindow::MainWindow() {
   btn_left_.set_size_request(1, 1);
   btn_right_.set_size_request(1, 1);
 
-  btn_left_.signal_clicked().connect([this] { show_page("page1"); });
-  btn_right_.signal_clicked().connect([this] { show_page("page2"); });
+  btn_left_.signal_clicked().connect([this] { if (page_ > 0) show_page(page_ - 1); });
+  btn_right_.signal_clicked().connect([this] { if (page_ + 1 < pages_.size()) show_page(page_ + 1); });
 
   root_.pack_start(btn_left_, Gtk::PACK_SHRINK, 0);
   root_.pack_start(swipe_box_, Gtk::PACK_EXPAND_WIDGET);
@@ -246,9 +309,9 @@ MainWindow::MainWindow() {
   scheme_bar_.set_halign(Gtk::ALIGN_START);
   scheme_bar_.set_valign(Gtk::ALIGN_END);
 
-  scheme_day_.set_label(cp_to_utf8(U'\uf185'));   // sun
-  scheme_dusk_.set_label(cp_to_utf8(U'\uf6c4'));  // cloud-sun
-  scheme_night_.set_label(cp_to_utf8(U'\uf186')); // moon
+  scheme_day_.add(glyph_day_);
+  scheme_dusk_.add(glyph_dusk_);
+  scheme_night_.add(glyph_night_);
 
   for (Gtk::Button* b : { &scheme_day_, &scheme_dusk_, &scheme_night_ }) {
     b->set_relief(Gtk::RELIEF_NONE);
@@ -260,9 +323,9 @@ MainWindow::MainWindow() {
   scheme_dusk_.get_style_context()->add_class("scheme-dusk");
   scheme_night_.get_style_context()->add_class("scheme-night");
 
-  scheme_day_.signal_clicked().connect([this]{ set_scheme(Scheme::Day); });
-  scheme_dusk_.signal_clicked().connect([this]{ set_scheme(Scheme::Dusk); });
-  scheme_night_.signal_clicked().connect([this]{ set_scheme(Scheme::Night); });
+  scheme_day_.signal_clicked().connect([this]{ set_scheme(kSchemeDay); });
+  scheme_dusk_.signal_clicked().connect([this]{ set_scheme(kSchemeDusk); });
+  scheme_night_.signal_clicked().connect([this]{ set_scheme(kSchemeNight); });
 
   scheme_bar_.pack_start(scheme_day_, Gtk::PACK_SHRINK);
   scheme_bar_.pack_start(scheme_dusk_, Gtk::PACK_SHRINK);
@@ -270,6 +333,10 @@ MainWindow::MainWindow() {
 
   overlay_.add(root_);
   overlay_.add_overlay(scheme_bar_);
+  overlay_.add_overlay(hud_);
+  hud_.attach(*this);
+  AllocStats::watch_frames(GTK_WIDGET(gobj()));
+  signal_style_updated().connect([] { ++perf_stats().restyles; });
   add(overlay_);
 
   signal_key_press_event().connect(sigc::mem_fun(*this, &MainWindow::on_key_press), false);
@@ -278,43 +345,126 @@ MainWindow::MainWindow() {
 
   setup_gestures();
 
-  apply_ui_scale(1400, 800);
-  set_scheme(Scheme::Day);
+  int w = 0, h = 0;
+  get_default_size(w, h);
+  apply_ui_scale(w, h);
+  set_scheme(kSchemeDay);
 
   show_all();
-  show_page("page1");
+  show_page(0);
+
+  idle_.attach(*this);
+  idle_.signal_changed().connect(sigc::mem_fun(*this, &MainWindow::set_sleeping));
+  idle_spec_ = config_->idle;
+  idle_.configure(idle_spec_);
 
   signal_realize().connect([this] {
     auto a = overlay_.get_allocation();
     apply_ui_scale(a.get_width(), a.get_height());
+
+#if SV_DASHBOARD_TRACING
+    if (Trace::enabled()) {
+      if (GdkFrameClock* clock = gtk_widget_get_frame_clock(GTK_WIDGET(gobj()))) {
+        g_signal_connect(clock, "after-paint", G_CALLBACK(&on_first_after_paint), nullptr);
+      }
+    }
+#endif
   });
 }
 
-void MainWindow::show_page(const Glib::ustring& name) {
-  stack_.set_visible_child(name);
+void MainWindow::place_on(GdkMonitor* monitor) {
+  monitor_ = monitor;
+  if (!monitor) return;
+
+  GdkRectangle r{};
+  gdk_monitor_get_workarea(monitor, &r);
+  if (r.width <= 0 || r.height <= 0) return;
+  // Before the first map this is the requested size; later a resize.
+  if (get_realized()) resize(r.width, r.height);
+  else set_default_size(r.width, r.height);
+  move(r.x, r.y);
+}
+
+Desktop* MainWindow::ensure_page(std::size_t idx) {
+  if (pages_[idx]) return pages_[idx];
+
+  auto* d = Gtk::manage(new Desktop(config_->pages[idx], config_->cols));
+  if (metrics_) d->set_ui_metrics(*metrics_, show_labels_);
+  pager_.add(*d);
+  d->show();
+  pages_[idx] = d;
+  return d;
+}
+
+void MainWindow::drop_page(std::size_t idx) {
+  if (idx >= pages_.size() || !pages_[idx]) return;
+  delete pages_[idx];  // managed, but explicit delete unparents it from the pager
+  pages_[idx] = nullptr;
+}
+
+void MainWindow::trim_pages(std::size_t keep_a, std::size_t keep_b) {
+  for (std::size_t i = 0; i < pages_.size(); ++i) {
+    if (i == keep_b) continue;
+    const std::size_t dist = (i > keep_a) ? i - keep_a : keep_a - i;
+    if (dist > kKeepPages) drop_page(i);
+  }
+}
+
+void MainWindow::show_page(std::size_t idx) {
+  if (idx >= pages_.size()) return;
+  SV_TRACE_SCOPE_IF(!pages_[idx], "MainWindow: build page");
+
+  const std::size_t prev = page_;
+  Desktop* d = ensure_page(idx);
+  // Scale changes only reach the visible page; catch up here (no-op if current).
+  if (metrics_) d->set_ui_metrics(*metrics_, show_labels_);
+
+  page_ = idx;
+  pager_.show_page(*d, idx > prev ? 1 : (idx < prev ? -1 : 0));
+
+  // The page just left stays for quick swipes back.
+  trim_pages(page_, prev);
   refresh_nav();
 }
 
 void MainWindow::refresh_nav() {
-  const auto name = stack_.get_visible_child_name();
-  btn_left_.set_sensitive(name != "page1");
-  btn_right_.set_sensitive(name != "page2");
+  btn_left_.set_sensitive(page_ > 0);
+  btn_right_.set_sensitive(page_ + 1 < pages_.size());
 }
 
 bool MainWindow::on_key_press(GdkEventKey* e) {
+  perf_note_input();
+  if (idle_.note_input()) return true;  // the waking key does nothing else
+
   switch (e->keyval) {
     case GDK_KEY_Right:
     case GDK_KEY_Page_Down:
-      show_page("page2");
+      if (page_ + 1 < pages_.size()) show_page(page_ + 1);
       return true;
     case GDK_KEY_Left:
     case GDK_KEY_Page_Up:
-      show_page("page1");
+      if (page_ > 0) show_page(page_ - 1);
+      return true;
+    case GDK_KEY_Home:
+      show_page(0);
       return true;
+    case GDK_KEY_End:
+      if (!pages_.empty()) show_page(pages_.size() - 1);
+      return true;
+
+    case GDK_KEY_1: set_scheme(kSchemeDay);   return true;
+    case GDK_KEY_2: set_scheme(kSchemeDusk);  return true;
+    case GDK_KEY_3: set_scheme(kSchemeNight); return true;
 
-    case GDK_KEY_1: set_scheme(Scheme::Day);   return true;
-    case GDK_KEY_2: set_scheme(Scheme::Dusk);  return true;
-    case GDK_KEY_3: set_scheme(Scheme::Night); return true;
+    // User-defined schemes from icons.json follow the built-ins.
+    case GDK_KEY_4: case GDK_KEY_5: case GDK_KEY_6:
+    case GDK_KEY_7: case GDK_KEY_8: case GDK_KEY_9:
+      set_scheme(kSchemeNight + 1 + (e->keyval - GDK_KEY_4));
+      return true;
+
+    case GDK_KEY_F3:
+      hud_.toggle();
+      return true;
 
     default:
       return false;
@@ -1,66 +1,135 @@
 #pragma once
 
 #include <gtkmm.h>
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "GlyphView.h"
+#include "Icons.h"
+#include "IdleManager.h"
+#include "PagerView.h"
+#include "PerfHud.h"
+
 class Desktop;
+struct UiMetrics;
 
+// One dashboard window. Several can run in one process (one per monitor,
+// see MainApp): they share the config, ScreenCss, TileCache and the process
+// trackers, and each keeps its own scale, page and scheme.
 class MainWindow : public Gtk::Window {
 public:
-  MainWindow();
+  // Sized to `monitor`'s work area when given, else to the 1400x800 base.
+  explicit MainWindow(std::shared_ptr<const IconConfig> config, GdkMonitor* monitor = nullptr);
+
+  GdkMonitor* monitor() const { return monitor_; }
+  void place_on(GdkMonitor* monitor);
+
+  // Live reload, after ScreenCss::apply(); the visible page and scheme are
+  // kept. Returns the number of tiles updated.
+  int apply_config(std::shared_ptr<const IconConfig> config);
+
+  // Idle mode of this window; the owner pauses shared services once every
+  // window sleeps.
+  bool sleeping() const { return sleeping_; }
+  sigc::signal<void(bool)>& signal_sleeping() { return sleeping_changed_; }
+
+  // Remote control (ControlServer via MainApp). A scheme chosen while idle
+  // night mode holds the window dark applies on wake. select_page() wakes
+  // the window; false if out of range.
+  bool select_scheme(const std::string& name);
+  bool select_page(std::size_t idx);
+  void wake() { idle_.note_input(); }
+  std::size_t page() const { return page_; }
+  std::size_t page_count() const { return pages_.size(); }
+  const std::string& scheme_name() const { return schemes_[scheme_].name; }
 
 private:
-  enum class Scheme { Day, Dusk, Night };
+  // Indices into schemes_; built-ins always come first.
+  static constexpr std::size_t kSchemeDay   = 0;
+  static constexpr std::size_t kSchemeDusk  = 1;
+  static constexpr std::size_t kSchemeNight = 2;
 
-  void apply_css_provider_once();
-  Glib::ustring build_css(Scheme s) const;
-  void set_scheme(Scheme s);
+  void apply_metrics_css(int bucket, double scale);
+  void set_scheme(std::size_t idx);
   void refresh_scheme_buttons();
 
-  void show_page(const Glib::ustring& name);
+  // Idle mode: stops this window's frame work and drops its far pages.
+  void set_sleeping(bool sleeping);
+
+  // Pages are built on first show; far-away ones are torn down.
+  void show_page(std::size_t idx);
+  Desktop* ensure_page(std::size_t idx);
+  void drop_page(std::size_t idx);
+  void trim_pages(std::size_t keep_a, std::size_t keep_b);
   void refresh_nav();
 
   bool on_key_press(GdkEventKey* e);
 
   void on_overlay_size_allocate(Gtk::Allocation& alloc);
+  static gboolean on_resize_tick(GtkWidget* w, GdkFrameClock* clock, gpointer self);
   void apply_ui_scale(int w, int h);
 
   void setup_gestures();
-  void handle_swipe_delta(double dx, double dy, guint32 dt_ms);
+  void on_page_swiped(Gtk::Widget& page);
 
   Gtk::Overlay overlay_;
   Gtk::Box     root_{Gtk::ORIENTATION_HORIZONTAL};
 
-  Gtk::Stack   stack_;
+  PagerView    pager_;
   Gtk::EventBox swipe_box_;
   Gtk::Button  btn_left_;
   Gtk::Button  btn_right_;
-
-  Desktop* page1_ = nullptr;
-  Desktop* page2_ = nullptr;
-  std::vector<std::pair<std::string, std::string>> palette_;
+  GlyphView    glyph_left_{CHEV_LEFT};
+  GlyphView    glyph_right_{CHEV_RIGHT};
+
+  std::shared_ptr<const IconConfig> config_;  // shared with the other windows
+  GdkMonitor* monitor_ = nullptr;
+  std::vector<Desktop*> pages_;  // null until first shown
+  std::size_t page_ = 0;
+  std::vector<SchemeSpec> schemes_;  // ScreenCss::schemes() this window's scheme_ indexes
+
+  PerfHud      hud_;
+  IdleManager   idle_;
+  IdleSpec      idle_spec_;
+  std::size_t   scheme_before_idle_ = kSchemeDay;
+  bool          sleeping_ = false;
+  sigc::signal<void(bool)> sleeping_changed_;
 
   Gtk::Box     scheme_bar_{Gtk::ORIENTATION_HORIZONTAL};
   Gtk::Button  scheme_day_;
   Gtk::Button  scheme_dusk_;
   Gtk::Button  scheme_night_;
+  GlyphView    glyph_day_{SCHEME_DAY};
+  GlyphView    glyph_dusk_{SCHEME_DUSK};
+  GlyphView    glyph_night_{SCHEME_NIGHT};
 
-  Glib::RefPtr<Gtk::CssProvider> css_provider_;
-
-  Scheme scheme_ = Scheme::Day;
+  std::size_t scheme_ = kSchemeDay;
+  std::string scheme_class_;
+  std::string metrics_class_;
 
-  // Force first apply
-  double ui_scale_ = -1.0;
+  // Null forces the first apply
+  const UiMetrics* metrics_ = nullptr;
   bool show_labels_ = true;
+  bool tiny_ = false;
+
+  // Size-allocate only records the size; the frame clock applies it once per frame.
+  guint resize_tick_id_ = 0;
+  int pending_w_ = 0;
+  int pending_h_ = 0;
 
   Glib::RefPtr<Gtk::GestureDrag> drag_;
   bool   drag_claimed_ = false;
-  gint64 drag_t0_us_ = 0;
 
+  // Built pages kept around the visible one (besides the one just left).
+  static constexpr std::size_t kKeepPages = 1;
+
+  // Design size the UI scale is relative to; also the default without a monitor.
+  static constexpr int kBaseW = 1400;
+  static constexpr int kBaseH = 800;
+
+  // Horizontal travel before a drag becomes a page swipe (and stops being a tap).
   static constexpr double  kSwipeLockPx      = 18.0;
-  static constexpr double  kSwipeMinPx       = 120.0;
-  static constexpr double  kSwipeFastMinPx   = 70.0;
-  static constexpr guint32 kSwipeFastMaxMs   = 260;
 };
@@ -0,0 +1,307 @@
+#include "PagerView.h"
+#include "AllocStats.h"
+#include "Trace.h"
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include <algorithm>
+#include <cmath>
+
+PagerView::PagerView() {
+  set_has_window(false);
+}
+
+PagerView::~PagerView() {
+  if (tick_id_) gtk_widget_remove_tick_callback(GTK_WIDGET(gobj()), tick_id_);
+}
+
+// ---- container plumbing ----
+
+void PagerView::on_add(Gtk::Widget* child) {
+  children_.push_back(child);
+  child->set_parent(*this);
+  // Like Gtk::Stack: the first page becomes the visible one.
+  if (!current_ && mode_ == Mode::Live) current_ = child;
+  child->set_child_visible(child == current_ && mode_ == Mode::Live);
+}
+
+void PagerView::on_remove(Gtk::Widget* child) {
+  auto it = std::find(children_.begin(), children_.end(), child);
+  if (it == children_.end()) return;
+
+  if (mode_ != Mode::Live && (child == current_ || child == neighbour_page_)) {
+    // The owner is rebuilding pages and will pick the page to show.
+    if (tick_id_) gtk_widget_remove_tick_callback(GTK_WIDGET(gobj()), tick_id_);
+    tick_id_ = 0;
+    mode_ = Mode::Live;
+    offset_ = 0.0;
+    side_ = 0;
+    neighbour_page_ = nullptr;
+  }
+
+  const bool visible = child->get_visible();
+  child->unparent();
+  children_.erase(it);
+  if (child == current_) current_ = nullptr;
+  if (visible) queue_resize();
+}
+
+void PagerView::forall_vfunc(gboolean, GtkCallback callback, gpointer data) {
+  // The callback may remove children.
+  const auto children = children_;
+  for (auto* c : children) callback(c->gobj(), data);
+}
+
+GType PagerView::child_type_vfunc() const {
+  return Gtk::Widget::get_type();
+}
+
+Gtk::SizeRequestMode PagerView::get_request_mode_vfunc() const {
+  return Gtk::SIZE_REQUEST_CONSTANT_SIZE;
+}
+
+// Homogeneous, as Gtk::Stack is by default.
+void PagerView::get_preferred_width_vfunc(int& min_w, int& nat_w) const {
+  min_w = nat_w = 0;
+  for (const auto* c : children_) {
+    if (!c->get_visible()) continue;
+    int m = 0, n = 0;
+    c->get_preferred_width(m, n);
+    min_w = std::max(min_w, m);
+    nat_w = std::max(nat_w, n);
+  }
+}
+
+void PagerView::get_preferred_height_vfunc(int& min_h, int& nat_h) const {
+  min_h = nat_h = 0;
+  for (const auto* c : children_) {
+    if (!c->get_visible()) continue;
+    int m = 0, n = 0;
+    c->get_preferred_height(m, n);
+    min_h = std::max(min_h, m);
+    nat_h = std::max(nat_h, n);
+  }
+}
+
+void PagerView::on_size_allocate(Gtk::Allocation& alloc) {
+  const bool resized = alloc.get_width() != get_allocated_width() ||
+                       alloc.get_height() != get_allocated_height();
+  set_allocation(alloc);
+  // Snapshots are only valid for the size they were taken at.
+  if (resized && mode_ != Mode::Live) settle_now();
+  if (current_ && current_->get_child_visible()) current_->size_allocate(alloc);
+}
+
+bool PagerView::on_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
+  if (mode_ == Mode::Live) return Gtk::Container::on_draw(cr);
+  SV_ALLOC_SCOPE(Swipe);
+
+  // Whole-pixel offsets keep cairo on its unfiltered copy path.
+  const int w = get_allocated_width();
+  const int h = get_allocated_height();
+  const double x = std::round(offset_);
+  auto blit = [&](const Cairo::RefPtr<Cairo::ImageSurface>& s, double at) {
+    if (!s || at >= w || at + w <= 0) return;
+    cr->set_source(s, at, 0);
+    cr->rectangle(at, 0, w, h);
+    cr->fill();
+  };
+  blit(snap_current_, x);
+  if (neighbour_page_) blit(snap_neighbour_, x + side_ * w);
+  return true;
+}
+
+// ---- pages ----
+
+void PagerView::set_live(Gtk::Widget* page) {
+  if (page) current_ = page;
+  for (auto* c : children_) c->set_child_visible(page && c == page);
+  queue_resize();
+}
+
+void PagerView::show_page(Gtk::Widget& page, int dir) {
+  if (mode_ != Mode::Live) settle_now();
+  if (&page == current_) return;
+
+  if (dir == 0 || !current_ || !get_mapped() ||
+      !snapshot(*current_, snap_current_) || !snapshot(page, snap_neighbour_)) {
+    set_live(&page);
+    queue_draw();
+    return;
+  }
+
+  SV_TRACE_SCOPE("PagerView::slide");
+  neighbour_page_ = &page;
+  side_ = dir > 0 ? 1 : -1;
+  offset_ = 0.0;
+  notify_ = false;  // the owner already switched
+  set_live(nullptr);
+  animate_to(-side_ * get_allocated_width(), 0.0, kSlideUs);
+}
+
+bool PagerView::snapshot(Gtk::Widget& page, Cairo::RefPtr<Cairo::ImageSurface>& into) {
+  Gtk::Allocation a = get_allocation();
+  const int w = a.get_width();
+  const int h = a.get_height();
+  if (w <= 0 || h <= 0) return false;
+
+  const int scale = get_scale_factor();
+  if (!into || into->get_width() != w * scale || into->get_height() != h * scale) {
+    into = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, w * scale, h * scale);
+    cairo_surface_set_device_scale(into->cobj(), scale, scale);
+  }
+  auto cr = Cairo::Context::create(into);
+  cr->set_operator(Cairo::OPERATOR_CLEAR);
+  cr->paint();
+  cr->set_operator(Cairo::OPERATOR_OVER);
+
+  // A hidden page is mapped just long enough to be drawn.
+  const bool hidden = !page.get_child_visible();
+  if (hidden) page.set_child_visible(true);
+  int m = 0, n = 0;
+  page.get_preferred_width(m, n);
+  page.get_preferred_height(m, n);
+  page.size_allocate(a);
+
+  gtk_widget_draw(GTK_WIDGET(page.gobj()), cr->cobj());
+
+  if (hidden) page.set_child_visible(false);
+  return true;
+}
+
+bool PagerView::reveal(int dir) {
+  side_ = dir;
+  neighbour_page_ = neighbour_ ? neighbour_(dir) : nullptr;
+  if (neighbour_page_ && !snapshot(*neighbour_page_, snap_neighbour_)) neighbour_page_ = nullptr;
+  return neighbour_page_ != nullptr;
+}
+
+// ---- finger tracking ----
+
+void PagerView::drag_begin() {
+  if (mode_ != Mode::Live) settle_now();
+  if (!current_ || !get_mapped()) return;
+
+  SV_TRACE_SCOPE("PagerView::drag_begin");
+  if (!snapshot(*current_, snap_current_)) return;
+
+  mode_ = Mode::Dragging;
+  offset_ = 0.0;
+  side_ = 0;
+  neighbour_page_ = nullptr;
+  velocity_ = 0.0;
+  last_dx_ = 0.0;
+  last_us_ = g_get_monotonic_time();
+  set_live(nullptr);
+  queue_draw();
+}
+
+void PagerView::drag_update(double dx) {
+  if (mode_ != Mode::Dragging) return;
+
+  {
+    SV_ALLOC_SCOPE(Swipe);
+    const int64_t now = g_get_monotonic_time();
+    if (now > last_us_) {
+      const double v = (dx - last_dx_) * 1e6 / (double)(now - last_us_);
+      velocity_ = 0.6 * v + 0.4 * velocity_;
+    }
+    last_dx_ = dx;
+    last_us_ = now;
+
+    // Finger moving left reveals the page on the right.
+    const int dir = dx < 0 ? 1 : (dx > 0 ? -1 : 0);
+    if (dir && dir != side_) reveal(dir);
+
+    offset_ = neighbour_page_ ? dx : dx * kEdgeResist;
+  }
+  // GTK's damage region is its own allocation, outside the Swipe scope.
+  queue_draw();
+}
+
+void PagerView::drag_end() {
+  if (mode_ != Mode::Dragging) return;
+
+  // A finger that stopped before lifting has no velocity left.
+  if (g_get_monotonic_time() - last_us_ > 100000) velocity_ = 0.0;
+
+  const double w = get_allocated_width();
+  const bool fling = std::fabs(velocity_) >= kFlingPxPerS;
+  const bool toward = (velocity_ < 0) == (side_ > 0);
+
+  bool go = false;
+  if (neighbour_page_) go = fling ? toward : std::fabs(offset_) > w * 0.5;
+
+  const double target = go ? -side_ * w : 0.0;
+  const double v = neighbour_page_ ? velocity_ : velocity_ * kEdgeResist;
+  const double dist = std::fabs(target - offset_);
+  int64_t dur = kMaxAnimUs;
+  if (std::fabs(v) > 1.0 && (go == toward)) dur = (int64_t)(2.0 * dist / std::fabs(v) * 1e6);
+
+  notify_ = true;
+  animate_to(target, v, std::clamp(dur, kMinAnimUs, kMaxAnimUs));
+}
+
+// ---- animation ----
+
+void PagerView::animate_to(double target, double velocity, int64_t duration_us) {
+  mode_ = Mode::Animating;
+  from_ = offset_;
+  to_ = target;
+  v0_ = velocity;
+  duration_us_ = std::max<int64_t>(1, duration_us);
+  anim_t0_us_ = g_get_monotonic_time();
+  if (!tick_id_) tick_id_ = gtk_widget_add_tick_callback(GTK_WIDGET(gobj()), &PagerView::on_tick, this, nullptr);
+  queue_draw();
+}
+
+gboolean PagerView::on_tick(GtkWidget*, GdkFrameClock* clock, gpointer self) {
+  auto* p = static_cast<PagerView*>(self);
+  const int64_t now = gdk_frame_clock_get_frame_time(clock);
+  const double u = std::max(0.0, (double)(now - p->anim_t0_us_) / (double)p->duration_us_);
+  if (u >= 1.0) {
+    p->tick_id_ = 0;
+    p->finish();
+    return G_SOURCE_REMOVE;
+  }
+
+  // Cubic Hermite: starts at the finger's speed, arrives at rest.
+  const double T = p->duration_us_ / 1e6;
+  const double u2 = u * u, u3 = u2 * u;
+  p->offset_ = (2 * u3 - 3 * u2 + 1) * p->from_ + (u3 - 2 * u2 + u) * T * p->v0_ + (3 * u2 - 2 * u3) * p->to_;
+  p->queue_draw();
+  return G_SOURCE_CONTINUE;
+}
+
+void PagerView::finish() {
+  if (tick_id_) gtk_widget_remove_tick_callback(GTK_WIDGET(gobj()), tick_id_);
+  tick_id_ = 0;
+
+  const bool moved = mode_ == Mode::Animating && neighbour_page_ && to_ != 0.0;
+  Gtk::Widget* page = moved ? neighbour_page_ : current_;
+  const bool notify = moved && notify_;
+
+  mode_ = Mode::Live;
+  offset_ = 0.0;
+  side_ = 0;
+  neighbour_page_ = nullptr;
+  notify_ = false;
+  set_live(page);
+  queue_draw();
+
+  if (notify && page) page_changed_.emit(*page);
+}
+
+void PagerView::settle_now() {
+  if (mode_ == Mode::Live) return;
+  if (mode_ == Mode::Dragging) to_ = 0.0;
+  mode_ = Mode::Animating;
+  finish();
+}
+
+void PagerView::release_snapshots() {
+  if (mode_ != Mode::Live) return;
+  snap_current_.reset();
+  snap_neighbour_.reset();
+}
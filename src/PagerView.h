@@ -0,0 +1,98 @@
+#pragma once
+
+#include <gtkmm/container.h>
+#include <cairomm/surface.h>
+#include <sigc++/signal.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Horizontal pager for the dashboard pages (replaces a Gtk::Stack).
+// Only the current page is a live, mapped child. A swipe follows the finger:
+// when it starts, the current page and the neighbour being revealed are each
+// rendered once into an offscreen surface, and every frame until the pager
+// settles is just those two blits. Releasing flings or snaps back from the
+// finger's velocity, stepped by the frame clock; button/key page changes
+// slide the same way.
+class PagerView : public Gtk::Container {
+public:
+  PagerView();
+  ~PagerView() override;
+
+  // Page next to the current one in direction dir (-1 left, +1 right),
+  // built on demand; null at either end.
+  using NeighbourFn = std::function<Gtk::Widget*(int dir)>;
+  void set_neighbour_fn(NeighbourFn fn) { neighbour_ = std::move(fn); }
+
+  // `page` must be a child. Without animation it is shown at once.
+  void show_page(Gtk::Widget& page, int dir = 0);
+  Gtk::Widget* current() const { return current_; }
+
+  // Finger tracking; dx is the offset since the drag started.
+  void drag_begin();
+  void drag_update(double dx);
+  void drag_end();
+
+  // Jumps any animation to its end and drops the snapshot surfaces.
+  void settle_now();
+  void release_snapshots();
+
+  // The pager came to rest on a different page after a swipe.
+  sigc::signal<void(Gtk::Widget&)>& signal_page_changed() { return page_changed_; }
+
+protected:
+  void on_add(Gtk::Widget* child) override;
+  void on_remove(Gtk::Widget* child) override;
+  void forall_vfunc(gboolean include_internals, GtkCallback callback, gpointer data) override;
+  GType child_type_vfunc() const override;
+
+  Gtk::SizeRequestMode get_request_mode_vfunc() const override;
+  void get_preferred_width_vfunc(int& min_w, int& nat_w) const override;
+  void get_preferred_height_vfunc(int& min_h, int& nat_h) const override;
+  void on_size_allocate(Gtk::Allocation& alloc) override;
+  bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override;
+
+private:
+  enum class Mode { Live, Dragging, Animating };
+
+  void set_live(Gtk::Widget* page);
+  bool snapshot(Gtk::Widget& page, Cairo::RefPtr<Cairo::ImageSurface>& into);
+  bool reveal(int dir);  // snapshot the neighbour on that side
+  void animate_to(double target, double velocity, int64_t duration_us);
+  static gboolean on_tick(GtkWidget* w, GdkFrameClock* clock, gpointer self);
+  void finish();
+
+  std::vector<Gtk::Widget*> children_;
+  Gtk::Widget* current_ = nullptr;
+  NeighbourFn neighbour_;
+
+  Mode mode_ = Mode::Live;
+  double offset_ = 0.0;           // px; < 0 reveals the right neighbour
+  int side_ = 0;                  // which neighbour is snapshotted
+  Gtk::Widget* neighbour_page_ = nullptr;
+  Cairo::RefPtr<Cairo::ImageSurface> snap_current_;
+  Cairo::RefPtr<Cairo::ImageSurface> snap_neighbour_;
+
+  // Finger velocity, smoothed over the last updates.
+  double velocity_ = 0.0;         // px/s
+  double last_dx_ = 0.0;
+  int64_t last_us_ = 0;
+
+  // Hermite curve from (from_, v0_) to (to_, 0) over duration_us_.
+  guint tick_id_ = 0;
+  int64_t anim_t0_us_ = 0;
+  int64_t duration_us_ = 0;
+  double from_ = 0.0;
+  double to_ = 0.0;
+  double v0_ = 0.0;
+  bool notify_ = false;           // emit page_changed when it lands (swipes only)
+
+  sigc::signal<void(Gtk::Widget&)> page_changed_;
+
+  static constexpr double  kFlingPxPerS   = 450.0;
+  static constexpr double  kEdgeResist    = 0.3;   // rubber band without a neighbour
+  static constexpr int64_t kMinAnimUs     = 120000;
+  static constexpr int64_t kMaxAnimUs     = 320000;
+  static constexpr int64_t kSlideUs       = 250000;  // button/key page change
+};
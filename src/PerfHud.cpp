@@ -0,0 +1,210 @@
+#include "PerfHud.h"
+#include "AllocStats.h"
+#include "LaunchLatency.h"
+#include "PerfStats.h"
+#include "TileCache.h"
+#include "UiMetrics.h"
+
+#include <gtk/gtk.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+  #include <unistd.h>
+#endif
+
+namespace {
+
+// utime + stime of this process, in clock ticks.
+uint64_t read_cpu_ticks() {
+#ifdef _WIN32
+  return 0;
+#else
+  FILE* f = std::fopen("/proc/self/stat", "r");
+  if (!f) return 0;
+  char buf[1024];
+  const size_t n = std::fread(buf, 1, sizeof(buf) - 1, f);
+  std::fclose(f);
+  buf[n] = '\0';
+
+  // comm may contain spaces; fields restart after the last ')'.
+  const char* p = std::strrchr(buf, ')');
+  if (!p) return 0;
+  unsigned long long utime = 0, stime = 0;
+  // state ppid pgrp session tty tpgid flags minflt cminflt majflt cmajflt utime stime
+  if (std::sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu",
+                  &utime, &stime) != 2) return 0;
+  return utime + stime;
+#endif
+}
+
+double read_rss_mb() {
+#ifdef _WIN32
+  return 0.0;
+#else
+  FILE* f = std::fopen("/proc/self/statm", "r");
+  if (!f) return 0.0;
+  unsigned long size = 0, resident = 0;
+  const int n = std::fscanf(f, "%lu %lu", &size, &resident);
+  std::fclose(f);
+  if (n != 2) return 0.0;
+  return resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+#endif
+}
+
+} // namespace
+
+void PerfHud::Ring::push(double x) {
+  if (v.size() < v.capacity()) v.push_back(x);
+  else { v[next] = x; next = (next + 1) % v.size(); }
+}
+
+double PerfHud::Ring::percentile(double p) const {
+  if (v.empty()) return 0.0;
+  std::vector<double> s = v;
+  const std::size_t k = std::min(s.size() - 1, (std::size_t)(p * (s.size() - 1) + 0.5));
+  std::nth_element(s.begin(), s.begin() + k, s.end());
+  return s[k];
+}
+
+PerfHud::PerfHud() {
+  set_halign(Gtk::ALIGN_END);
+  set_valign(Gtk::ALIGN_START);
+  set_xalign(0.0f);
+  set_no_show_all(true);
+  get_style_context()->add_class("perf-hud");
+
+  Pango::FontDescription fd;
+  fd.set_family("Monospace");
+  fd.set_size(10 * Pango::SCALE);
+  override_font(fd);
+}
+
+PerfHud::~PerfHud() {
+  stop();
+}
+
+void PerfHud::attach(Gtk::Window& win) {
+  win_ = &win;
+
+  press_ = Gtk::GestureMultiPress::create(win);
+  press_->set_propagation_phase(Gtk::PHASE_CAPTURE);
+  press_->set_button(0);
+  press_->signal_pressed().connect([](int, double, double) { perf_note_input(); });
+}
+
+void PerfHud::toggle() {
+  if (get_visible()) stop();
+  else start();
+}
+
+void PerfHud::start() {
+  if (!win_) return;
+  clock_ = gtk_widget_get_frame_clock(GTK_WIDGET(win_->gobj()));
+  if (!clock_) return;
+
+  auto& p = perf_stats();
+  p.sampling = true;
+  p.pending_input_us = 0;
+
+  frame_ms_.clear();
+  input_ms_.clear();
+
+  last_wall_us_ = g_get_monotonic_time();
+  last_draws_ = p.draws;
+  last_draw_us_ = p.draw_us;
+  last_relayouts_ = resize_stats().relayouts;
+  last_restyles_ = p.restyles;
+  last_cpu_ticks_ = read_cpu_ticks();
+
+  g_object_ref(clock_);
+  after_paint_id_ = g_signal_connect(clock_, "after-paint", G_CALLBACK(&PerfHud::on_after_paint), this);
+  refresh_ = Glib::signal_timeout().connect(sigc::mem_fun(*this, &PerfHud::on_refresh), kRefreshMs);
+
+  set_text("…");
+  show();
+}
+
+void PerfHud::stop() {
+  perf_stats().sampling = false;
+  refresh_.disconnect();
+  if (clock_) {
+    if (after_paint_id_) g_signal_handler_disconnect(clock_, after_paint_id_);
+    g_object_unref(clock_);
+  }
+  clock_ = nullptr;
+  after_paint_id_ = 0;
+  hide();
+}
+
+void PerfHud::on_after_paint(GdkFrameClock* clock, gpointer self) {
+  auto* hud = static_cast<PerfHud*>(self);
+  const int64_t now = g_get_monotonic_time();
+
+  // Frame cost: from the frame clock's frame start until painting finished.
+  const int64_t start = gdk_frame_clock_get_frame_time(clock);
+  if (now >= start) hud->frame_ms_.push((now - start) / 1000.0);
+
+  auto& p = perf_stats();
+  if (p.pending_input_us) {
+    hud->input_ms_.push((now - p.pending_input_us) / 1000.0);
+    p.pending_input_us = 0;
+  }
+}
+
+bool PerfHud::on_refresh() {
+  auto& p = perf_stats();
+  const int64_t now = g_get_monotonic_time();
+  const double dt = std::max<int64_t>(1, now - last_wall_us_) / 1e6;
+
+  const uint64_t draws = p.draws - last_draws_;
+  const double draw_avg_us = draws ? (double)(p.draw_us - last_draw_us_) / draws : 0.0;
+  const uint64_t relayouts = resize_stats().relayouts - last_relayouts_;
+  const uint64_t restyles = p.restyles - last_restyles_;
+
+  const uint64_t cpu = read_cpu_ticks();
+#ifdef _WIN32
+  const double cpu_pct = 0.0;
+#else
+  const double cpu_pct = 100.0 * (double)(cpu - last_cpu_ticks_) / (double)sysconf(_SC_CLK_TCK) / dt;
+#endif
+
+  char buf[512];
+  std::snprintf(buf, sizeof(buf),
+      "frame  p50 %5.1f  p95 %5.1f  p99 %5.1f ms\n"
+      "draw   %6.1f us/tile  %5.0f tiles/s\n"
+      "layout %5.1f/s   style %5.1f/s\n"
+      "input  p50 %5.1f  p95 %5.1f ms\n"
+      "rss    %6.1f MB   cpu %5.1f%%\n"
+      "cache  %zu tiles",
+      frame_ms_.percentile(0.50), frame_ms_.percentile(0.95), frame_ms_.percentile(0.99),
+      draw_avg_us, draws / dt,
+      relayouts / dt, restyles / dt,
+      input_ms_.percentile(0.50), input_ms_.percentile(0.95),
+      read_rss_mb(), cpu_pct,
+      TileCache::instance().size());
+  std::string text = buf;
+  if constexpr (AllocStats::kEnabled) {
+    using AllocStats::Scope;
+    std::snprintf(buf, sizeof(buf), "\nalloc  draw %llu  swipe %llu /frame  %llu of %llu frames",
+                  (unsigned long long)AllocStats::last_frame(Scope::Draw).allocs,
+                  (unsigned long long)AllocStats::last_frame(Scope::Swipe).allocs,
+                  (unsigned long long)AllocStats::frames_with_allocs(),
+                  (unsigned long long)AllocStats::frames());
+    text += buf;
+  }
+  const std::string launch = LaunchLatency::instance().hud_line();
+  if (!launch.empty()) text += "\n" + launch;
+  set_text(text);
+
+  last_wall_us_ = now;
+  last_draws_ = p.draws;
+  last_draw_us_ = p.draw_us;
+  last_relayouts_ = resize_stats().relayouts;
+  last_restyles_ = p.restyles;
+  last_cpu_ticks_ = cpu;
+  return true;
+}
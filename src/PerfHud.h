@@ -0,0 +1,56 @@
+#pragma once
+
+#include <gtkmm/label.h>
+#include <gtkmm/window.h>
+#include <gtkmm/gesturemultipress.h>
+#include <glibmm/main.h>
+
+#include <cstdint>
+#include <vector>
+
+// Toggleable on-screen performance overlay: frame time percentiles, tile
+// draw cost, relayout/restyle rates, process RSS/CPU and input-to-frame
+// latency. While hidden it has no frame-clock handler and no timer.
+class PerfHud : public Gtk::Label {
+public:
+  PerfHud();
+  ~PerfHud() override;
+
+  // Hooks input timestamps on `win` (capture phase, never claims events).
+  void attach(Gtk::Window& win);
+  void toggle();
+
+private:
+  static void on_after_paint(GdkFrameClock* clock, gpointer self);
+  bool on_refresh();
+  void start();
+  void stop();
+
+  struct Ring {
+    std::vector<double> v;
+    std::size_t next = 0;
+    explicit Ring(std::size_t n) { v.reserve(n); }
+    void push(double x);
+    double percentile(double p) const;
+    void clear() { v.clear(); next = 0; }
+  };
+
+  Gtk::Window* win_ = nullptr;
+  Glib::RefPtr<Gtk::GestureMultiPress> press_;
+  GdkFrameClock* clock_ = nullptr;
+  gulong after_paint_id_ = 0;
+  sigc::connection refresh_;
+
+  Ring frame_ms_{240};
+  Ring input_ms_{32};
+
+  // Previous sample for rates
+  int64_t  last_wall_us_ = 0;
+  uint64_t last_draws_ = 0;
+  int64_t  last_draw_us_ = 0;
+  uint64_t last_relayouts_ = 0;
+  uint64_t last_restyles_ = 0;
+  uint64_t last_cpu_ticks_ = 0;
+
+  static constexpr unsigned kRefreshMs = 500;
+};
@@ -0,0 +1,6 @@
+#include "PerfStats.h"
+
+PerfStats& perf_stats() {
+  static PerfStats stats;
+  return stats;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <glib.h>
+
+#include <cstdint>
+
+// Counters fed by the hot paths and read by PerfHud. The timing fields are
+// only maintained while `sampling` is set (HUD visible), so the cost when
+// hidden is a single branch per draw/input.
+struct PerfStats {
+  bool sampling = false;
+
+  uint64_t draws = 0;      // IconCanvas::on_draw calls
+  int64_t  draw_us = 0;    // total time spent in them
+  uint64_t restyles = 0;   // toplevel style-updated emissions
+
+  int64_t pending_input_us = 0; // monotonic time of the last unanswered input, 0 = none
+};
+
+PerfStats& perf_stats();
+
+inline void perf_note_input() {
+  auto& p = perf_stats();
+  if (p.sampling && !p.pending_input_us) p.pending_input_us = g_get_monotonic_time();
+}
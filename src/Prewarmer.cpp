@@ -0,0 +1,417 @@
+#include "Prewarmer.h"
+#include "IoPressure.h"
+#include "LaunchStats.h"
+#include "Launcher.h"
+#include "Trace.h"
+
+#include <glib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <utility>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+namespace {
+
+// Per run: at most this much cold data is requested, at roughly kRate.
+constexpr uint64_t kBudgetBytes = 96ull << 20;
+constexpr uint64_t kRateBytesPerS = 16ull << 20;
+// PSI "some avg10" above this means someone is waiting on I/O: pause.
+constexpr double kMaxIoPressure = 5.0;
+constexpr int kMaxWaitS = 60;
+constexpr int kMaxDirFiles = 64;
+
+// Sleeps in short slices so shutdown never waits long; false if stopped.
+bool nap_ms(int64_t ms, const std::atomic<bool>& stop) {
+  for (; ms > 0 && !stop; ms -= 100) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(std::min<int64_t>(ms, 100)));
+  }
+  return !stop;
+}
+
+void set_idle_io_priority() {
+  // ioprio_set(IOPRIO_WHO_PROCESS, this thread, IOPRIO_CLASS_IDLE)
+  constexpr int kWhoProcess = 1;
+  constexpr int kClassIdle = 3;
+  constexpr int kClassShift = 13;
+  syscall(SYS_ioprio_set, kWhoProcess, 0, kClassIdle << kClassShift);
+}
+
+std::string dir_name(const std::string& path) {
+  const auto slash = path.rfind('/');
+  return slash == std::string::npos ? "." : path.substr(0, slash);
+}
+
+bool is_file(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+// ---- ELF dependencies ----
+
+template <typename Ehdr, typename Phdr, typename Dyn>
+bool read_dynamic(int fd, std::vector<std::string>& needed, std::vector<std::string>& paths) {
+  Ehdr eh;
+  if (pread(fd, &eh, sizeof(eh), 0) != (ssize_t)sizeof(eh)) return false;
+  if (eh.e_phentsize != sizeof(Phdr) || eh.e_phnum == 0 || eh.e_phnum > 256) return false;
+
+  std::vector<Phdr> ph(eh.e_phnum);
+  const ssize_t ph_bytes = (ssize_t)(sizeof(Phdr) * ph.size());
+  if (pread(fd, ph.data(), ph_bytes, (off_t)eh.e_phoff) != ph_bytes) return false;
+
+  // Virtual address -> file offset through the PT_LOAD segments.
+  auto to_offset = [&ph](uint64_t vaddr, uint64_t& off) {
+    for (const auto& p : ph) {
+      if (p.p_type == PT_LOAD && vaddr >= p.p_vaddr && vaddr < p.p_vaddr + p.p_filesz) {
+        off = vaddr - p.p_vaddr + p.p_offset;
+        return true;
+      }
+    }
+    return false;
+  };
+
+  for (const auto& p : ph) {
+    if (p.p_type != PT_DYNAMIC) continue;
+    if (p.p_filesz == 0 || p.p_filesz > (1u << 20)) return false;
+
+    std::vector<Dyn> dyn(p.p_filesz / sizeof(Dyn));
+    const ssize_t dyn_bytes = (ssize_t)(dyn.size() * sizeof(Dyn));
+    if (pread(fd, dyn.data(), dyn_bytes, (off_t)p.p_offset) != dyn_bytes) return false;
+
+    uint64_t strtab = 0, strsz = 0;
+    std::vector<uint64_t> need_off, path_off;
+    for (const auto& d : dyn) {
+      if (d.d_tag == DT_NULL) break;
+      switch (d.d_tag) {
+        case DT_STRTAB:  strtab = d.d_un.d_ptr; break;
+        case DT_STRSZ:   strsz = d.d_un.d_val; break;
+        case DT_NEEDED:  need_off.push_back(d.d_un.d_val); break;
+        case DT_RPATH:
+        case DT_RUNPATH: path_off.push_back(d.d_un.d_val); break;
+        default: break;
+      }
+    }
+
+    uint64_t str_file = 0;
+    if (!strtab || !strsz || strsz > (1u << 20) || !to_offset(strtab, str_file)) return false;
+    std::string strings(strsz, '\0');
+    if (pread(fd, strings.data(), strsz, (off_t)str_file) != (ssize_t)strsz) return false;
+
+    auto at = [&strings](uint64_t off) {
+      return off < strings.size() ? std::string(strings.c_str() + off) : std::string();
+    };
+    for (auto off : need_off) needed.push_back(at(off));
+    for (auto off : path_off) paths.push_back(at(off));
+    return true;
+  }
+  return true;  // static executable
+}
+
+bool elf_dynamic(const std::string& path, std::vector<std::string>& needed, std::vector<std::string>& paths) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  unsigned char ident[EI_NIDENT];
+  bool ok = pread(fd, ident, sizeof(ident), 0) == (ssize_t)sizeof(ident) &&
+            std::memcmp(ident, ELFMAG, SELFMAG) == 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  ok = ok && ident[EI_DATA] == ELFDATA2LSB;
+#else
+  ok = ok && ident[EI_DATA] == ELFDATA2MSB;
+#endif
+  if (ok) {
+    ok = ident[EI_CLASS] == ELFCLASS64 ? read_dynamic<Elf64_Ehdr, Elf64_Phdr, Elf64_Dyn>(fd, needed, paths)
+                                       : read_dynamic<Elf32_Ehdr, Elf32_Phdr, Elf32_Dyn>(fd, needed, paths);
+  }
+  close(fd);
+  return ok;
+}
+
+// ld.so's default search list (LD_LIBRARY_PATH, ld.so.conf.d, system dirs).
+const std::vector<std::string>& system_lib_dirs() {
+  static const std::vector<std::string> dirs = [] {
+    std::vector<std::string> out;
+    if (const char* ld = g_getenv("LD_LIBRARY_PATH")) {
+      gchar** parts = g_strsplit(ld, ":", -1);
+      for (gchar** p = parts; *p; ++p) if (**p) out.emplace_back(*p);
+      g_strfreev(parts);
+    }
+    if (DIR* d = opendir("/etc/ld.so.conf.d")) {
+      while (dirent* e = readdir(d)) {
+        if (!g_str_has_suffix(e->d_name, ".conf")) continue;
+        gchar* data = nullptr;
+        const std::string conf = std::string("/etc/ld.so.conf.d/") + e->d_name;
+        if (!g_file_get_contents(conf.c_str(), &data, nullptr, nullptr)) continue;
+        gchar** lines = g_strsplit(data, "\n", -1);
+        for (gchar** l = lines; *l; ++l) {
+          g_strstrip(*l);
+          if (**l == '/') out.emplace_back(*l);
+        }
+        g_strfreev(lines);
+        g_free(data);
+      }
+      closedir(d);
+    }
+    for (const char* dir : { "/lib", "/usr/lib", "/lib64", "/usr/lib64", "/usr/local/lib" }) {
+      out.emplace_back(dir);
+    }
+    return out;
+  }();
+  return dirs;
+}
+
+std::string find_library(const std::string& name, const std::string& origin,
+                         const std::vector<std::string>& rpaths) {
+  if (name.find('/') != std::string::npos) return is_file(name) ? name : std::string();
+
+  auto try_dir = [&name](std::string dir) {
+    const std::string p = dir + "/" + name;
+    return is_file(p) ? p : std::string();
+  };
+
+  for (const auto& rp : rpaths) {
+    gchar** parts = g_strsplit(rp.c_str(), ":", -1);
+    std::string hit;
+    for (gchar** p = parts; *p && hit.empty(); ++p) {
+      std::string dir = *p;
+      const auto o = dir.find("$ORIGIN");
+      if (o != std::string::npos) dir.replace(o, 7, origin);
+      if (!dir.empty()) hit = try_dir(dir);
+    }
+    g_strfreev(parts);
+    if (!hit.empty()) return hit;
+  }
+  for (const auto& dir : system_lib_dirs()) {
+    auto hit = try_dir(dir);
+    if (!hit.empty()) return hit;
+  }
+  return {};
+}
+
+// Script interpreter from "#!", with "/usr/bin/env prog" resolved on PATH.
+std::string interpreter_of(const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return {};
+  char buf[256] = {};
+  const ssize_t n = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if (n < 3 || buf[0] != '#' || buf[1] != '!') return {};
+
+  gchar** argv = g_strsplit_set(g_strstrip(buf + 2), " \t\n", 3);
+  std::string interp = argv[0] ? argv[0] : "";
+  if (g_str_has_suffix(interp.c_str(), "/env") && argv[0] && argv[1]) {
+    gchar* found = g_find_program_in_path(argv[1]);
+    interp = found ? found : "";
+    g_free(found);
+  }
+  g_strfreev(argv);
+  return interp;
+}
+
+// Executable + interpreter + transitive DT_NEEDED closure, in load order.
+void collect_program(const std::string& exe, std::vector<std::string>& out,
+                     std::unordered_set<std::string>& seen) {
+  std::vector<std::string> queue = { exe };
+  const std::string interp = interpreter_of(exe);
+  if (!interp.empty()) queue.push_back(interp);
+
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    const std::string file = queue[i];
+    if (!seen.insert(file).second) continue;
+    out.push_back(file);
+
+    std::vector<std::string> needed, rpaths;
+    if (!elf_dynamic(file, needed, rpaths)) continue;
+    for (const auto& lib : needed) {
+      auto path = find_library(lib, dir_name(file), rpaths);
+      if (!path.empty() && !seen.count(path)) queue.push_back(std::move(path));
+    }
+  }
+}
+
+void collect_extra(const std::string& path, std::vector<std::string>& out,
+                   std::unordered_set<std::string>& seen) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) return;
+  if (S_ISREG(st.st_mode)) {
+    if (seen.insert(path).second) out.push_back(path);
+    return;
+  }
+  if (!S_ISDIR(st.st_mode)) return;
+
+  DIR* d = opendir(path.c_str());
+  if (!d) return;
+  int n = 0;
+  while (dirent* e = readdir(d)) {
+    if (e->d_name[0] == '.') continue;
+    const std::string p = path + "/" + e->d_name;
+    if (is_file(p) && seen.insert(p).second) out.push_back(p);
+    if (++n >= kMaxDirFiles) break;
+  }
+  closedir(d);
+}
+
+// Bytes of `fd` not in the page cache.
+uint64_t cold_bytes(int fd, uint64_t size) {
+  if (size == 0) return 0;
+  void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) return size;
+
+  const long page = sysconf(_SC_PAGESIZE);
+  std::vector<unsigned char> vec((size + page - 1) / page);
+  uint64_t cold = size;
+  if (mincore(map, size, vec.data()) == 0) {
+    uint64_t resident = 0;
+    for (auto v : vec) resident += (v & 1);
+    cold = (vec.size() - resident) * (uint64_t)page;
+  }
+  munmap(map, size);
+  return cold;
+}
+
+} // namespace
+
+#endif // __linux__
+
+Prewarmer::~Prewarmer() {
+  timer_.disconnect();
+  stop_ = true;
+  if (worker_.joinable()) worker_.join();
+}
+
+void Prewarmer::set_targets(const IconConfig& config) {
+  targets_.clear();
+  for (const auto& page : config.pages) {
+    for (const auto& spec : page) {
+      const auto argv = Launcher::build_argv(spec);
+      if (argv.empty()) continue;
+      auto& extra = targets_[argv.front()];
+      extra.insert(extra.end(), spec.prewarm.begin(), spec.prewarm.end());
+    }
+  }
+}
+
+void Prewarmer::start() {
+#ifdef __linux__
+  if (timer_.connected() || g_getenv("SV_DASHBOARD_NO_PREWARM")) return;
+  timer_ = Glib::signal_timeout().connect_seconds(sigc::mem_fun(*this, &Prewarmer::on_timer), kFirstRunS);
+#endif
+}
+
+void Prewarmer::suspend() {
+  suspended_ = timer_.connected();
+  timer_.disconnect();
+}
+
+void Prewarmer::resume() {
+  if (!suspended_) return;
+  suspended_ = false;
+  timer_ = Glib::signal_timeout().connect_seconds(sigc::mem_fun(*this, &Prewarmer::on_timer),
+                                                  first_ ? kFirstRunS : kIntervalS);
+}
+
+bool Prewarmer::on_timer() {
+  if (first_) {
+    // Switch from the startup delay to the regular interval.
+    first_ = false;
+    timer_ = Glib::signal_timeout().connect_seconds(sigc::mem_fun(*this, &Prewarmer::on_timer), kIntervalS);
+    tick();
+    return false;
+  }
+  tick();
+  return true;
+}
+
+void Prewarmer::tick() {
+  // Don't compete with an app that is starting right now.
+  auto& stats = LaunchStats::instance();
+  const int64_t since = g_get_monotonic_time() - stats.last_launch_us();
+  if (busy_ || (stats.last_launch_us() && since < 60 * G_USEC_PER_SEC)) return;
+
+  std::vector<Job> jobs;
+  for (const auto& program : stats.top(kTopPrograms * 2)) {
+    auto it = targets_.find(program);
+    if (it == targets_.end()) continue;  // tile removed from the config
+
+    gchar* exe = g_find_program_in_path(program.c_str());
+    if (!exe) continue;
+    jobs.push_back({ exe, it->second });
+    g_free(exe);
+    if (jobs.size() == kTopPrograms) break;
+  }
+
+  if (!jobs.empty()) {
+    if (worker_.joinable()) worker_.join();
+    busy_ = true;
+    worker_ = std::thread(&Prewarmer::run, this, std::move(jobs));
+  }
+}
+
+void Prewarmer::run(std::vector<Job> jobs) {
+#ifdef __linux__
+  SV_TRACE_SCOPE("Prewarmer::run");
+  set_idle_io_priority();
+
+  std::unordered_set<std::string> seen;
+  uint64_t budget = kBudgetBytes;
+  uint64_t requested = 0;
+  std::size_t files = 0;
+
+  for (const auto& job : jobs) {
+    if (stop_) goto done;
+    std::vector<std::string> list;
+    collect_program(job.program, list, seen);
+    for (const auto& p : job.extra) collect_extra(p, list, seen);
+
+    for (const auto& path : list) {
+      if (stop_) goto done;
+
+      for (int waited = 0; IoPressure::busy(kMaxIoPressure); waited += 2) {
+        if (waited >= kMaxWaitS || !nap_ms(2000, stop_)) goto done;  // stays busy: next interval
+      }
+
+      const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) continue;
+      struct stat st;
+      const uint64_t size = (fstat(fd, &st) == 0) ? (uint64_t)st.st_size : 0;
+      const uint64_t cold = cold_bytes(fd, size);
+      if (cold > budget) {
+        close(fd);
+        goto done;
+      }
+      if (cold) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        budget -= cold;
+        requested += cold;
+        ++files;
+      }
+      close(fd);
+
+      // Pace the readahead so it trickles instead of saturating the card.
+      if (cold && !nap_ms((int64_t)(cold * 1000 / kRateBytesPerS), stop_)) goto done;
+    }
+  }
+
+done:
+  g_debug("prewarm: %zu program(s), %zu file(s), %" G_GUINT64_FORMAT " KiB requested",
+          jobs.size(), files, requested >> 10);
+#else
+  (void)jobs;
+#endif
+  busy_ = false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glibmm/main.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Icons.h"
+
+// Pulls the files of the most frequently launched apps into the page cache
+// while the dashboard is idle, so their next cold start skips most of the
+// SD card reads: the executable (or script + interpreter), its DT_NEEDED
+// libraries (transitively) and the tile's optional "prewarm" paths.
+//
+// Runs on a worker thread at idle I/O priority with posix_fadvise(WILLNEED).
+// Only bytes not already resident count against a per-run budget, reads are
+// paced, and the run pauses while /proc/pressure/io reports contention
+// (giving up if it stays busy). Linux only; SV_DASHBOARD_NO_PREWARM=1 disables it.
+class Prewarmer {
+public:
+  Prewarmer() = default;
+  ~Prewarmer();
+
+  Prewarmer(const Prewarmer&) = delete;
+  Prewarmer& operator=(const Prewarmer&) = delete;
+
+  // Tiles define which programs exist and their extra paths.
+  void set_targets(const IconConfig& config);
+  void start();
+  // Idle mode: no timer at all while suspended.
+  void suspend();
+  void resume();
+
+  struct Job {
+    std::string program;                // resolved executable
+    std::vector<std::string> extra;     // per-tile prewarm paths
+  };
+
+private:
+  bool on_timer();
+  void tick();
+  void run(std::vector<Job> jobs);
+
+  static constexpr unsigned kFirstRunS = 30;
+  static constexpr unsigned kIntervalS = 15 * 60;
+  static constexpr std::size_t kTopPrograms = 5;
+
+  std::unordered_map<std::string, std::vector<std::string>> targets_;  // argv[0] -> extra
+  sigc::connection timer_;
+  bool first_ = true;
+  bool suspended_ = false;
+
+  std::thread worker_;
+  std::atomic<bool> busy_{false};
+  std::atomic<bool> stop_{false};
+};
@@ -0,0 +1,256 @@
+#include "ProcessIndex.h"
+#include "Trace.h"
+
+#include <glib.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string base_name(const std::string& path) {
+  const auto slash = path.rfind('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+bool is_interpreter(const std::string& exe) {
+  const std::string b = base_name(exe);
+  return b == "sh" || b == "bash" || b == "dash" || b == "perl" ||
+         b.rfind("python", 0) == 0 || b.rfind("node", 0) == 0;
+}
+
+// PATH lookup + symlink resolution, so "/usr/bin/opencpn" and "opencpn" agree.
+std::string resolve_program(const std::string& program) {
+  gchar* found = g_find_program_in_path(program.c_str());
+  std::string path = found ? found : program;
+  g_free(found);
+#ifdef __linux__
+  if (char* real = realpath(path.c_str(), nullptr)) {
+    path = real;
+    free(real);
+  }
+#endif
+  return path;
+}
+
+// Absolute, symlink-free form of `path`, relative paths taken from `cwd`
+// (empty: ours).
+std::string resolve_path(const std::string& path, const std::string& cwd) {
+  std::string full = path.empty() || path[0] == '/' || cwd.empty() ? path : cwd + "/" + path;
+#ifdef __linux__
+  if (char* real = realpath(full.c_str(), nullptr)) {
+    full = real;
+    free(real);
+  }
+#endif
+  return full;
+}
+
+// Where the script sits in an interpreter's argv, past its flags
+// ("python3 -u script.py"); argv.size() if there is none.
+std::size_t script_index(const std::vector<std::string>& argv, std::size_t from) {
+  while (from < argv.size() && !argv[from].empty() && argv[from][0] == '-') ++from;
+  return from;
+}
+
+// a[i..] == b[j..]
+bool same_tail(const std::vector<std::string>& a, std::size_t i,
+               const std::vector<std::string>& b, std::size_t j) {
+  return a.size() - i == b.size() - j && std::equal(a.begin() + i, a.end(), b.begin() + j);
+}
+
+// Field 22 of /proc/<pid>/stat, in clock ticks since boot; 0 if the pid is gone.
+uint64_t read_starttime(pid_t pid) {
+#ifdef __linux__
+  char path[64];
+  g_snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return 0;
+  char buf[1024];
+  const ssize_t len = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if (len <= 0) return 0;
+  buf[len] = '\0';
+
+  // comm (field 2) may hold spaces and parentheses; count from its end.
+  const char* p = std::strrchr(buf, ')');
+  if (p) p = std::strchr(p, ' ');  // before field 3
+  for (int field = 3; field < 22 && p; ++field) p = std::strchr(p + 1, ' ');
+  return p ? std::strtoull(p + 1, nullptr, 10) : 0;
+#else
+  (void)pid;
+  return 0;
+#endif
+}
+
+// Clock ticks since boot, the unit of starttime.
+uint64_t boot_ticks() {
+#ifdef __linux__
+  timespec ts{};
+  if (clock_gettime(CLOCK_BOOTTIME, &ts) != 0) return 0;
+  const uint64_t hz = (uint64_t)sysconf(_SC_CLK_TCK);
+  return (uint64_t)ts.tv_sec * hz + (uint64_t)ts.tv_nsec * hz / 1000000000u;
+#else
+  return 0;
+#endif
+}
+
+} // namespace
+
+ProcessIndex& ProcessIndex::instance() {
+  static ProcessIndex index;
+  return index;
+}
+
+void ProcessIndex::read_proc(pid_t pid, Proc& p) {
+#ifdef __linux__
+  ++stats_.proc_reads;
+  char path[64];
+
+  char exe[4096];
+  g_snprintf(path, sizeof(path), "/proc/%d/exe", (int)pid);
+  const ssize_t n = readlink(path, exe, sizeof(exe) - 1);
+  if (n > 0) {
+    p.exe.assign(exe, (std::size_t)n);
+    static constexpr const char kDeleted[] = " (deleted)";  // binary replaced by an upgrade
+    if (g_str_has_suffix(p.exe.c_str(), kDeleted)) p.exe.resize(p.exe.size() - (sizeof(kDeleted) - 1));
+  }
+
+  p.starttime = read_starttime(pid);
+  p.provisional = p.starttime && boot_ticks() < p.starttime + kSettleS * (uint64_t)sysconf(_SC_CLK_TCK);
+
+  g_snprintf(path, sizeof(path), "/proc/%d/cmdline", (int)pid);
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return;
+  char buf[4096];
+  const ssize_t len = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if (len <= 0) return;  // kernel thread
+  buf[len] = '\0';
+
+  std::vector<std::string> argv;
+  for (std::size_t off = 0; off < (std::size_t)len; off += argv.back().size() + 1) argv.emplace_back(buf + off);
+  p.argv0 = base_name(argv.front());
+  p.args.assign(argv.begin() + 1, argv.end());
+
+  const std::size_t script = script_index(p.args, 0);
+  if (script < p.args.size() && is_interpreter(p.exe)) {
+    char cwd[4096];
+    g_snprintf(path, sizeof(path), "/proc/%d/cwd", (int)pid);
+    const ssize_t cn = readlink(path, cwd, sizeof(cwd) - 1);
+    p.script = resolve_path(p.args[script], cn > 0 ? std::string(cwd, (std::size_t)cn) : std::string());
+    p.script_end = script + 1;
+  }
+#else
+  (void)pid;
+  (void)p;
+#endif
+}
+
+void ProcessIndex::refresh() {
+#ifdef __linux__
+  const int64_t t0 = g_get_monotonic_time();
+  ++stats_.scans;
+  ++generation_;
+
+  DIR* dir = opendir("/proc");
+  if (!dir) return;
+
+  const pid_t self = getpid();
+  while (dirent* e = readdir(dir)) {
+    if (e->d_name[0] < '1' || e->d_name[0] > '9') continue;
+    char* end = nullptr;
+    const long pid = std::strtol(e->d_name, &end, 10);
+    if (*end || pid == self) continue;
+
+    auto [it, inserted] = procs_.try_emplace((pid_t)pid);
+    Proc& p = it->second;
+    const bool reread = !inserted && p.provisional;  // may have exec'd since
+    if (reread) p = Proc{};
+    if (inserted || reread) read_proc((pid_t)pid, p);
+    p.generation = generation_;
+  }
+  closedir(dir);
+
+  for (auto it = procs_.begin(); it != procs_.end();) {
+    if (it->second.generation != generation_) it = procs_.erase(it);
+    else ++it;
+  }
+  stats_.last_scan_us = g_get_monotonic_time() - t0;
+#endif
+}
+
+bool ProcessIndex::matches(const Proc& p, const std::vector<std::string>& argv, const std::string& resolved,
+                           const std::string& script, std::size_t script_end) const {
+  if (!script.empty()) return p.script == script && same_tail(p.args, p.script_end, argv, script_end);
+  if (!p.exe.empty() && p.exe == resolved && same_tail(p.args, 0, argv, 1)) return true;
+  // A script run through its #! line shows up as interpreter + script.
+  if (!p.script.empty() && p.script == resolved && same_tail(p.args, p.script_end, argv, 1)) return true;
+  if (argv.size() > 1) return false;
+
+  const std::string base = base_name(resolved);
+  const std::string given = base_name(argv.front());
+  return (!p.exe.empty() && base_name(p.exe) == base) || p.argv0 == given || p.argv0 == base ||
+         (!p.script.empty() && (base_name(p.script) == given || base_name(p.script) == base));
+}
+
+std::vector<pid_t> ProcessIndex::find(const std::vector<std::string>& argv) {
+  SV_TRACE_SCOPE("ProcessIndex::find");
+  refresh();
+  if (argv.empty()) return {};
+
+  const std::string resolved = resolve_program(argv.front());
+  std::string script;
+  std::size_t script_end = 0;
+  if (is_interpreter(resolved)) {
+    const std::size_t i = script_index(argv, 1);
+    if (i < argv.size()) {
+      script = resolve_path(argv[i], std::string());
+      script_end = i + 1;
+    }
+  }
+
+  std::vector<pid_t> out;
+  for (auto& [pid, p] : procs_) {
+    if (!matches(p, argv, resolved, script, script_end)) continue;
+    // Entries are read once; a pid reused since then is another process.
+    if (read_starttime(pid) != p.starttime) {
+      const uint32_t generation = p.generation;
+      p = Proc{};
+      p.generation = generation;
+      read_proc(pid, p);
+      if (!matches(p, argv, resolved, script, script_end)) continue;
+    }
+    out.push_back(pid);
+  }
+  return out;
+}
+
+void ProcessIndex::add(pid_t pid, const std::vector<std::string>& argv) {
+  if (argv.empty()) return;
+  auto& p = procs_[pid];
+  p = Proc{};
+  p.exe = resolve_program(argv.front());
+  p.argv0 = base_name(argv.front());
+  p.args.assign(argv.begin() + 1, argv.end());
+  const std::size_t script = script_index(p.args, 0);
+  if (script < p.args.size() && is_interpreter(p.exe)) {
+    p.script = resolve_path(p.args[script], std::string());
+    p.script_end = script + 1;
+  }
+  // Set at fork, so it already holds before the exec.
+  p.starttime = read_starttime(pid);
+  p.generation = generation_;
+}
+
+void ProcessIndex::remove(pid_t pid) {
+  procs_.erase(pid);
+}
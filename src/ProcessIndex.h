@@ -0,0 +1,63 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Running processes by command line, for "onlyone" tiles. Covers processes
+// started outside the dashboard too. refresh() diffs the /proc directory
+// listing against the previous one and only reads exe/cmdline/stat of pids
+// it has not seen, so a lookup costs one readdir plus the new arrivals.
+// A pid read within a second of its start may still be between fork and
+// exec (showing its parent's command line), so it is read again next scan.
+// Children we spawn are added directly, before they show up in a scan.
+// Linux only; elsewhere the index stays empty and nothing is deduplicated.
+class ProcessIndex {
+public:
+  static ProcessIndex& instance();
+
+  void refresh();
+
+  // Refreshes, then returns live pids running `argv`: the same resolved
+  // executable with the same arguments, or for interpreters the same script
+  // with the same arguments after it. Only an argv without arguments also
+  // matches by basename (exe, argv[0] or script), for wrappers that re-exec.
+  std::vector<pid_t> find(const std::vector<std::string>& argv);
+
+  void add(pid_t pid, const std::vector<std::string>& argv);
+  void remove(pid_t pid);
+
+  struct Stats {
+    uint64_t scans = 0;
+    uint64_t proc_reads = 0;   // pids whose exe/cmdline had to be read
+    int64_t  last_scan_us = 0;
+  };
+  const Stats& stats() const { return stats_; }
+
+private:
+  ProcessIndex() = default;
+
+  struct Proc {
+    std::string exe;                // resolved /proc/<pid>/exe (empty if unreadable)
+    std::string argv0;              // basename of argv[0]
+    std::vector<std::string> args;  // argv[1..]
+    std::string script;             // resolved script path when exe is an interpreter
+    std::size_t script_end = 0;     // index in args just past the script
+    uint64_t starttime = 0;         // /proc/<pid>/stat field 22; tells a reused pid apart
+    uint32_t generation = 0;
+    bool provisional = false;       // read under kSettleS after it started
+  };
+
+  static constexpr int kSettleS = 1;
+
+  void read_proc(pid_t pid, Proc& p);
+  bool matches(const Proc& p, const std::vector<std::string>& argv, const std::string& resolved,
+               const std::string& script, std::size_t script_end) const;
+
+  std::unordered_map<pid_t, Proc> procs_;
+  uint32_t generation_ = 0;
+  Stats stats_;
+};
@@ -0,0 +1,155 @@
+#include "ResourceMonitor.h"
+#include "Trace.h"
+
+#include <glib.h>
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+// One read() into a stack buffer: no allocation per sample.
+bool read_small(const char* path, char* buf, std::size_t size) {
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  const ssize_t n = read(fd, buf, size - 1);
+  close(fd);
+  if (n <= 0) return false;
+  buf[n] = '\0';
+  return true;
+}
+
+// utime + stime (fields 14/15) and resident pages; false if the pid is gone.
+bool sample_pid(pid_t pid, uint64_t& ticks, uint64_t& rss_pages) {
+  char path[64];
+  char buf[1024];
+
+  g_snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+  if (!read_small(path, buf, sizeof(buf))) return false;
+  const char* p = std::strrchr(buf, ')');  // comm may contain spaces
+  unsigned long long ut = 0, st = 0;
+  if (!p || std::sscanf(p + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &ut, &st) != 2) {
+    return false;
+  }
+  ticks = ut + st;
+
+  g_snprintf(path, sizeof(path), "/proc/%d/statm", (int)pid);
+  if (!read_small(path, buf, sizeof(buf))) return false;
+  unsigned long long size = 0, rss = 0;
+  if (std::sscanf(buf, "%llu %llu", &size, &rss) != 2) return false;
+  rss_pages = rss;
+  return true;
+}
+#endif
+
+int quantize(double v, int step) {
+  return ((int)(v + step / 2.0) / step) * step;
+}
+
+} // namespace
+
+ResourceMonitor& ResourceMonitor::instance() {
+  static ResourceMonitor monitor;
+  return monitor;
+}
+
+void ResourceMonitor::track(const std::string& tile, pid_t pid) {
+#ifdef __linux__
+  auto [it, inserted] = procs_.try_emplace(pid);
+  it->second.tile = tile;
+  if (inserted) {
+    uint64_t rss = 0;
+    if (!sample_pid(pid, it->second.ticks, rss)) it->second.ticks = 0;
+    it->second.at_us = g_get_monotonic_time();
+  }
+  ensure_timer();
+#else
+  (void)tile;
+  (void)pid;
+#endif
+}
+
+void ResourceMonitor::untrack(pid_t pid) {
+  auto it = procs_.find(pid);
+  if (it == procs_.end()) return;
+  const std::string tile = it->second.tile;
+  procs_.erase(it);
+
+  for (const auto& [p, proc] : procs_) {
+    if (proc.tile == tile) return;  // still running elsewhere; next sample updates it
+  }
+  if (shown_.erase(tile)) changed_.emit(tile, false, Usage{});
+  if (procs_.empty()) timer_.disconnect();
+}
+
+bool ResourceMonitor::usage(const std::string& tile, Usage& out) const {
+  auto it = shown_.find(tile);
+  if (it == shown_.end()) return false;
+  out = it->second;
+  return true;
+}
+
+void ResourceMonitor::ensure_timer() {
+  if (suspended_ || timer_.connected() || procs_.empty()) return;
+  timer_ = Glib::signal_timeout().connect(sigc::mem_fun(*this, &ResourceMonitor::on_sample), kIntervalMs);
+}
+
+void ResourceMonitor::suspend() {
+  suspended_ = true;
+  timer_.disconnect();
+}
+
+void ResourceMonitor::resume() {
+  suspended_ = false;
+  ensure_timer();
+}
+
+bool ResourceMonitor::on_sample() {
+#ifdef __linux__
+  SV_TRACE_SCOPE("ResourceMonitor::on_sample");
+
+  static const double tck = (double)sysconf(_SC_CLK_TCK);
+  static const double page_mb = (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+  const int64_t now = g_get_monotonic_time();
+
+  // Sum per tile (an "onlyone" tile may own several processes).
+  std::map<std::string, std::pair<double, double>> totals;  // cpu %, rss MB
+  std::vector<pid_t> gone;
+
+  for (auto& [pid, proc] : procs_) {
+    uint64_t ticks = 0, rss = 0;
+    if (!sample_pid(pid, ticks, rss)) {
+      gone.push_back(pid);
+      continue;
+    }
+    const double dt = (now - proc.at_us) / 1e6;
+    const double cpu = (dt > 0 && proc.ticks && ticks >= proc.ticks)
+                     ? 100.0 * (double)(ticks - proc.ticks) / tck / dt : 0.0;
+    proc.ticks = ticks;
+    proc.at_us = now;
+
+    auto& t = totals[proc.tile];
+    t.first += cpu;
+    t.second += (double)rss * page_mb;
+  }
+
+  for (const auto& [tile, t] : totals) {
+    const Usage u{ quantize(t.first, kCpuStep), quantize(t.second, kRssStepMb) };
+    auto it = shown_.find(tile);
+    if (it != shown_.end() && it->second == u) continue;  // below display resolution
+    shown_[tile] = u;
+    changed_.emit(tile, true, u);
+  }
+
+  for (pid_t pid : gone) untrack(pid);
+  return !procs_.empty();
+#else
+  return false;
+#endif
+}
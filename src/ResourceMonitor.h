@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glibmm/main.h>
+#include <sigc++/signal.h>
+#include <sys/types.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// CPU and RSS of the apps started from tiles (including "onlyone" apps found
+// already running), sampled for all of them in one timer tick from
+// /proc/<pid>/stat and statm. Values are quantized, so
+// signal_changed() fires only for tiles whose displayed value changed.
+// The timer runs only while something is tracked. Linux only.
+class ResourceMonitor {
+public:
+  static ResourceMonitor& instance();
+
+  struct Usage {
+    int cpu_pct = 0;  // of one core, multiple of kCpuStep
+    int rss_mb = 0;   // multiple of kRssStepMb
+    bool operator==(const Usage&) const = default;
+  };
+
+  // `tile` is Launcher::tile_key(): the tile's name, else its title, else
+  // the program. DesktopIcon badges are looked up by the same key.
+  void track(const std::string& tile, pid_t pid);
+  void untrack(pid_t pid);
+
+  // Current usage; false if nothing of this tile is running.
+  bool usage(const std::string& tile, Usage& out) const;
+
+  // (tile, running, usage); not running => badge cleared.
+  sigc::signal<void(const std::string&, bool, const Usage&)>& signal_changed() { return changed_; }
+
+  // Stops sampling without forgetting what is tracked (idle mode).
+  void suspend();
+  void resume();
+
+  static constexpr int kCpuStep = 5;
+  static constexpr int kRssStepMb = 8;
+
+private:
+  ResourceMonitor() = default;
+
+  bool on_sample();
+  void ensure_timer();
+
+  struct Proc {
+    std::string tile;
+    uint64_t ticks = 0;  // utime + stime at the last sample
+    int64_t at_us = 0;
+  };
+
+  static constexpr unsigned kIntervalMs = 2000;
+
+  std::map<pid_t, Proc> procs_;
+  std::map<std::string, Usage> shown_;  // last emitted per tile
+  sigc::connection timer_;
+  bool suspended_ = false;
+  sigc::signal<void(const std::string&, bool, const Usage&)> changed_;
+};
@@ -1,4 +1,5 @@
 #include "RuntimeEnv.h"
+#include "Trace.h"
 
 #include <cstdlib>
 #include <filesystem>
@@ -91,6 +92,8 @@ string RuntimeEnv::localAppDataDir() {
 
 
 void RuntimeEnv::setup() {
+  SV_TRACE_SCOPE("RuntimeEnv::setup");
+
 #ifdef _WIN32
   const string root = exeDir();
 
@@ -0,0 +1,81 @@
+#include "ScreenCss.h"
+#include "Theme.h"
+#include "Trace.h"
+
+#include <gdkmm/screen.h>
+#include <gtkmm/stylecontext.h>
+
+#include <glib.h>
+
+ScreenCss& ScreenCss::instance() {
+  static ScreenCss css;
+  return css;
+}
+
+bool ScreenCss::load(const Glib::RefPtr<Gtk::CssProvider>& p, const std::string& css) {
+  try {
+    return p->load_from_data(css);
+  } catch (const Glib::Error& e) {
+    g_warning("ScreenCss: %s", e.what().c_str());
+    return false;
+  }
+}
+
+void ScreenCss::install(const Glib::RefPtr<Gtk::CssProvider>& p, const std::string& css) {
+  load(p, css);
+  Gtk::StyleContext::add_provider_for_screen(
+      Gdk::Screen::get_default(), p, GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+}
+
+void ScreenCss::ensure(const IconConfig& config) {
+  if (base_) return;
+  SV_TRACE_SCOPE("ScreenCss::ensure");
+
+  palette_ = config.palette;
+  schemes_ = Theme::merge_schemes(config.schemes);
+
+  base_ = Gtk::CssProvider::create();
+  scheme_ = Gtk::CssProvider::create();
+  palette_css_ = Gtk::CssProvider::create();
+  install(base_, Theme::base_css());
+  install(scheme_, Theme::scheme_css(schemes_));
+  install(palette_css_, Theme::palette_css(palette_));
+}
+
+bool ScreenCss::apply(const IconConfig& config) {
+  if (!base_) {
+    ensure(config);
+    return true;
+  }
+
+  // Providers stay installed; reloading their data restyles in place. A
+  // sheet that fails to parse is put back as it was, and the old input is
+  // kept so the next reload tries the new one again.
+  bool restyled = false;
+  if (config.palette != palette_) {
+    if (load(palette_css_, Theme::palette_css(config.palette))) {
+      palette_ = config.palette;
+      restyled = true;
+    } else {
+      load(palette_css_, Theme::palette_css(palette_));
+    }
+  }
+
+  auto schemes = Theme::merge_schemes(config.schemes);
+  if (schemes != schemes_) {
+    if (load(scheme_, Theme::scheme_css(schemes))) {
+      schemes_ = std::move(schemes);
+      restyled = true;
+    } else {
+      load(scheme_, Theme::scheme_css(schemes_));
+    }
+  }
+  return restyled;
+}
+
+void ScreenCss::ensure_metrics(int bucket, double scale) {
+  if (metrics_.count(bucket)) return;
+  auto p = Gtk::CssProvider::create();
+  install(p, Theme::metrics_css(bucket, scale));
+  metrics_.emplace(bucket, p);
+}
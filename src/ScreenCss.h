@@ -0,0 +1,44 @@
+#pragma once
+
+#include <gtkmm/cssprovider.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Icons.h"
+
+// The Theme sheets, installed once on the default screen and shared by
+// every window. Each window picks its scheme and scale bucket through
+// classes on its own toplevel, so one set of providers serves them all.
+class ScreenCss {
+public:
+  static ScreenCss& instance();
+
+  // Installs base/scheme/palette for `config` on first use; no-op after.
+  void ensure(const IconConfig& config);
+  // Live reload: reparses only the sheets whose input changed. True if
+  // tile colors may have changed (rendered tiles are stale).
+  bool apply(const IconConfig& config);
+  // Bucket sheets are parsed on first use and stay installed.
+  void ensure_metrics(int bucket, double scale);
+
+  // Day, Dusk, Night, then the config's own; see Theme::merge_schemes.
+  const std::vector<SchemeSpec>& schemes() const { return schemes_; }
+
+private:
+  ScreenCss() = default;
+
+  // False (with a warning) if GTK rejects the sheet.
+  static bool load(const Glib::RefPtr<Gtk::CssProvider>& p, const std::string& css);
+  static void install(const Glib::RefPtr<Gtk::CssProvider>& p, const std::string& css);
+
+  Glib::RefPtr<Gtk::CssProvider> base_;
+  Glib::RefPtr<Gtk::CssProvider> scheme_;
+  Glib::RefPtr<Gtk::CssProvider> palette_css_;
+  std::map<int, Glib::RefPtr<Gtk::CssProvider>> metrics_;
+
+  std::vector<std::pair<std::string, std::string>> palette_;
+  std::vector<SchemeSpec> schemes_;
+};
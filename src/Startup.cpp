@@ -0,0 +1,54 @@
+#include "Startup.h"
+#include "Trace.h"
+
+#include <iostream>
+
+Startup::~Startup() {
+  if (font_thread_.joinable()) font_thread_.join();
+  if (config_thread_.joinable()) config_thread_.join();
+}
+
+void Startup::start() {
+  if (started_) return;
+  started_ = true;
+
+  font_thread_ = std::thread([this] { fonts_.prepare(); });
+  config_thread_ = std::thread([this] { config_ = load_icon_config(); });
+}
+
+bool Startup::finish_fonts() {
+  if (fonts_done_) return fonts_ok_;
+  if (!started_) start();
+
+  {
+    SV_TRACE_SCOPE("Startup: wait fonts");
+    if (font_thread_.joinable()) font_thread_.join();
+  }
+  fonts_ok_ = fonts_.attach();
+  fonts_done_ = true;
+
+  if (!fonts_ok_) {
+    std::cerr << "Warning: FA fonts not registered; icons may fall back.\n";
+  }
+  return fonts_ok_;
+}
+
+void Startup::finish_labels() {
+  if (fonts_done_) return;
+  if (!started_) start();
+  {
+    SV_TRACE_SCOPE("Startup: wait fonts");
+    if (font_thread_.joinable()) font_thread_.join();
+  }
+  fonts_.attach_labels();
+}
+
+const IconConfig& Startup::config() {
+  if (!config_done_) {
+    if (!started_) start();
+    SV_TRACE_SCOPE("Startup: wait config");
+    if (config_thread_.joinable()) config_thread_.join();
+    config_done_ = true;
+  }
+  return config_;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <thread>
+
+#include "FontRegistry.h"
+#include "Icons.h"
+
+// Overlaps the slow, GTK-independent startup I/O with Gtk::Application init:
+// fontconfig scanning and icons.json parsing each run on a worker thread as
+// soon as start() is called, and are joined right before the first Desktop
+// is built. Fonts are registered exactly once per process.
+class Startup {
+public:
+  Startup() = default;
+  ~Startup();
+
+  Startup(const Startup&) = delete;
+  Startup& operator=(const Startup&) = delete;
+
+  void start();
+
+  // Join the font worker and attach the fonts to Pango (main thread only).
+  // Idempotent; returns whether registration succeeded.
+  bool finish_fonts();
+
+  // Join the font worker and attach just what labels need
+  // (FontRegistry::attach_labels); finish_fonts() completes it later.
+  void finish_labels();
+
+  // Join the config worker. Idempotent.
+  const IconConfig& config();
+
+private:
+  FontRegistry fonts_;
+  std::thread font_thread_;
+  std::thread config_thread_;
+
+  bool started_ = false;
+  bool fonts_done_ = false;
+  bool fonts_ok_ = false;
+  bool config_done_ = false;
+
+  IconConfig config_;
+};
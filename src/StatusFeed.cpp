@@ -0,0 +1,314 @@
+#include "StatusFeed.h"
+#include "Trace.h"
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "seq must be lock-free to be shared between processes");
+static_assert(sizeof(StatusFeed::Header) == 32, "file layout");
+static_assert(sizeof(StatusFeed::Slot) == 128, "file layout");
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'V', 'S', 'F'};
+
+// Copies the slot's fields as of `seq`; false if a writer got in between.
+bool read_slot(const StatusFeed::Slot& s, uint32_t seq, uint32_t& state, char* key, char* text) {
+  state = s.state;
+  std::memcpy(key, s.key, sizeof(s.key));
+  std::memcpy(text, s.text, sizeof(s.text));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (s.seq.load(std::memory_order_relaxed) != seq) return false;
+  key[sizeof(s.key) - 1] = '\0';
+  text[sizeof(s.text) - 1] = '\0';
+  return true;
+}
+
+// Longest prefix of `s` that fits in n - 1 bytes without splitting a UTF-8 sequence.
+void copy_utf8(char* dst, std::size_t n, const std::string& s) {
+  std::size_t len = std::min(s.size(), n - 1);
+  if (len < s.size()) {
+    while (len > 0 && ((unsigned char)s[len] & 0xC0) == 0x80) --len;
+  }
+  std::memcpy(dst, s.data(), len);
+  std::memset(dst + len, 0, n - len);
+}
+
+} // namespace
+
+StatusFeed& StatusFeed::instance() {
+  static StatusFeed feed;
+  return feed;
+}
+
+std::string StatusFeed::default_path() {
+  const char* env = g_getenv("SV_DASHBOARD_STATUS");
+  if (env && *env) return env;
+  gchar* path = g_build_filename(g_get_user_runtime_dir(), "sv-dashboard-gtk", "status", nullptr);
+  std::string out = path;
+  g_free(path);
+  return out;
+}
+
+void StatusFeed::start() {
+#ifndef _WIN32
+  if (enabled_) return;
+  const char* env = g_getenv("SV_DASHBOARD_STATUS");
+  if (env && std::strcmp(env, "off") == 0) return;
+  path_ = default_path();
+  enabled_ = true;
+  poll();
+  ensure_timer();
+#endif
+}
+
+// 20 Hz only while a file is mapped; without one, just look for it at the
+// reopen rate.
+unsigned StatusFeed::interval_ms() const {
+  return header_ ? kIntervalMs : (unsigned)(kReopenUs / 1000);
+}
+
+void StatusFeed::ensure_timer() {
+  if (!enabled_ || suspended_ || timer_.connected()) return;
+  timer_interval_ = interval_ms();
+  timer_ = Glib::signal_timeout().connect(sigc::mem_fun(*this, &StatusFeed::on_timer), timer_interval_);
+}
+
+bool StatusFeed::on_timer() {
+  poll();
+  if (interval_ms() == timer_interval_) return true;
+  timer_ = sigc::connection();  // this source ends by returning false
+  ensure_timer();
+  return false;
+}
+
+void StatusFeed::suspend() {
+  suspended_ = true;
+  timer_.disconnect();
+}
+
+void StatusFeed::resume() {
+  suspended_ = false;
+  if (enabled_) poll();  // catch up before the first frame
+  ensure_timer();
+}
+
+bool StatusFeed::status(const std::string& tile, Status& out) const {
+  auto it = shown_.find(tile);
+  if (it == shown_.end()) return false;
+  out = it->second;
+  return true;
+}
+
+#ifdef _WIN32
+
+int StatusFeed::poll() { return 0; }
+bool StatusFeed::map() { return false; }
+void StatusFeed::unmap() {}
+bool StatusFeed::replaced() const { return false; }
+
+bool StatusFeed::publish(const std::string&, const std::string&, const std::string&, State) {
+  return false;
+}
+
+#else
+
+bool StatusFeed::map() {
+  const int fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  struct stat st {};
+  void* base = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (std::size_t)st.st_size >= sizeof(Header)) {
+    base = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (base == MAP_FAILED) return false;
+
+  const auto* h = static_cast<const Header*>(base);
+  const std::size_t need = sizeof(Header) + (std::size_t)h->slots * sizeof(Slot);
+  if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion ||
+      h->slot_size != sizeof(Slot) || h->slots > kMaxSlots || need > (std::size_t)st.st_size) {
+    // Possibly still being created; retried on the next check.
+    munmap(base, (std::size_t)st.st_size);
+    return false;
+  }
+
+  header_ = h;
+  slots_ = reinterpret_cast<const Slot*>(h + 1);
+  map_size_ = (std::size_t)st.st_size;
+  slot_count_ = h->slots;
+  dev_ = (uint64_t)st.st_dev;
+  ino_ = (uint64_t)st.st_ino;
+  generation_valid_ = false;
+  seen_.assign(slot_count_, Seen{});
+  g_debug("StatusFeed: mapped %s (%u slots)", path_.c_str(), slot_count_);
+  return true;
+}
+
+void StatusFeed::unmap() {
+  if (!header_) return;
+  munmap(const_cast<Header*>(header_), map_size_);
+  header_ = nullptr;
+  slots_ = nullptr;
+  map_size_ = 0;
+  slot_count_ = 0;
+  seen_.clear();
+
+  // Values from the old file are gone.
+  auto shown = std::move(shown_);
+  shown_.clear();
+  for (const auto& [tile, s] : shown) changed_.emit(tile);
+}
+
+bool StatusFeed::replaced() const {
+  struct stat st {};
+  if (stat(path_.c_str(), &st) != 0) return true;
+  return (uint64_t)st.st_dev != dev_ || (uint64_t)st.st_ino != ino_;
+}
+
+int StatusFeed::poll() {
+  if (!enabled_) return 0;
+
+  const int64_t now = g_get_monotonic_time();
+  if (!header_ || now >= next_check_us_) {
+    next_check_us_ = now + kReopenUs;
+    if (header_ && replaced()) unmap();
+    if (!header_ && !map()) return 0;
+  }
+  if (!header_) return 0;
+
+  const uint32_t gen = header_->generation.load(std::memory_order_acquire);
+  if (generation_valid_ && gen == generation_) return 0;
+
+  SV_TRACE_SCOPE("StatusFeed::poll");
+  int changed = 0;
+  bool torn = false;
+
+  for (uint32_t i = 0; i < slot_count_; ++i) {
+    const Slot& s = slots_[i];
+    Seen& seen = seen_[i];
+    const uint32_t seq = s.seq.load(std::memory_order_acquire);
+    if (seq == seen.seq) continue;
+
+    uint32_t state = Clear;
+    char key[sizeof(Slot::key)];
+    char text[sizeof(Slot::text)];
+    if ((seq & 1) || !read_slot(s, seq, state, key, text)) {
+      torn = true;  // mid-write; read again next poll
+      continue;
+    }
+    seen.seq = seq;
+    if (state > Alarm) state = Clear;
+    if (state == seen.state && std::strcmp(key, seen.key) == 0 && std::strcmp(text, seen.text) == 0) continue;
+
+    if (seen.key[0] && std::strcmp(key, seen.key) != 0) {
+      if (shown_.erase(seen.key)) changed_.emit(seen.key);
+    }
+    seen.state = state;
+    std::memcpy(seen.key, key, sizeof(key));
+    std::memcpy(seen.text, text, sizeof(text));
+    ++changed;
+
+    if (!key[0]) continue;
+    if (state == Clear) {
+      if (!shown_.erase(key)) continue;
+    } else {
+      Status& st = shown_[key];
+      st.text = text;
+      st.alarm = state == Alarm;
+    }
+    changed_.emit(key);
+  }
+
+  // A torn slot keeps the generation stale, so the next poll rescans.
+  generation_ = gen;
+  generation_valid_ = !torn;
+  return changed;
+}
+
+bool StatusFeed::publish(const std::string& path, const std::string& tile,
+                         const std::string& text, State state) {
+  if (tile.empty() || tile.size() >= sizeof(Slot::key)) return false;
+
+  gchar* dir = g_path_get_dirname(path.c_str());
+  g_mkdir_with_parents(dir, 0700);
+  g_free(dir);
+
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+  if (fd < 0) return false;
+  if (flock(fd, LOCK_EX) != 0) {
+    close(fd);
+    return false;
+  }
+
+  struct stat st {};
+  bool fresh = false;
+  if (fstat(fd, &st) == 0 && st.st_size == 0) {
+    const off_t size = (off_t)(sizeof(Header) + kDefaultSlots * sizeof(Slot));
+    fresh = ftruncate(fd, size) == 0;
+    st.st_size = fresh ? size : 0;
+  }
+  void* base = MAP_FAILED;
+  if ((std::size_t)st.st_size >= sizeof(Header)) {
+    base = mmap(nullptr, (std::size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (base == MAP_FAILED) {
+    close(fd);
+    return false;
+  }
+
+  auto* h = static_cast<Header*>(base);
+  if (fresh) {
+    h->version = kVersion;
+    h->slots = kDefaultSlots;
+    h->slot_size = sizeof(Slot);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(h->magic, kMagic, sizeof(kMagic));
+  }
+
+  Slot* slot = nullptr;
+  const bool valid = std::memcmp(h->magic, kMagic, sizeof(kMagic)) == 0 && h->version == kVersion &&
+                     h->slot_size == sizeof(Slot) && h->slots <= kMaxSlots &&
+                     sizeof(Header) + (std::size_t)h->slots * sizeof(Slot) <= (std::size_t)st.st_size;
+  if (valid) {
+    auto* slots = reinterpret_cast<Slot*>(h + 1);
+    Slot* free_slot = nullptr;
+    for (uint32_t i = 0; i < h->slots && !slot; ++i) {
+      if (!slots[i].key[0]) {
+        if (!free_slot) free_slot = &slots[i];
+      } else if (std::strncmp(slots[i].key, tile.c_str(), sizeof(Slot::key)) == 0) {
+        slot = &slots[i];
+      }
+    }
+    if (!slot) slot = free_slot;
+  }
+
+  if (slot) {
+    const uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->state = state;
+    copy_utf8(slot->key, sizeof(slot->key), tile);
+    copy_utf8(slot->text, sizeof(slot->text), text);
+    slot->seq.store(seq + 2, std::memory_order_release);
+    h->generation.fetch_add(1, std::memory_order_release);
+  }
+
+  munmap(base, (std::size_t)st.st_size);
+  close(fd);  // drops the lock
+  return slot != nullptr;
+}
+
+#endif
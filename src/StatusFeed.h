@@ -0,0 +1,122 @@
+#pragma once
+
+#include <glibmm/main.h>
+#include <sigc++/signal.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Live tile values (battery SOC, depth, alarm state, unread count) published
+// by other local processes into a memory-mapped file: a header and a fixed
+// table of slots, each keyed by a tile key (Launcher::tile_key: the tile's
+// "name", else its title) and guarded by a seqlock. The dashboard maps the file read-only and
+// polls it without locks or syscalls: one load of the header generation when
+// nothing changed, otherwise one seq load per slot, copying only the slots
+// whose seq moved. signal_changed() fires only for those tiles, so only
+// their cells are redrawn. Unix only.
+//
+// File: $SV_DASHBOARD_STATUS, else $XDG_RUNTIME_DIR/sv-dashboard-gtk/status.
+// SV_DASHBOARD_STATUS=off disables polling. The file may appear later (it is
+// looked for once a second, the only wakeup without a publisher) or be
+// replaced (rename over it); it must never shrink while mapped.
+class StatusFeed {
+public:
+  // Native byte order. Writers hold flock(LOCK_EX) on the file while they
+  // claim or update a slot; the reader never locks.
+  struct Header {
+    char magic[4];                     // "SVSF", written last at creation
+    uint32_t version;                  // kVersion
+    uint32_t slots;                    // fixed at creation
+    uint32_t slot_size;                // sizeof(Slot)
+    std::atomic<uint32_t> generation;  // bumped after every slot write
+    uint32_t reserved[3];
+  };
+
+  enum State : uint32_t { Clear = 0, Normal = 1, Alarm = 2 };
+
+  // Write: seq+1 (odd), release fence, fields, seq+2 (release), generation+1.
+  struct Slot {
+    std::atomic<uint32_t> seq;
+    uint32_t state;   // State
+    char key[56];     // NUL-terminated; empty = free slot
+    char text[64];    // badge text, UTF-8, NUL-terminated
+  };
+
+  static constexpr uint32_t kVersion = 1;
+  static constexpr uint32_t kDefaultSlots = 64;
+  static constexpr uint32_t kMaxSlots = 1024;
+
+  struct Status {
+    std::string text;
+    bool alarm = false;
+  };
+
+  static StatusFeed& instance();
+  static std::string default_path();
+
+  // Starts polling default_path(); a missing file is retried.
+  void start();
+  // Stops polling (idle mode); shown values stay.
+  void suspend();
+  void resume();
+
+  // Current value; false if the tile has none.
+  bool status(const std::string& tile, Status& out) const;
+
+  // A tile's status changed or went away.
+  sigc::signal<void(const std::string&)>& signal_changed() { return changed_; }
+
+  // One poll; returns slots whose value changed. Public for the benchmark.
+  int poll();
+
+  // Publisher side: creates the file if needed and sets `tile`'s slot.
+  // Clear keeps the slot but removes the badge. False if the tile key is too
+  // long, the table is full or the file is unusable.
+  static bool publish(const std::string& path, const std::string& tile,
+                      const std::string& text, State state);
+
+private:
+  StatusFeed() = default;
+
+  bool map();
+  void unmap();
+  bool replaced() const;
+  void ensure_timer();
+  bool on_timer();
+  unsigned interval_ms() const;
+
+  // Last copy of each slot, compared in place so an unchanged slot costs no
+  // allocation.
+  struct Seen {
+    uint32_t seq = 0;
+    uint32_t state = Clear;
+    char key[sizeof(Slot::key)] = {};
+    char text[sizeof(Slot::text)] = {};
+  };
+
+  static constexpr unsigned kIntervalMs = 50;
+  static constexpr int64_t kReopenUs = 1000000;  // stat() for a new or replaced file
+
+  std::string path_;
+  bool enabled_ = false;
+  bool suspended_ = false;
+  sigc::connection timer_;
+  unsigned timer_interval_ = 0;
+
+  const Header* header_ = nullptr;
+  const Slot* slots_ = nullptr;
+  std::size_t map_size_ = 0;
+  uint32_t slot_count_ = 0;
+  uint64_t dev_ = 0;
+  uint64_t ino_ = 0;
+  uint32_t generation_ = 0;
+  bool generation_valid_ = false;
+  int64_t next_check_us_ = 0;
+
+  std::vector<Seen> seen_;
+  std::map<std::string, Status> shown_;
+  sigc::signal<void(const std::string&)> changed_;
+};
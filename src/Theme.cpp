@@ -0,0 +1,115 @@
+#include "Theme.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+std::vector<SchemeSpec> builtin_schemes() {
+  return {
+    { "day",   "#f2f2f2", "#ffffff", "palette" },
+    { "dusk",  "#c8c8c8", "#e6e6e6", "transparent" },
+    { "night", "#d00000", "#d00000", "transparent" },
+  };
+}
+
+void inherit(std::string& field, const std::string& from) {
+  if (field.empty()) field = from;
+}
+
+} // namespace
+
+namespace Theme {
+
+std::vector<SchemeSpec> merge_schemes(const std::vector<SchemeSpec>& user) {
+  auto out = builtin_schemes();
+  const SchemeSpec fallback = out.front();
+
+  for (const auto& u : user) {
+    auto it = std::find_if(out.begin(), out.end(),
+                           [&](const SchemeSpec& s) { return s.name == u.name; });
+    const SchemeSpec base = (it != out.end()) ? *it : fallback;
+
+    SchemeSpec merged = u;
+    inherit(merged.labelColor, base.labelColor);
+    inherit(merged.iconColor, base.iconColor);
+    inherit(merged.iconBackground, base.iconBackground);
+
+    if (it != out.end()) *it = std::move(merged);
+    else out.push_back(std::move(merged));
+  }
+  return out;
+}
+
+bool uses_palette(const SchemeSpec& s) {
+  return s.iconBackground == "palette";
+}
+
+std::string scheme_class(const SchemeSpec& s) {
+  return "theme-" + s.name;
+}
+
+std::string metrics_class(int bucket) {
+  return "ui-b" + std::to_string(bucket);
+}
+
+std::string base_css() {
+  std::string css;
+  css += "window, GtkWindow { background: #000000; }\n";
+  css += ".tile { background: transparent; border: none; box-shadow: none; padding: 0; }\n";
+
+  css += ".scheme-btn { background: transparent; border: none; box-shadow: none; }\n";
+  css += ".scheme-btn:focus { outline: none; }\n";
+
+  css += ".scheme-day   { color: #d4b000; }\n";
+  css += ".scheme-dusk  { color: #b0b0b0; }\n";
+  css += ".scheme-night { color: #d00000; }\n";
+  css += ".scheme-btn { opacity: 0.65; }\n";
+  css += ".scheme-btn.active { opacity: 1.0; border-bottom: 2px solid currentColor; }\n";
+
+  css += ".perf-hud { background: rgba(0,0,0,0.75); color: #7cfc00; padding: 6px 10px; }\n";
+  return css;
+}
+
+std::string scheme_css(const std::vector<SchemeSpec>& schemes) {
+  std::string css;
+  for (const auto& s : schemes) {
+    const std::string sel = "." + scheme_class(s);
+    const std::string bg = uses_palette(s) ? "#2b2b2b" : s.iconBackground;
+
+    css += sel + " .tile-label, " + sel + " .nav { color:" + s.labelColor + "; }\n";
+    // Icon color + background are on tile-icon-box
+    css += sel + " .tile-icon-box { color:" + s.iconColor + "; background:" + bg + "; }\n";
+  }
+  return css;
+}
+
+std::string palette_css(const std::vector<std::pair<std::string, std::string>>& palette) {
+  std::string css;
+  for (const auto& entry : palette) {
+    css += std::string(".") + kPaletteClass + " .tile-icon-box." + entry.first
+        + " { background:" + entry.second + "; }\n";
+  }
+  return css;
+}
+
+std::string metrics_css(int bucket, double scale) {
+  auto itos = [](int v) { return std::to_string(v); };
+
+  const int scheme_pad_v = std::max(1, (int)std::lround(6  * scale));
+  const int scheme_pad_h = std::max(2, (int)std::lround(14 * scale));
+  const int scheme_mr    = std::max(0, (int)std::lround(6  * scale));
+
+  const int icon_radius  = std::max(3, (int)std::lround(16 * scale));
+
+  const std::string sel = "." + metrics_class(bucket);
+
+  std::string css;
+  css += sel + " .scheme-btn { ";
+  css += "padding: " + itos(scheme_pad_v) + "px " + itos(scheme_pad_h) + "px; ";
+  css += "margin-right: " + itos(scheme_mr) + "px; }\n";
+  css += sel + " .tile-icon-box { border-radius:" + itos(icon_radius) + "px; }\n";
+  return css;
+}
+
+} // namespace Theme
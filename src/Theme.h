@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Icons.h"
+
+// Stylesheet generation. The sheets are split so that each one is parsed once:
+//   base     - static rules, never change
+//   schemes  - every scheme, scoped by a "theme-<name>" class on the window
+//   palette  - per-tile bg-* colors, active under the "theme-palette" class
+//   metrics  - scale-dependent sizes, one sheet per scale bucket, scoped by "ui-b<N>"
+// Switching scheme or scale then only toggles classes on the toplevel.
+namespace Theme {
+
+inline constexpr const char* kPaletteClass = "theme-palette";
+
+// Day, Dusk, Night (in that order) with user overrides applied, then user additions.
+std::vector<SchemeSpec> merge_schemes(const std::vector<SchemeSpec>& user);
+
+bool uses_palette(const SchemeSpec& s);
+std::string scheme_class(const SchemeSpec& s);
+std::string metrics_class(int bucket);
+
+std::string base_css();
+std::string scheme_css(const std::vector<SchemeSpec>& schemes);
+std::string palette_css(const std::vector<std::pair<std::string, std::string>>& palette);
+std::string metrics_css(int bucket, double scale);
+
+} // namespace Theme
@@ -0,0 +1,54 @@
+#include "TileCache.h"
+
+#include <functional>
+
+namespace {
+
+inline void hash_combine(std::size_t& seed, std::size_t v) {
+  seed ^= v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+std::size_t TileKeyHash::operator()(const TileKey& k) const noexcept {
+  std::size_t h = std::hash<char32_t>{}(k.codepoint);
+  hash_combine(h, std::hash<int>{}((int)k.style));
+  hash_combine(h, std::hash<int>{}(k.glyph_px));
+  hash_combine(h, std::hash<int>{}(k.box_px));
+  hash_combine(h, std::hash<int>{}((k.width << 16) ^ k.height));
+  hash_combine(h, std::hash<int>{}(k.device_scale));
+  hash_combine(h, std::hash<uint32_t>{}(k.fg_rgba));
+  hash_combine(h, std::hash<uint32_t>{}(k.bg_id));
+  hash_combine(h, std::hash<uint32_t>{}(k.style_id));
+  hash_combine(h, std::hash<int>{}(k.radius));
+  hash_combine(h, std::hash<unsigned>{}(k.state));
+  return h;
+}
+
+TileCache& TileCache::instance() {
+  static TileCache cache;
+  return cache;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> TileCache::lookup(const TileKey& key) const {
+  auto it = tiles_.find(key);
+  if (it == tiles_.end()) return {};
+  return it->second;
+}
+
+void TileCache::insert(const TileKey& key, const Cairo::RefPtr<Cairo::ImageSurface>& surface) {
+  if (tiles_.size() >= kMaxEntries) tiles_.clear();
+  tiles_[key] = surface;
+}
+
+void TileCache::clear() {
+  tiles_.clear();
+}
+
+uint32_t TileCache::class_id(const std::string& cls) {
+  auto it = class_ids_.find(cls);
+  if (it != class_ids_.end()) return it->second;
+  const uint32_t id = (uint32_t)class_ids_.size() + 1;  // 0: never assigned
+  class_ids_.emplace(cls, id);
+  return id;
+}
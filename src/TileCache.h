@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cairomm/surface.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "Icons.h"
+
+// Everything that influences the pixels of a rendered icon tile. Plain
+// data, so building and hashing one per draw never touches the heap.
+struct TileKey {
+  char32_t codepoint{};
+  FaStyle style{FaStyle::Solid};  // picks the glyph font
+  int glyph_px{};
+  int box_px{};
+  int width{};
+  int height{};
+  int device_scale{1};
+  uint32_t fg_rgba{};
+  uint32_t bg_id{};  // TileCache::class_id of the bg-* class
+  uint32_t style_id{};  // TileRender::style_id: scheme/palette/bucket of the window
+  int radius{};
+  unsigned state{};
+
+  bool operator==(const TileKey&) const = default;
+};
+
+struct TileKeyHash {
+  std::size_t operator()(const TileKey& k) const noexcept;
+};
+
+// Process-wide cache of finished tile surfaces (CSS background + shaped glyph).
+// The same glyph/color combination shows up on many tiles and every frame of
+// a page transition, so IconCanvas::on_draw only has to blit.
+// Must be cleared whenever the UI scale or the color scheme changes.
+class TileCache {
+public:
+  static TileCache& instance();
+
+  Cairo::RefPtr<Cairo::ImageSurface> lookup(const TileKey& key) const;
+  void insert(const TileKey& key, const Cairo::RefPtr<Cairo::ImageSurface>& surface);
+  void clear();
+
+  // Small stable id for a color class name, for TileKey::bg_id. Assigned on
+  // first sight and kept across clear(); look it up when the class is set,
+  // not per draw.
+  uint32_t class_id(const std::string& cls);
+
+  std::size_t size() const { return tiles_.size(); }
+
+private:
+  TileCache() = default;
+
+  // Upper bound so a pathological config can't grow the cache forever.
+  static constexpr std::size_t kMaxEntries = 256;
+
+  std::unordered_map<TileKey, Cairo::RefPtr<Cairo::ImageSurface>, TileKeyHash> tiles_;
+  std::unordered_map<std::string, uint32_t> class_ids_;
+};
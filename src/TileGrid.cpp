@@ -0,0 +1,345 @@
+#include "TileGrid.h"
+#include "AllocStats.h"
+#include "PerfStats.h"
+#include "TileCache.h"
+#include "TileRender.h"
+#include "Trace.h"
+#include "UiMetrics.h"
+
+#include <glib.h>
+#include <gtk/gtk.h>
+
+#include <algorithm>
+#include <cmath>
+
+TileGrid::TileGrid(int cols)
+: cols_(std::max(1, cols))
+{
+  set_hexpand(true);
+  set_vexpand(true);
+  add_events(Gdk::BUTTON_PRESS_MASK | Gdk::BUTTON_RELEASE_MASK | Gdk::TOUCH_MASK);
+
+  press_ = Gtk::GestureMultiPress::create(*this);
+  press_->set_button(GDK_BUTTON_PRIMARY);
+
+  press_->signal_pressed().connect([this](int, double x, double y) {
+    pressed_ = hit(x, y);
+    press_us_ = g_get_monotonic_time();
+    damage(pressed_);
+  });
+  press_->signal_released().connect([this](int, double x, double y) {
+    const int i = pressed_;
+    pressed_ = -1;
+    damage(i);
+    // Like Gtk::Button: only a release over the pressed tile activates it.
+    if (i >= 0 && hit(x, y) == i) activated_.emit(i, press_us_);
+  });
+  // A swipe claimed the sequence.
+  press_->signal_cancel().connect([this](GdkEventSequence*) {
+    const int i = pressed_;
+    pressed_ = -1;
+    damage(i);
+  });
+
+  set_ui_metrics(UiScale::metrics_for(1.0), true);
+}
+
+void TileGrid::set_tile(int i, const IconSpec& spec) {
+  if (i < 0 || i > count()) return;
+  const bool added = i == count();
+  if (added) tiles_.emplace_back();
+
+  Tile& t = tiles_[i];
+  t.codepoint = spec.codepoint;
+  t.style = spec.style;
+  if (added || spec.colorClass != t.color_class) {
+    t.color_class = spec.colorClass;
+    t.bg_id = TileCache::instance().class_id(t.color_class);
+    t.fg_valid = false;
+  }
+
+  const bool relabel = added || t.label != spec.label;
+  if (relabel) {
+    t.label = spec.label;
+    shape_label(t);
+  }
+
+  if (added || relabel) measure();
+  damage(i);
+}
+
+void TileGrid::truncate(int n) {
+  if (n >= count()) return;
+  if (pressed_ >= n) pressed_ = -1;
+  tiles_.resize(std::max(0, n));
+  measure();
+  queue_draw();
+}
+
+void TileGrid::set_badge(int i, const std::string& text, bool over) {
+  if (i < 0 || i >= count()) return;
+  Tile& t = tiles_[i];
+  if (t.badge == text && t.badge_over == over) return;
+  t.badge_pill.reset();
+  t.badge = text;
+  t.badge_over = over;
+  damage(i);
+}
+
+void TileGrid::set_ui_metrics(const UiMetrics& m, bool show_labels) {
+  if (&m == metrics_ && show_labels == show_labels_) return;
+
+  metrics_ = &m;
+  show_labels_ = show_labels;
+  box_px_ = std::max(12, m.icon_box_px);
+  glyph_px_ = TileRender::glyph_px(box_px_);
+
+  for (auto& t : tiles_) {
+    shape_label(t);
+    t.badge_pill.reset();
+  }
+  measure();
+  queue_draw();
+}
+
+void TileGrid::shape_label(Tile& t) {
+  t.label_mask.reset();
+  if (!show_labels_ || !metrics_) {
+    t.label_layout.reset();
+    t.label_w = 0;
+    return;
+  }
+  if (!t.label_layout) t.label_layout = create_pango_layout(t.label);
+  else t.label_layout->set_text(t.label);
+  t.label_layout->set_font_description(metrics_->label_font);
+
+  int h = 0;
+  t.label_layout->get_pixel_size(t.label_w, h);
+}
+
+void TileGrid::measure() {
+  // Same geometry as the Gtk::Grid of DesktopIcons: homogeneous cells sized
+  // to the widest label, icon box above the label.
+  int label_w = 0;
+  label_h_ = 0;
+  if (show_labels_ && metrics_) {
+    auto probe = create_pango_layout("");
+    probe->set_font_description(metrics_->label_font);
+    int w = 0;
+    probe->get_pixel_size(w, label_h_);
+    for (const auto& t : tiles_) label_w = std::max(label_w, t.label_w);
+  }
+
+  const int spacing = metrics_ ? metrics_->tile_spacing : 0;
+  cell_w_ = std::max(box_px_, label_w);
+  cell_h_ = box_px_ + (show_labels_ ? spacing + label_h_ : 0);
+
+  const int n = count();
+  const int ncols = std::min(cols_, n);
+  const int nrows = (n + cols_ - 1) / cols_;
+  const int col_sp = metrics_ ? metrics_->col_spacing : 0;
+  const int row_sp = metrics_ ? metrics_->row_spacing : 0;
+  const int gw = ncols ? ncols * cell_w_ + (ncols - 1) * col_sp : 0;
+  const int gh = nrows ? nrows * cell_h_ + (nrows - 1) * row_sp : 0;
+
+  if (gw != grid_w_ || gh != grid_h_) {
+    grid_w_ = gw;
+    grid_h_ = gh;
+    queue_resize();
+  }
+  place();
+}
+
+void TileGrid::place() {
+  origin_x_ = std::max(0, (get_allocated_width() - grid_w_) / 2);
+  origin_y_ = std::max(0, (get_allocated_height() - grid_h_) / 2);
+}
+
+void TileGrid::on_size_allocate(Gtk::Allocation& alloc) {
+  Gtk::DrawingArea::on_size_allocate(alloc);
+  place();
+}
+
+void TileGrid::on_style_updated() {
+  Gtk::DrawingArea::on_style_updated();
+
+  // Scheme, palette and metrics are classes on the toplevel; re-resolve once
+  // here instead of per draw.
+  auto sc = get_style_context();
+  sc->context_save();
+  sc->add_class("tile-icon-box");
+  gtk_style_context_get(sc->gobj(), GTK_STATE_FLAG_NORMAL,
+                        GTK_STYLE_PROPERTY_BORDER_RADIUS, &radius_, nullptr);
+  sc->context_restore();
+
+  sc->context_save();
+  sc->add_class("tile-label");
+  label_fg_ = sc->get_color(Gtk::STATE_FLAG_NORMAL);
+  sc->context_restore();
+
+  style_id_ = TileRender::style_id(*this);
+  for (auto& t : tiles_) {
+    t.fg_valid = false;
+    t.label_mask.reset();  // font options / resolution may have changed
+  }
+  queue_draw();
+}
+
+void TileGrid::resolve_fg(Tile& t) {
+  auto sc = get_style_context();
+  sc->context_save();
+  sc->add_class("tile-icon-box");
+  if (!t.color_class.empty()) sc->add_class(t.color_class);
+  t.fg = sc->get_color(Gtk::STATE_FLAG_NORMAL);
+  sc->context_restore();
+  t.fg_valid = true;
+}
+
+void TileGrid::get_preferred_width_vfunc(int& min_w, int& nat_w) const {
+  min_w = grid_w_;
+  nat_w = grid_w_;
+}
+
+void TileGrid::get_preferred_height_vfunc(int& min_h, int& nat_h) const {
+  min_h = grid_h_;
+  nat_h = grid_h_;
+}
+
+Gdk::Rectangle TileGrid::cell_rect(int i) const {
+  const int col_sp = metrics_ ? metrics_->col_spacing : 0;
+  const int row_sp = metrics_ ? metrics_->row_spacing : 0;
+  return Gdk::Rectangle(origin_x_ + (i % cols_) * (cell_w_ + col_sp),
+                        origin_y_ + (i / cols_) * (cell_h_ + row_sp),
+                        cell_w_, cell_h_);
+}
+
+int TileGrid::hit(double x, double y) const {
+  const int col_sp = metrics_ ? metrics_->col_spacing : 0;
+  const int row_sp = metrics_ ? metrics_->row_spacing : 0;
+  const double rx = x - origin_x_;
+  const double ry = y - origin_y_;
+  if (rx < 0 || ry < 0 || cell_w_ <= 0 || cell_h_ <= 0) return -1;
+
+  const int col = (int)rx / (cell_w_ + col_sp);
+  const int row = (int)ry / (cell_h_ + row_sp);
+  if (col >= cols_) return -1;
+  // Spacing between cells belongs to no tile.
+  if ((int)rx - col * (cell_w_ + col_sp) >= cell_w_) return -1;
+  if ((int)ry - row * (cell_h_ + row_sp) >= cell_h_) return -1;
+
+  const int i = row * cols_ + col;
+  return i < count() ? i : -1;
+}
+
+void TileGrid::damage(int i) {
+  if (i < 0 || i >= count()) return;
+  const auto r = cell_rect(i);
+  queue_draw_area(r.get_x(), r.get_y(), r.get_width(), r.get_height());
+}
+
+void TileGrid::draw_tile(const Cairo::RefPtr<Cairo::Context>& cr, int i) {
+  Tile& t = tiles_[i];
+  if (!t.fg_valid) resolve_fg(t);
+
+  const auto cell = cell_rect(i);
+  const int spacing = metrics_ ? metrics_->tile_spacing : 0;
+  const int content_h = box_px_ + (t.label_layout ? spacing + label_h_ : 0);
+  const int ix = cell.get_x() + (cell_w_ - box_px_) / 2;
+  const int iy = cell.get_y() + (cell_h_ - content_h) / 2;
+
+  TileKey key;
+  key.codepoint = t.codepoint;
+  key.style = t.style;
+  key.glyph_px = glyph_px_;
+  key.box_px = box_px_;
+  key.width = box_px_;
+  key.height = box_px_;
+  key.device_scale = get_scale_factor();
+  key.fg_rgba = TileRender::pack_rgba(t.fg);
+  key.bg_id = t.bg_id;
+  key.style_id = style_id_;
+  key.radius = radius_;
+  key.state = (unsigned)Gtk::STATE_FLAG_NORMAL;
+
+  auto& cache = TileCache::instance();
+  auto surface = cache.lookup(key);
+  if (!surface) {
+    auto sc = get_style_context();
+    sc->context_save();
+    sc->add_class("tile-icon-box");
+    if (!t.color_class.empty()) sc->add_class(t.color_class);
+    surface = TileRender::render_icon(*this, sc, box_px_, box_px_, key.device_scale, t.fg,
+                                      t.codepoint, t.style, glyph_px_);
+    sc->context_restore();
+    cache.insert(key, surface);
+  }
+
+  cr->set_source(surface, ix, iy);
+  cr->rectangle(ix, iy, box_px_, box_px_);
+  cr->fill();
+
+  if (i == pressed_) {
+    // Press feedback: the icon box tinted with its own glyph color.
+    const double r = std::min<double>(radius_, box_px_ * 0.5);
+    cr->begin_new_sub_path();
+    cr->arc(ix + box_px_ - r, iy + r, r, -M_PI * 0.5, 0);
+    cr->arc(ix + box_px_ - r, iy + box_px_ - r, r, 0, M_PI * 0.5);
+    cr->arc(ix + r, iy + box_px_ - r, r, M_PI * 0.5, M_PI);
+    cr->arc(ix + r, iy + r, r, M_PI, M_PI * 1.5);
+    cr->close_path();
+    cr->set_source_rgba(t.fg.get_red(), t.fg.get_green(), t.fg.get_blue(), 0.25);
+    cr->fill();
+  }
+
+  if (!t.badge.empty()) {
+    if (!t.badge_pill) {
+      t.badge_pill = TileRender::render_badge(*this, t.badge, t.badge_over, box_px_, box_px_, mask_scale_);
+    }
+    TileRender::draw_badge(cr, t.badge_pill, ix, iy, box_px_, box_px_);
+  }
+
+  if (t.label_layout) {
+    cr->set_source_rgba(label_fg_.get_red(), label_fg_.get_green(),
+                        label_fg_.get_blue(), label_fg_.get_alpha());
+    if (!t.label_mask) t.label_mask = TileRender::text_mask(t.label_layout, mask_scale_, t.label_ox, t.label_oy);
+    cr->mask(t.label_mask, cell.get_x() + (cell_w_ - t.label_w) / 2 + t.label_ox,
+             iy + box_px_ + spacing + t.label_oy);
+  }
+}
+
+bool TileGrid::on_draw(const Cairo::RefPtr<Cairo::Context>& cr) {
+  static bool first_draw = true;
+  SV_TRACE_SCOPE_IF(first_draw, "TileGrid::on_draw (first)");
+  first_draw = false;
+  SV_ALLOC_SCOPE(Draw);
+
+  auto& perf = perf_stats();
+  const int64_t t0 = perf.sampling ? g_get_monotonic_time() : 0;
+
+  if (get_scale_factor() != mask_scale_) {
+    mask_scale_ = get_scale_factor();
+    for (auto& t : tiles_) {
+      t.label_mask.reset();
+      t.badge_pill.reset();
+    }
+  }
+
+  // Only cells inside the damaged area are drawn.
+  double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+  cr->get_clip_extents(x1, y1, x2, y2);
+
+  int drawn = 0;
+  for (int i = 0; i < count(); ++i) {
+    const auto r = cell_rect(i);
+    if (r.get_x() >= x2 || r.get_y() >= y2 ||
+        r.get_x() + r.get_width() <= x1 || r.get_y() + r.get_height() <= y1) continue;
+    draw_tile(cr, i);
+    ++drawn;
+  }
+
+  if (t0) {
+    perf.draws += drawn;
+    perf.draw_us += g_get_monotonic_time() - t0;
+  }
+  return true;
+}
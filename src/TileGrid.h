@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cairomm/surface.h>
+#include <gtkmm/drawingarea.h>
+#include <gtkmm/gesturemultipress.h>
+#include <pangomm/layout.h>
+#include <sigc++/signal.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Icons.h"
+
+struct UiMetrics;
+
+// A whole page of tiles in one widget: one GdkWindow, one style context and
+// one size request instead of a Button, Box, DrawingArea and Label per tile.
+// Tiles are a flat array; layout, hit-testing, press feedback and per-cell
+// damage are done here. Colors still come from the .tile-icon-box / bg-* /
+// .tile-label CSS, resolved through a saved style context only when the
+// style changes, and icon boxes share TileCache with DesktopIcon.
+class TileGrid : public Gtk::DrawingArea {
+public:
+  explicit TileGrid(int cols);
+
+  // In-place update; i == count() appends.
+  void set_tile(int i, const IconSpec& spec);
+  void truncate(int n);
+  int count() const { return (int)tiles_.size(); }
+
+  void set_badge(int i, const std::string& text, bool over);
+  // No-op when neither the bucket nor label visibility changed.
+  void set_ui_metrics(const UiMetrics& m, bool show_labels);
+
+  // A tile was tapped; press_us is the monotonic time of the press.
+  sigc::signal<void(int, int64_t)>& signal_activated() { return activated_; }
+
+protected:
+  bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override;
+  void on_size_allocate(Gtk::Allocation& alloc) override;
+  void on_style_updated() override;
+  void get_preferred_width_vfunc(int& min_w, int& nat_w) const override;
+  void get_preferred_height_vfunc(int& min_h, int& nat_h) const override;
+
+private:
+  struct Tile {
+    char32_t codepoint{};
+    FaStyle style{FaStyle::Solid};
+    std::string color_class;
+    uint32_t bg_id = 0;       // TileCache::class_id(color_class)
+    Glib::ustring label;
+    Glib::RefPtr<Pango::Layout> label_layout;  // null while labels are hidden
+    int label_w = 0;
+    // label_layout rendered on first draw; drawing only masks it.
+    Cairo::RefPtr<Cairo::ImageSurface> label_mask;
+    int label_ox = 0;
+    int label_oy = 0;
+    std::string badge;
+    Cairo::RefPtr<Cairo::ImageSurface> badge_pill;  // rendered on first draw
+    bool badge_over = false;
+    Gdk::RGBA fg;             // .tile-icon-box color (per bg-* class)
+    bool fg_valid = false;
+  };
+
+  void shape_label(Tile& t);
+  void resolve_fg(Tile& t);
+  // Cell size and grid origin; queue a resize only if the request changed.
+  void measure();
+  void place();
+
+  Gdk::Rectangle cell_rect(int i) const;
+  int hit(double x, double y) const;
+  void damage(int i);
+  void draw_tile(const Cairo::RefPtr<Cairo::Context>& cr, int i);
+
+  std::vector<Tile> tiles_;
+  int cols_;
+  const UiMetrics* metrics_ = nullptr;
+  bool show_labels_ = true;
+
+  int box_px_ = 112;
+  int glyph_px_ = 56;
+  int cell_w_ = 0;
+  int cell_h_ = 0;
+  int label_h_ = 0;
+  int grid_w_ = 0;
+  int grid_h_ = 0;
+  int origin_x_ = 0;
+  int origin_y_ = 0;
+
+  int mask_scale_ = 0;  // device scale of the cached label masks / pills
+
+  // Shared by every tile; refreshed on style-updated.
+  int radius_ = 0;
+  uint32_t style_id_ = 0;
+  Gdk::RGBA label_fg_;
+
+  Glib::RefPtr<Gtk::GestureMultiPress> press_;
+  int pressed_ = -1;
+  int64_t press_us_ = 0;
+  sigc::signal<void(int, int64_t)> activated_;
+};
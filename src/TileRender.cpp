@@ -0,0 +1,167 @@
+#include "TileRender.h"
+#include "FontRegistry.h"
+#include "GlyphAtlas.h"
+#include "TileCache.h"
+
+#include <glib.h>
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace TileRender {
+
+int glyph_px(int box_px) {
+  return std::max(6, (int)std::lround(box_px * kIconFraction));
+}
+
+Glib::ustring to_utf8(char32_t cp) {
+  gunichar gcp = static_cast<gunichar>(cp);
+  gchar buf[8] = {0};
+  const int len = g_unichar_to_utf8(gcp, buf);
+  buf[len] = '\0';
+  return Glib::ustring(buf);
+}
+
+Pango::FontDescription glyph_font(FaStyle style) {
+  Pango::FontDescription fa;
+  switch (style) {
+    case FaStyle::Brands:
+      fa.set_family(FontRegistry::kFamilyBrands);
+      fa.set_weight(Pango::WEIGHT_NORMAL);
+      break;
+    case FaStyle::Regular:
+      fa.set_family(FontRegistry::kFamilyFree);
+      fa.set_weight(Pango::WEIGHT_NORMAL);
+      break;
+    case FaStyle::Solid:
+      fa.set_family(FontRegistry::kFamilyFree);
+      fa.set_weight(Pango::WEIGHT_HEAVY);
+      break;
+  }
+  return fa;
+}
+
+uint32_t pack_rgba(const Gdk::RGBA& c) {
+  auto ch = [](double v) { return (uint32_t)std::lround(std::clamp(v, 0.0, 1.0) * 255.0); };
+  return (ch(c.get_red()) << 24) | (ch(c.get_green()) << 16) | (ch(c.get_blue()) << 8) | ch(c.get_alpha());
+}
+
+uint32_t style_id(Gtk::Widget& widget) {
+  Gtk::Widget* top = widget.get_toplevel();
+  if (!top) return 0;
+  auto classes = top->get_style_context()->list_classes();
+  std::sort(classes.begin(), classes.end());
+  std::string key;
+  for (const auto& c : classes) {
+    key += c.raw();
+    key += ' ';
+  }
+  return TileCache::instance().class_id(key);
+}
+
+double em_px(Gtk::Widget& widget, int px) {
+  double dpi = pango_cairo_context_get_resolution(widget.get_pango_context()->gobj());
+  if (dpi <= 0.0) dpi = 96.0;  // Pango's default
+  return px * dpi / 72.0;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> render_icon(Gtk::Widget& widget,
+                                               const Glib::RefPtr<Gtk::StyleContext>& sc,
+                                               int w, int h, int dev, const Gdk::RGBA& fg,
+                                               char32_t codepoint, FaStyle style, int glyph_px) {
+  auto surface = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, w * dev, h * dev);
+  cairo_surface_set_device_scale(surface->cobj(), dev, dev);
+  auto cr = Cairo::Context::create(surface);
+
+  // Background + rounded corners from CSS (.tile-icon-box + bg-*)
+  sc->render_background(cr, 0, 0, w, h);
+
+  if (!codepoint) return surface;
+
+  cr->set_source_rgba(fg.get_red(), fg.get_green(), fg.get_blue(), fg.get_alpha());
+
+  if (GlyphAtlas::instance().draw_centered(cr, codepoint, style, em_px(widget, glyph_px), 0, 0, w, h)) {
+    return surface;
+  }
+
+  auto layout = widget.create_pango_layout(to_utf8(codepoint));
+  Pango::FontDescription fd = glyph_font(style);
+  fd.set_size(glyph_px * Pango::SCALE);
+  layout->set_font_description(fd);
+
+  int lw = 0, lh = 0;
+  layout->get_pixel_size(lw, lh);
+
+  cr->move_to((w - lw) * 0.5, (h - lh) * 0.5);
+  pango_cairo_show_layout(cr->cobj(), layout->gobj());
+  return surface;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> render_badge(Gtk::Widget& widget, const std::string& text, bool over,
+                                                int w, int box_px, int dev) {
+  auto layout = widget.create_pango_layout(text);
+  Pango::FontDescription fd;
+  fd.set_family(FontRegistry::labelFamily());
+  fd.set_weight(Pango::WEIGHT_BOLD);
+  fd.set_absolute_size(std::max(7, box_px / 9) * Pango::SCALE);
+  layout->set_font_description(fd);
+
+  int lw = 0, lh = 0;
+  layout->get_pixel_size(lw, lh);
+  const int pad = std::max(2, box_px / 40);
+  const int bw = std::max(1, std::min(w, lw + 2 * pad));
+  const int bh = lh + pad;
+  const double r = bh * 0.5;
+
+  auto surface = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, bw * dev, bh * dev);
+  cairo_surface_set_device_scale(surface->cobj(), dev, dev);
+  auto cr = Cairo::Context::create(surface);
+
+  cr->begin_new_sub_path();
+  cr->arc(r, r, r, M_PI * 0.5, M_PI * 1.5);
+  cr->arc(bw - r, r, r, M_PI * 1.5, M_PI * 2.5);
+  cr->close_path();
+  if (over) cr->set_source_rgba(0.82, 0.0, 0.0, 0.92);
+  else cr->set_source_rgba(0.0, 0.0, 0.0, 0.65);
+  cr->fill();
+
+  cr->set_source_rgba(1.0, 1.0, 1.0, 1.0);
+  cr->move_to((bw - lw) * 0.5, (bh - lh) * 0.5);
+  pango_cairo_show_layout(cr->cobj(), layout->gobj());
+  return surface;
+}
+
+void draw_badge(const Cairo::RefPtr<Cairo::Context>& cr, const Cairo::RefPtr<Cairo::ImageSurface>& badge,
+                double x, double y, int w, int h) {
+  double sx = 1.0, sy = 1.0;
+  cairo_surface_get_device_scale(badge->cobj(), &sx, &sy);
+  const double bw = badge->get_width() / sx, bh = badge->get_height() / sy;
+  cr->set_source(badge, x + w - bw, y + h - bh);
+  cr->rectangle(x + w - bw, y + h - bh, bw, bh);
+  cr->fill();
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> text_mask(const Glib::RefPtr<Pango::Layout>& layout, int dev,
+                                             int& ox, int& oy) {
+  // Ink can stick out of the logical box (descenders, italics).
+  Pango::Rectangle ink, logical;
+  layout->get_pixel_extents(ink, logical);
+  const int x0 = std::min(ink.get_x(), logical.get_x());
+  const int y0 = std::min(ink.get_y(), logical.get_y());
+  const int x1 = std::max(ink.get_x() + ink.get_width(), logical.get_x() + logical.get_width());
+  const int y1 = std::max(ink.get_y() + ink.get_height(), logical.get_y() + logical.get_height());
+
+  auto surface = Cairo::ImageSurface::create(Cairo::FORMAT_A8, std::max(1, x1 - x0) * dev,
+                                             std::max(1, y1 - y0) * dev);
+  cairo_surface_set_device_scale(surface->cobj(), dev, dev);
+  auto cr = Cairo::Context::create(surface);
+  cr->move_to(-x0, -y0);
+  pango_cairo_show_layout(cr->cobj(), layout->gobj());
+
+  ox = x0;
+  oy = y0;
+  return surface;
+}
+
+} // namespace TileRender
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cairomm/context.h>
+#include <cairomm/surface.h>
+#include <gdkmm/rgba.h>
+#include <glibmm/ustring.h>
+#include <gtkmm/stylecontext.h>
+#include <gtkmm/widget.h>
+#include <pangomm/fontdescription.h>
+#include <pangomm/layout.h>
+
+#include <cstdint>
+#include <string>
+
+#include "Icons.h"
+
+// Tile drawing shared by the per-tile widgets (DesktopIcon) and the
+// single-widget page (TileGrid), so both look identical.
+namespace TileRender {
+
+// Smaller glyph inside square => visible padding.
+// 0.50 is a good starting point; lower => more padding.
+inline constexpr double kIconFraction = 0.42;
+
+int glyph_px(int box_px);
+Glib::ustring to_utf8(char32_t cp);
+Pango::FontDescription glyph_font(FaStyle style);
+uint32_t pack_rgba(const Gdk::RGBA& c);
+
+// TileCache::class_id of the classes on `widget`'s toplevel (scheme,
+// palette, scale bucket), so windows in different schemes never share a
+// tile. Resolve on style-updated, not per draw.
+uint32_t style_id(Gtk::Widget& widget);
+
+// Font size `px` (points, as Pango::FontDescription::set_size takes it)
+// in pixels per em for `widget`'s screen resolution.
+double em_px(Gtk::Widget& widget, int px);
+
+// Icon box: the CSS background of `sc` (with whatever classes it currently
+// carries) plus the glyph centered in `fg`, from GlyphAtlas when it has the
+// glyph, else through Pango. Goes into TileCache.
+Cairo::RefPtr<Cairo::ImageSurface> render_icon(Gtk::Widget& widget,
+                                               const Glib::RefPtr<Gtk::StyleContext>& sc,
+                                               int w, int h, int dev, const Gdk::RGBA& fg,
+                                               char32_t codepoint, FaStyle style, int glyph_px);
+
+// Usage pill for a box `w` wide, red when over budget, rendered once per
+// text/budget/box size so steady-state draws only blit it.
+Cairo::RefPtr<Cairo::ImageSurface> render_badge(Gtk::Widget& widget, const std::string& text, bool over,
+                                                int w, int box_px, int dev);
+// Blits a render_badge() pill into the bottom-right corner of the box at (x, y).
+void draw_badge(const Cairo::RefPtr<Cairo::Context>& cr, const Cairo::RefPtr<Cairo::ImageSurface>& badge,
+                double x, double y, int w, int h);
+
+// A8 coverage of `layout` at `dev` pixels per unit; the layout origin sits
+// at (-ox, -oy) in the mask. Drawing it through cr->mask() does not go
+// through Pango, which allocates on every show_layout.
+Cairo::RefPtr<Cairo::ImageSurface> text_mask(const Glib::RefPtr<Pango::Layout>& layout, int dev,
+                                             int& ox, int& oy);
+
+} // namespace TileRender
@@ -0,0 +1,147 @@
+#include "Trace.h"
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+  #include <process.h>
+#else
+  #include <unistd.h>
+#endif
+
+namespace {
+
+struct Event {
+  const char* name;
+  char phase;      // 'X' complete, 'i' instant
+  int64_t ts_us;
+  int64_t dur_us;
+  int tid;
+};
+
+struct State {
+  std::mutex mu;
+  std::vector<Event> events;
+  std::unordered_map<std::thread::id, int> tids;
+  std::string path;
+  bool enabled = false;
+};
+
+State& state() {
+  static State* s = [] {
+    auto* st = new State();
+    if (const char* p = g_getenv("SV_DASHBOARD_TRACE"); p && *p) {
+      st->path = p;
+      st->enabled = true;
+      st->events.reserve(256);
+    }
+    return st;
+  }();
+  return *s;
+}
+
+// Must be called with the mutex held.
+int tid_locked(State& st) {
+  const auto id = std::this_thread::get_id();
+  auto it = st.tids.find(id);
+  if (it != st.tids.end()) return it->second;
+  const int tid = (int)st.tids.size() + 1;
+  st.tids.emplace(id, tid);
+  return tid;
+}
+
+int process_id() {
+#ifdef _WIN32
+  return _getpid();
+#else
+  return (int)getpid();
+#endif
+}
+
+void write_json_string(FILE* f, const char* s) {
+  std::fputc('"', f);
+  for (; *s; ++s) {
+    const unsigned char c = (unsigned char)*s;
+    if (c == '"' || c == '\\') { std::fputc('\\', f); std::fputc(c, f); }
+    else if (c < 0x20) std::fprintf(f, "\\u%04x", c);
+    else std::fputc(c, f);
+  }
+  std::fputc('"', f);
+}
+
+} // namespace
+
+namespace Trace {
+
+bool enabled() {
+  return state().enabled;
+}
+
+int64_t now_us() {
+  using namespace std::chrono;
+  static const auto t0 = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - t0).count();
+}
+
+void complete(const char* name, int64_t begin_us, int64_t end_us) {
+  auto& st = state();
+  if (!st.enabled) return;
+  std::lock_guard<std::mutex> lock(st.mu);
+  st.events.push_back({ name, 'X', begin_us, end_us - begin_us, tid_locked(st) });
+}
+
+void instant(const char* name) {
+  auto& st = state();
+  if (!st.enabled) return;
+  const int64_t ts = now_us();
+  std::lock_guard<std::mutex> lock(st.mu);
+  st.events.push_back({ name, 'i', ts, 0, tid_locked(st) });
+}
+
+void flush() {
+  auto& st = state();
+  if (!st.enabled) return;
+  std::lock_guard<std::mutex> lock(st.mu);
+
+  FILE* f = g_fopen(st.path.c_str(), "wb");
+  if (!f) {
+    g_warning("Trace: cannot write %s", st.path.c_str());
+    return;
+  }
+
+  const int pid = process_id();
+  std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  bool first = true;
+  for (const auto& [id, tid] : st.tids) {
+    (void)id;
+    std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                    "\"args\":{\"name\":\"%s\"}}",
+                 first ? "" : ",\n", pid, tid, tid == 1 ? "main" : "worker");
+    first = false;
+  }
+
+  for (const auto& e : st.events) {
+    std::fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+    write_json_string(f, e.name);
+    std::fprintf(f, ",\"cat\":\"sv\",\"ph\":\"%c\",\"ts\":%lld,", e.phase, (long long)e.ts_us);
+    if (e.phase == 'X') std::fprintf(f, "\"dur\":%lld,", (long long)e.dur_us);
+    else                std::fprintf(f, "\"s\":\"p\",");
+    std::fprintf(f, "\"pid\":%d,\"tid\":%d}", pid, e.tid);
+    first = false;
+  }
+
+  std::fprintf(f, "\n]}\n");
+  std::fclose(f);
+  st.events.clear();
+}
+
+} // namespace Trace
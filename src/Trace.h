@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+// Opt-in startup/frame tracing in Chrome trace-event format (loads in
+// chrome://tracing and ui.perfetto.dev). Enabled at runtime with
+//   SV_DASHBOARD_TRACE=/path/to/trace.json
+// and written by Trace::flush() on exit. Build with -Dtracing=false and
+// the SV_TRACE_* markers compile to nothing.
+namespace Trace {
+
+bool enabled();
+int64_t now_us();
+
+void complete(const char* name, int64_t begin_us, int64_t end_us);
+void instant(const char* name);
+void flush();
+
+class Scope {
+public:
+  explicit Scope(const char* name, bool active = true)
+  : name_((active && enabled()) ? name : nullptr),
+    begin_us_(name_ ? now_us() : 0) {}
+
+  ~Scope() {
+    if (name_) complete(name_, begin_us_, now_us());
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* name_;
+  int64_t begin_us_;
+};
+
+} // namespace Trace
+
+#if SV_DASHBOARD_TRACING
+  #define SV_TRACE_CAT2(a, b) a##b
+  #define SV_TRACE_CAT(a, b)  SV_TRACE_CAT2(a, b)
+  #define SV_TRACE_SCOPE(name) ::Trace::Scope SV_TRACE_CAT(sv_trace_, __LINE__)(name)
+  #define SV_TRACE_SCOPE_IF(cond, name) ::Trace::Scope SV_TRACE_CAT(sv_trace_, __LINE__)(name, (cond))
+  #define SV_TRACE_INSTANT(name) ::Trace::instant(name)
+#else
+  #define SV_TRACE_SCOPE(name) ((void)0)
+  #define SV_TRACE_SCOPE_IF(cond, name) ((void)0)
+  #define SV_TRACE_INSTANT(name) ((void)0)
+#endif
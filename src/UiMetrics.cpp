@@ -0,0 +1,96 @@
+#include "UiMetrics.h"
+#include "FontRegistry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// MainWindow
+constexpr int kRootSpacingBase   = 8;
+constexpr int kNavPadBase        = 14;
+constexpr int kNavPxBase         = 48;
+constexpr int kSchemePxBase      = 34;
+constexpr int kSchemeSpacingBase = 8;
+constexpr int kSchemeMarginStart = 14;
+constexpr int kSchemeMarginBot   = 12;
+
+// Desktop
+constexpr int kMarginBase     = 40;
+constexpr int kRowSpacingBase = 30;
+constexpr int kColSpacingBase = 55;
+
+// DesktopIcon: under-icon label, spacing and square tile (scale=1)
+constexpr int kLabelPxBase  = 20;
+constexpr int kSpacingBase  = 10;
+constexpr int kIconBoxBase  = 120;
+
+int scaled(int base, double s, int min) {
+  return std::max(min, (int)std::lround(base * s));
+}
+
+UiMetrics compute(int bucket) {
+  UiMetrics m;
+  m.bucket = bucket;
+  m.scale = UiScale::kMinScale + bucket * UiScale::kStep;
+  const double s = m.scale;
+
+  m.root_spacing = scaled(kRootSpacingBase, s, 0);
+  m.nav_pad = scaled(kNavPadBase, s, 0);
+  m.nav_px = scaled(kNavPxBase, s, 10);
+  m.scheme_px = scaled(kSchemePxBase, s, 6);
+  m.scheme_spacing = scaled(kSchemeSpacingBase, s, 0);
+  m.scheme_margin_start = scaled(kSchemeMarginStart, s, 2);
+  m.scheme_margin_bottom = scaled(kSchemeMarginBot, s, 2);
+
+  m.page_margin = scaled(kMarginBase, s, 2);
+  m.row_spacing = scaled(kRowSpacingBase, s, 0);
+  m.col_spacing = scaled(kColSpacingBase, s, 0);
+
+  m.tile_spacing = scaled(kSpacingBase, s, 1);
+  m.icon_box_px = scaled(kIconBoxBase, s, 12);
+  m.label_px = scaled(kLabelPxBase, s, 6);
+
+  m.label_font.set_family(FontRegistry::labelFamily());
+  m.label_font.set_size(m.label_px * Pango::SCALE);
+  return m;
+}
+
+const std::vector<UiMetrics>& table() {
+  static const std::vector<UiMetrics> t = [] {
+    std::vector<UiMetrics> v;
+    v.reserve(UiScale::bucket_count());
+    for (int i = 0; i < UiScale::bucket_count(); ++i) v.push_back(compute(i));
+    return v;
+  }();
+  return t;
+}
+
+} // namespace
+
+namespace UiScale {
+
+int bucket_count() {
+  return (int)std::lround((kMaxScale - kMinScale) / kStep) + 1;
+}
+
+int bucket_for(double scale) {
+  const double s = std::clamp(scale, kMinScale, kMaxScale);
+  return std::clamp((int)std::lround((s - kMinScale) / kStep), 0, bucket_count() - 1);
+}
+
+const UiMetrics& metrics(int bucket) {
+  return table().at(std::clamp(bucket, 0, bucket_count() - 1));
+}
+
+const UiMetrics& metrics_for(double scale) {
+  return metrics(bucket_for(scale));
+}
+
+} // namespace UiScale
+
+ResizeStats& resize_stats() {
+  static ResizeStats stats;
+  return stats;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <pangomm/fontdescription.h>
+
+#include <cstdint>
+
+// Every scale-dependent size in the UI, precomputed for a fixed table of
+// scale buckets. Resizing snaps to a bucket, so widgets only see a change
+// (and only invalidate) when the bucket actually changes.
+struct UiMetrics {
+  int    bucket = 0;
+  double scale  = 1.0;
+
+  // MainWindow chrome
+  int root_spacing = 0;
+  int nav_pad = 0;
+  int nav_px = 0;
+  int scheme_px = 0;
+  int scheme_spacing = 0;
+  int scheme_margin_start = 0;
+  int scheme_margin_bottom = 0;
+
+  // Desktop grid
+  int page_margin = 0;
+  int row_spacing = 0;
+  int col_spacing = 0;
+
+  // DesktopIcon
+  int tile_spacing = 0;
+  int icon_box_px = 0;
+  int label_px = 0;
+
+  Pango::FontDescription label_font;   // FontRegistry::labelFamily() at label_px
+};
+
+namespace UiScale {
+
+inline constexpr double kMinScale = 0.06;
+inline constexpr double kMaxScale = 1.0;
+inline constexpr double kStep     = 0.01;
+
+int bucket_for(double scale);
+int bucket_count();
+const UiMetrics& metrics(int bucket);
+const UiMetrics& metrics_for(double scale);
+
+} // namespace UiScale
+
+// Cheap counters for the resize pipeline (see MainWindow::on_resize_tick).
+struct ResizeStats {
+  uint64_t relayouts = 0;      // overlay size-allocate passes
+  uint64_t resize_frames = 0;  // frame-clock ticks that processed a resize
+  uint64_t bucket_changes = 0; // ticks that actually changed the scale bucket
+};
+
+ResizeStats& resize_stats();
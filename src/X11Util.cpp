@@ -0,0 +1,158 @@
+#include "X11Util.h"
+#include "Trace.h"
+
+#include <gdk/gdk.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#ifdef SV_HAVE_X11
+#include <gdk/gdkx.h>
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#endif
+
+#ifdef SV_HAVE_X11
+
+namespace {
+
+// One 32-bit-format property; `count` items. Caller XFree()s the result.
+unsigned char* get_property(Display* dpy, Window w, Atom prop, Atom type, unsigned long& count) {
+  Atom actual = None;
+  int format = 0;
+  unsigned long after = 0;
+  unsigned char* data = nullptr;
+  count = 0;
+  if (XGetWindowProperty(dpy, w, prop, 0, 4096, False, type, &actual, &format,
+                         &count, &after, &data) != Success || actual != type || format != 32) {
+    if (data) XFree(data);
+    count = 0;
+    return nullptr;
+  }
+  return data;
+}
+
+// Caller must hold an X error trap.
+std::vector<ClientWindow> list_clients(GdkDisplay* gd) {
+  Display* dpy = GDK_DISPLAY_XDISPLAY(gd);
+  const Atom client_list = gdk_x11_get_xatom_by_name_for_display(gd, "_NET_CLIENT_LIST");
+  const Atom wm_pid = gdk_x11_get_xatom_by_name_for_display(gd, "_NET_WM_PID");
+
+  std::vector<ClientWindow> out;
+  unsigned long n = 0;
+  if (auto* data = get_property(dpy, DefaultRootWindow(dpy), client_list, XA_WINDOW, n)) {
+    const auto* windows = reinterpret_cast<const unsigned long*>(data);
+    out.reserve(n);
+    for (unsigned long i = 0; i < n; ++i) {
+      ClientWindow cw;
+      cw.xid = windows[i];
+      unsigned long m = 0;
+      if (auto* pid = get_property(dpy, windows[i], wm_pid, XA_CARDINAL, m)) {
+        if (m == 1) cw.pid = (pid_t)*reinterpret_cast<const unsigned long*>(pid);
+        XFree(pid);
+      }
+      out.push_back(cw);
+    }
+    XFree(data);
+  }
+  return out;
+}
+
+GdkDisplay* x11_display() {
+  GdkDisplay* gd = gdk_display_get_default();
+  return (gd && GDK_IS_X11_DISPLAY(gd)) ? gd : nullptr;
+}
+
+std::function<void()>& client_list_cb() {
+  static std::function<void()> cb;
+  return cb;
+}
+
+GdkFilterReturn on_root_event(GdkXEvent* xevent, GdkEvent*, gpointer data) {
+  const auto* xe = static_cast<XEvent*>(xevent);
+  const Atom client_list = (Atom)(uintptr_t)data;
+  if (xe->type == PropertyNotify && xe->xproperty.atom == client_list && client_list_cb()) {
+    client_list_cb()();
+  }
+  return GDK_FILTER_CONTINUE;
+}
+
+} // namespace
+
+std::vector<ClientWindow> client_windows() {
+  GdkDisplay* gd = x11_display();
+  if (!gd) return {};
+
+  // Clients may unmap between listing and querying them.
+  gdk_x11_display_error_trap_push(gd);
+  auto out = list_clients(gd);
+  gdk_x11_display_error_trap_pop_ignored(gd);
+  return out;
+}
+
+bool watch_client_list(std::function<void()> cb) {
+  GdkDisplay* gd = x11_display();
+  if (!gd) return false;
+
+  const bool first = !client_list_cb();
+  client_list_cb() = std::move(cb);
+  if (!first) return true;
+
+  GdkWindow* root = gdk_get_default_root_window();
+  gdk_window_set_events(root, (GdkEventMask)(gdk_window_get_events(root) | GDK_PROPERTY_CHANGE_MASK));
+  const Atom client_list = gdk_x11_get_xatom_by_name_for_display(gd, "_NET_CLIENT_LIST");
+  gdk_window_add_filter(root, &on_root_event, (gpointer)(uintptr_t)client_list);
+  return true;
+}
+
+bool raise_window_for_pids(const std::vector<pid_t>& pids) {
+  SV_TRACE_SCOPE("raise_window_for_pids");
+  if (pids.empty()) return false;
+
+  GdkDisplay* gd = x11_display();
+  if (!gd) return false;
+
+  Display* dpy = GDK_DISPLAY_XDISPLAY(gd);
+  const Atom active = gdk_x11_get_xatom_by_name_for_display(gd, "_NET_ACTIVE_WINDOW");
+
+  gdk_x11_display_error_trap_push(gd);
+
+  // Mapping order: newest match wins.
+  Window target = None;
+  for (const auto& cw : list_clients(gd)) {
+    if (cw.pid && std::find(pids.begin(), pids.end(), cw.pid) != pids.end()) target = cw.xid;
+  }
+
+  if (target != None) {
+    XEvent ev{};
+    ev.xclient.type = ClientMessage;
+    ev.xclient.window = target;
+    ev.xclient.message_type = active;
+    ev.xclient.format = 32;
+    ev.xclient.data.l[0] = 2;  // source: pager (explicit user request)
+    ev.xclient.data.l[1] = (long)gdk_x11_display_get_user_time(gd);
+    ev.xclient.data.l[2] = 0;
+    XSendEvent(dpy, DefaultRootWindow(dpy), False, SubstructureRedirectMask | SubstructureNotifyMask, &ev);
+    XFlush(dpy);
+  }
+
+  gdk_x11_display_error_trap_pop_ignored(gd);
+  return target != None;
+}
+
+#else
+
+bool raise_window_for_pids(const std::vector<pid_t>&) {
+  return false;
+}
+
+std::vector<ClientWindow> client_windows() {
+  return {};
+}
+
+bool watch_client_list(std::function<void()>) {
+  return false;
+}
+
+#endif
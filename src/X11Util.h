@@ -0,0 +1,26 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <functional>
+#include <vector>
+
+// EWMH helpers. All return empty/false when not running on X11.
+
+// Activates (raises, focuses, de-iconifies) the most recently mapped
+// top-level window owned by one of `pids`, via _NET_CLIENT_LIST,
+// _NET_WM_PID and an EWMH _NET_ACTIVE_WINDOW request to the window manager.
+// Returns false when no such window exists yet or when not on X11.
+bool raise_window_for_pids(const std::vector<pid_t>& pids);
+
+struct ClientWindow {
+  unsigned long xid = 0;
+  pid_t pid = 0;  // 0 if the client doesn't set _NET_WM_PID
+};
+
+// Managed top-level windows in mapping order (oldest first).
+std::vector<ClientWindow> client_windows();
+
+// Calls `cb` on the main loop whenever the window manager updates
+// _NET_CLIENT_LIST (a client window was mapped or withdrawn).
+bool watch_client_list(std::function<void()> cb);
@@ -1,9 +1,39 @@
-#include "MainApp.h"
 #include "FontRegistry.h"
+#include "Icons.h"
+#include "LaunchLatency.h"
+#include "LaunchStats.h"
+#include "MainApp.h"
 #include "RuntimeEnv.h"
+#include "StatusFeed.h"
+#include "Trace.h"
 
 #include <glib.h>
-#include <iostream>
+
+#include <cstdio>
+#include <cstring>
+
+// Install-time warm-up: the private fontconfig cache and the parsed config
+// snapshot, so the first start finds both.
+static int prime_caches() {
+  RuntimeEnv::setup();
+  FontRegistry fonts;
+  const bool ok = fonts.prime();
+  const IconConfig config = load_icon_config();  // writes the snapshot
+  std::size_t tiles = 0;
+  for (const auto& page : config.pages) tiles += page.size();
+  std::printf("config: %s (%zu tiles)\n", icon_config_path().c_str(), tiles);
+  return ok ? 0 : 1;
+}
+
+// --set-status TILE TEXT [alarm]: one-shot StatusFeed publisher for scripts;
+// TILE is the tile key (its "name", else its title).
+// An empty TEXT (without "alarm") clears the tile's badge.
+static int set_status(const char* tile, const char* text, bool alarm) {
+  const auto state = alarm ? StatusFeed::Alarm : (*text ? StatusFeed::Normal : StatusFeed::Clear);
+  if (StatusFeed::publish(StatusFeed::default_path(), tile, text, state)) return 0;
+  std::fprintf(stderr, "cannot publish status for \"%s\" to %s\n", tile, StatusFeed::default_path().c_str());
+  return 1;
+}
 
 int main(int argc, char** argv) {
 #ifdef _WIN32
@@ -24,13 +54,27 @@ int main(int argc, char** argv) {
   }
 #endif
 
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--dump-launch-latency") == 0) {
+      std::fputs(LaunchLatency::instance().to_json().c_str(), stdout);
+      return 0;
+    }
+    if (std::strcmp(argv[i], "--prime-caches") == 0) return prime_caches();
+    if (std::strcmp(argv[i], "--set-status") == 0 && i + 2 < argc) {
+      return set_status(argv[i + 1], argv[i + 2], i + 3 < argc && std::strcmp(argv[i + 3], "alarm") == 0);
+    }
+  }
+
   RuntimeEnv::setup(); // MUST run before Gtk::Application::create() / any Pango usage
 
-  FontRegistry reg;
-  if (!reg.registerBundledFonts()) {
-    std::cerr << "Warning: FA fonts not registered; icons may fall back.\n";
+  int rc = 0;
+  {
+    auto app = MainApp::create();
+    rc = app->run(argc, argv);
   }
 
-  auto app = MainApp::create();
-  return app->run(argc, argv);
+  LaunchStats::instance().flush();
+  LaunchLatency::instance().flush();
+  Trace::flush();
+  return rc;
 }
@@ -0,0 +1,275 @@
+// Build-time glyph atlas generator.
+//
+//   sv-atlas-gen --font-dir DIR --output FILE [--config icons.json]...
+//                [--em PX] [--spread PX]
+//
+// Collects the glyphs of the built-in layout, of each --config file, and of
+// the MainWindow chrome (nav chevrons, scheme sun/cloud-sun/moon, the
+// unknown-icon fallback), renders them from the Font Awesome TTFs with
+// FreeType and writes a signed-distance-field atlas in GlyphAtlasFormat.
+// Glyphs a font does not have are left out; the app draws those through
+// Pango as before.
+
+#include "GlyphAtlas.h"
+#include "Icons.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int kAtlasWidth = 1024;
+constexpr double kInf = 1e20;
+
+struct Options {
+  std::string font_dir;
+  std::string output;
+  std::vector<std::string> configs;
+  int em = 96;
+  int spread = 8;
+};
+
+struct Rendered {
+  GlyphAtlasFormat::Glyph glyph{};
+  std::vector<uint8_t> sdf;  // glyph.w * glyph.h
+};
+
+const char* font_file(FaStyle style) {
+  switch (style) {
+    case FaStyle::Regular: return "fa-regular-400.ttf";
+    case FaStyle::Brands:  return "fa-brands-400.ttf";
+    case FaStyle::Solid:   break;
+  }
+  return "fa-solid-900.ttf";
+}
+
+// Felzenszwalb & Huttenlocher squared Euclidean distance transform, 1D pass
+// over n samples spaced `step` apart.
+void edt_1d(double* g, int n, int step, std::vector<double>& f, std::vector<double>& z,
+            std::vector<int>& v) {
+  for (int i = 0; i < n; ++i) f[i] = g[i * step];
+  int k = 0;
+  v[0] = 0;
+  z[0] = -kInf;
+  z[1] = kInf;
+  auto meet = [&f](int q, int r) { return ((f[q] + q * q) - (f[r] + r * r)) / (2.0 * (q - r)); };
+  for (int q = 1; q < n; ++q) {
+    double s = meet(q, v[k]);
+    while (s <= z[k]) s = meet(q, v[--k]);  // z[0] = -inf stops this
+    ++k;
+    v[k] = q;
+    z[k] = s;
+    z[k + 1] = kInf;
+  }
+  k = 0;
+  for (int q = 0; q < n; ++q) {
+    while (z[k + 1] < q) ++k;
+    const int r = v[k];
+    g[q * step] = (q - r) * (q - r) + f[r];
+  }
+}
+
+void edt_2d(std::vector<double>& grid, int w, int h) {
+  const int n = std::max(w, h);
+  std::vector<double> f(n), z(n + 1);
+  std::vector<int> v(n);
+  for (int x = 0; x < w; ++x) edt_1d(grid.data() + x, h, w, f, z, v);
+  for (int y = 0; y < h; ++y) edt_1d(grid.data() + (size_t)y * w, w, 1, f, z, v);
+}
+
+// Coverage (0..1, padded) -> SDF bytes, 128 on the edge, larger inside.
+std::vector<uint8_t> to_sdf(const std::vector<double>& alpha, int w, int h, int spread) {
+  std::vector<double> outer(alpha.size()), inner(alpha.size());
+  for (size_t i = 0; i < alpha.size(); ++i) {
+    const double a = alpha[i];
+    if (a >= 1.0) {
+      outer[i] = 0.0;
+      inner[i] = kInf;
+    } else if (a <= 0.0) {
+      outer[i] = kInf;
+      inner[i] = 0.0;
+    } else {
+      // Anti-aliased edge pixel: sub-pixel distance from its coverage.
+      const double d = 0.5 - a;
+      outer[i] = d > 0.0 ? d * d : 0.0;
+      inner[i] = d < 0.0 ? d * d : 0.0;
+    }
+  }
+  edt_2d(outer, w, h);
+  edt_2d(inner, w, h);
+
+  std::vector<uint8_t> out(alpha.size());
+  for (size_t i = 0; i < alpha.size(); ++i) {
+    const double d = std::sqrt(inner[i]) - std::sqrt(outer[i]);  // positive inside
+    out[i] = (uint8_t)std::clamp(std::lround(128.0 + d * 127.0 / spread), 0L, 255L);
+  }
+  return out;
+}
+
+bool render(FT_Face face, char32_t cp, FaStyle style, const Options& o, Rendered& r) {
+  const FT_UInt index = FT_Get_Char_Index(face, cp);
+  if (!index) return false;
+  if (FT_Load_Glyph(face, index, FT_LOAD_NO_HINTING | FT_LOAD_RENDER)) return false;
+
+  const FT_GlyphSlot slot = face->glyph;
+  const FT_Bitmap& bm = slot->bitmap;
+  if (bm.pixel_mode != FT_PIXEL_MODE_GRAY && bm.rows > 0) return false;
+
+  const int bw = (int)bm.width, bh = (int)bm.rows;
+  const int w = bw + 2 * o.spread, h = bh + 2 * o.spread;
+  std::vector<double> alpha((size_t)w * h, 0.0);
+  for (int y = 0; y < bh; ++y) {
+    const unsigned char* src = bm.buffer + (ptrdiff_t)y * bm.pitch;
+    for (int x = 0; x < bw; ++x) alpha[(size_t)(y + o.spread) * w + x + o.spread] = src[x] / 255.0;
+  }
+
+  auto& g = r.glyph;
+  g.codepoint = (uint32_t)cp;
+  g.style = (uint8_t)style;
+  g.w = (uint16_t)w;
+  g.h = (uint16_t)h;
+  g.advance = (float)(slot->linearHoriAdvance / 65536.0 / o.em);
+  g.bearing_x = (float)((double)slot->bitmap_left / o.em);
+  g.bearing_y = (float)((double)slot->bitmap_top / o.em);
+  r.sdf = to_sdf(alpha, w, h, o.spread);
+  return true;
+}
+
+// Shelf packing, tallest first.
+int pack(std::vector<Rendered>& glyphs) {
+  std::vector<Rendered*> order;
+  for (auto& r : glyphs) order.push_back(&r);
+  std::sort(order.begin(), order.end(), [](const Rendered* a, const Rendered* b) {
+    return a->glyph.h > b->glyph.h;
+  });
+
+  int x = 0, y = 0, shelf = 0;
+  for (Rendered* r : order) {
+    if (x + r->glyph.w > kAtlasWidth) {
+      x = 0;
+      y += shelf;
+      shelf = 0;
+    }
+    r->glyph.x = (uint16_t)x;
+    r->glyph.y = (uint16_t)y;
+    x += r->glyph.w;
+    shelf = std::max<int>(shelf, r->glyph.h);
+  }
+  return y + shelf;
+}
+
+bool parse_args(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (a == "--font-dir" && has_value) o.font_dir = argv[++i];
+    else if (a == "--output" && has_value) o.output = argv[++i];
+    else if (a == "--config" && has_value) o.configs.push_back(argv[++i]);
+    else if (a == "--em" && has_value) o.em = std::atoi(argv[++i]);
+    else if (a == "--spread" && has_value) o.spread = std::atoi(argv[++i]);
+    else return false;
+  }
+  return !o.font_dir.empty() && !o.output.empty() && o.em >= 8 && o.spread >= 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  if (!parse_args(argc, argv, o)) {
+    std::fprintf(stderr, "usage: %s --font-dir DIR --output FILE [--config FILE]... "
+                         "[--em PX] [--spread PX]\n", argv[0]);
+    return 2;
+  }
+
+  std::set<std::pair<char32_t, FaStyle>> wanted;
+  for (char32_t cp : { CHEV_LEFT, CHEV_RIGHT, SCHEME_DAY, SCHEME_DUSK, SCHEME_NIGHT, GLYPH_UNKNOWN }) {
+    wanted.insert({ cp, FaStyle::Solid });
+  }
+  auto collect = [&wanted](const IconConfig& cfg) {
+    for (const auto& page : cfg.pages) {
+      for (const auto& spec : page) wanted.insert({ spec.codepoint, spec.style });
+    }
+  };
+  collect(default_icon_config());
+  for (const auto& path : o.configs) collect(load_icon_config_from_file(path));
+
+  FT_Library ft = nullptr;
+  if (FT_Init_FreeType(&ft)) {
+    std::fprintf(stderr, "sv-atlas-gen: FreeType init failed\n");
+    return 1;
+  }
+
+  GlyphAtlasFormat::Header header{};
+  std::memcpy(header.magic, GlyphAtlasFormat::kMagic, sizeof(header.magic));
+  header.version = GlyphAtlasFormat::kVersion;
+  header.em_px = (uint32_t)o.em;
+  header.spread = (uint32_t)o.spread;
+
+  std::vector<Rendered> glyphs;
+  for (FaStyle style : { FaStyle::Solid, FaStyle::Regular, FaStyle::Brands }) {
+    const std::string path = o.font_dir + "/" + font_file(style);
+    FT_Face face = nullptr;
+    if (FT_New_Face(ft, path.c_str(), 0, &face)) {
+      std::fprintf(stderr, "sv-atlas-gen: skipping %s (cannot open)\n", path.c_str());
+      continue;
+    }
+    FT_Set_Pixel_Sizes(face, 0, (FT_UInt)o.em);
+    const int s = (int)style;
+    header.ascender[s] = (float)((double)face->ascender / face->units_per_EM);
+    header.descender[s] = (float)((double)face->descender / face->units_per_EM);
+
+    for (const auto& [cp, st] : wanted) {
+      if (st != style) continue;
+      Rendered r;
+      if (render(face, cp, style, o, r)) glyphs.push_back(std::move(r));
+      else std::fprintf(stderr, "sv-atlas-gen: U+%04X not in %s\n", (unsigned)cp, font_file(style));
+    }
+    FT_Done_Face(face);
+  }
+  FT_Done_FreeType(ft);
+
+  const int height = pack(glyphs);
+  std::vector<uint8_t> pixels((size_t)kAtlasWidth * height, 0);
+  for (const auto& r : glyphs) {
+    for (int y = 0; y < r.glyph.h; ++y) {
+      std::memcpy(&pixels[(size_t)(r.glyph.y + y) * kAtlasWidth + r.glyph.x],
+                  &r.sdf[(size_t)y * r.glyph.w], r.glyph.w);
+    }
+  }
+
+  std::sort(glyphs.begin(), glyphs.end(), [](const Rendered& a, const Rendered& b) {
+    return a.glyph.codepoint != b.glyph.codepoint ? a.glyph.codepoint < b.glyph.codepoint
+                                                  : a.glyph.style < b.glyph.style;
+  });
+  header.width = kAtlasWidth;
+  header.height = (uint32_t)height;
+  header.count = (uint32_t)glyphs.size();
+
+  FILE* f = std::fopen(o.output.c_str(), "wb");
+  if (!f) {
+    std::fprintf(stderr, "sv-atlas-gen: cannot write %s\n", o.output.c_str());
+    return 1;
+  }
+  bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+  for (const auto& r : glyphs) ok = ok && std::fwrite(&r.glyph, sizeof(r.glyph), 1, f) == 1;
+  ok = ok && (pixels.empty() || std::fwrite(pixels.data(), pixels.size(), 1, f) == 1);
+  ok = std::fclose(f) == 0 && ok;
+  if (!ok) {
+    std::fprintf(stderr, "sv-atlas-gen: write to %s failed\n", o.output.c_str());
+    std::remove(o.output.c_str());
+    return 1;
+  }
+  std::printf("sv-atlas-gen: %zu glyphs, %dx%d\n", glyphs.size(), kAtlasWidth, height);
+  return 0;
+}